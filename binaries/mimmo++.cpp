@@ -64,6 +64,8 @@ struct InfoMimmoPP{
     Verbose vlog;               /**< type of log file verbosity */
     bool optres;                /**< boolean to activate writing of execution optional results */
     bool expert;                /**< boolean to override mandatory ports checking */
+    bool parallel;              /**< boolean to activate parallel execution of independent blocks */
+    bool profile;               /**< boolean to activate profiling of blocks execution */
     std::string optres_path;    /**< path to store optional results */
 
     /*! Base constructor*/
@@ -74,6 +76,8 @@ struct InfoMimmoPP{
         optres      = false;
         optres_path = ".";
         expert      = false;
+        parallel    = false;
+        profile     = false;
     }
     /*! Destructor */
     ~InfoMimmoPP(){};
@@ -91,6 +95,8 @@ struct InfoMimmoPP{
         optres = other.optres;
         optres_path = other.optres_path;
         expert = other.expert;
+        parallel = other.parallel;
+        profile = other.profile;
         return *this;
     }
 };
@@ -150,6 +156,16 @@ InfoMimmoPP readArguments(std::vector<std::string> & sanitized_args ){
         std::cout<<" "<<std::endl;
         std::cout<<"    --expert,-e=yes                                 : override mandatory ports connection checking.              "<<std::endl;
         std::cout<<" "<<std::endl;
+        std::cout<<"    --parallel,-p=yes                               : execute concurrently the independent blocks of each chain   "<<std::endl;
+        std::cout<<"                                                    (OpenMP builds only). Default is serial execution.          "<<std::endl;
+        std::cout<<"                                                    Blocks running concurrently use one thread each for their   "<<std::endl;
+        std::cout<<"                                                    inner loops: use it for chains with independent branches    "<<std::endl;
+        std::cout<<"                                                    of comparable cost.                                          "<<std::endl;
+        std::cout<<" "<<std::endl;
+        std::cout<<"    --profile,-pr=yes                               : record time and memory usage of each block execution.      "<<std::endl;
+        std::cout<<"                                                    JSON/CSV reports and a Chrome trace for each chain are       "<<std::endl;
+        std::cout<<"                                                    written in the optional results directory.                 "<<std::endl;
+        std::cout<<" "<<std::endl;
         std::cout<<" "<<std::endl;
         std::cout<<" "<<std::endl;
         std::cout<<"    For any problem, bug and malfunction please contact mimmo developers.                       "<<std::endl;
@@ -158,13 +174,15 @@ InfoMimmoPP readArguments(std::vector<std::string> & sanitized_args ){
     }
 
     std::unordered_map<int, std::string> keymap;
-    int nkeys = 6;
+    int nkeys = 8;
     keymap[0] = "--dictionary=";
     keymap[1] = "--log-verbosity=";
     keymap[2] = "--console-verbosity=";
     keymap[3] = "--optional-results=";
     keymap[4] = "--optional-results-path=";
     keymap[5] = "--expert=";
+    keymap[6] = "--parallel=";
+    keymap[7] = "--profile=";
 
     keymap[nkeys] = "-d=";
     keymap[nkeys+1] = "-lv=";
@@ -172,6 +190,8 @@ InfoMimmoPP readArguments(std::vector<std::string> & sanitized_args ){
     keymap[nkeys+3] = "-or=";
     keymap[nkeys+4] = "-orp=";
     keymap[nkeys+5] = "-e=";
+    keymap[nkeys+6] = "-p=";
+    keymap[nkeys+7] = "-pr=";
 
     keymap[2*nkeys] = "dict=";
     keymap[2*nkeys+1] = "vlog=";
@@ -179,6 +199,8 @@ InfoMimmoPP readArguments(std::vector<std::string> & sanitized_args ){
     keymap[2*nkeys+3] = "opt-res=";
     keymap[2*nkeys+4] = "opt-res-path=";
     keymap[2*nkeys+5] = "expert=";
+    keymap[2*nkeys+6] = "parallel=";
+    keymap[2*nkeys+7] = "profile=";
 
     std::map<int, std::string> final_map;
     //visit input list and search for each key string  in key map. If an input string positively match a key,
@@ -208,6 +230,8 @@ InfoMimmoPP readArguments(std::vector<std::string> & sanitized_args ){
     if(final_map.count(4)) result.optres_path = final_map[4];
     if(final_map.count(3)) result.optres = (final_map[3]=="yes");
     if(final_map.count(5)) result.expert = (final_map[5]=="yes");
+    if(final_map.count(6)) result.parallel = (final_map[6]=="yes");
+    if(final_map.count(7)) result.profile = (final_map[7]=="yes");
 
     if(final_map.count(1)){
         int check = -1 + int(final_map[1]=="quiet") + 2*int(final_map[1]=="normal") + 3*int(final_map[1]=="full");
@@ -355,6 +379,8 @@ void mimmocore(const InfoMimmoPP & info) {
             (*mimmo_log)<< "debug results:      "<<yesno[int(info.optres)]<<std::endl;
             (*mimmo_log)<< "debug results path: "<<info.optres_path<<std::endl;
             (*mimmo_log)<< "expert mode:        "<<yesno[int(info.expert)]<<std::endl;
+            (*mimmo_log)<< "parallel execution: "<<yesno[int(info.parallel)]<<std::endl;
+            (*mimmo_log)<< "profiling:          "<<yesno[int(info.profile)]<<std::endl;
             (*mimmo_log)<< " "<<std::endl;
             (*mimmo_log)<< " "<<std::endl;
         }
@@ -395,6 +421,9 @@ void mimmocore(const InfoMimmoPP & info) {
                 mimmo_log->setPriority(bitpit::log::DEBUG);
                 val.second.setPlotDebugResults(info.optres);
                 val.second.setOutputDebugResults(info.optres_path);
+                val.second.setParallelExecution(info.parallel);
+                val.second.setProfiling(info.profile);
+                val.second.setProfilingOutput(info.optres_path);
 				val.second.exec(true);
 			}
 		}
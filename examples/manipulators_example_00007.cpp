@@ -0,0 +1,148 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_manipulators.hpp"
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+// =================================================================================== //
+/*!
+	\example manipulators_example_00007.cpp
+
+	\brief Benchmark of the far-field approximated evaluation of MRBF with global kernels.
+
+	A random cloud of target points is deformed by a random set of RBF nodes with a
+	gaussian (global) kernel. The exact evaluation is used as reference and the accuracy/speed
+	trade-off of the far-field approximation is reported for decreasing tolerances.
+
+	Manipulation block used: MRBF.
+
+	<b>To run</b>: ./manipulators_example_00007 [number of target points] [number of RBF nodes] \n
+
+	<b> visit</b>: <a href="http://optimad.github.io/mimmo/">mimmo website</a> \n
+ */
+
+void test00007(long npoints, int nnodes) {
+
+    /* Creation of a random point cloud of target points in the unit cube,
+     * and of random RBF nodes and displacements. Fixed seed for reproducibility.
+     */
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> coord(0.0, 1.0);
+    std::uniform_real_distribution<double> displ(-0.01, 0.01);
+
+    mimmo::MimmoObject * cloud = new mimmo::MimmoObject(3);
+    for(long i=0; i<npoints; ++i){
+        cloud->addVertex({{coord(generator), coord(generator), coord(generator)}}, i);
+    }
+
+    dvecarr3E rbfnodes(nnodes), rbfdispls(nnodes);
+    for(int i=0; i<nnodes; ++i){
+        rbfnodes[i] = {{coord(generator), coord(generator), coord(generator)}};
+        rbfdispls[i] = {{displ(generator), displ(generator), displ(generator)}};
+    }
+
+    /* MRBF block in direct parameterization mode with gaussian kernel.
+     */
+    mimmo::MRBF * mrbf = new mimmo::MRBF();
+    mrbf->setGeometry(cloud);
+    mrbf->setMode(mimmo::MRBFSol::NONE);
+    mrbf->setFunction(bitpit::RBFBasisFunction::GAUSS95);
+    mrbf->setSupportRadiusValue(0.5);
+    mrbf->setNode(rbfnodes);
+    mrbf->setDisplacements(rbfdispls);
+
+    /* Exact evaluation as reference.
+     */
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    mrbf->exec();
+    end = std::chrono::system_clock::now();
+    double exactTime = std::chrono::duration<double>(end - start).count();
+    dmpvecarr3E reference = *(mrbf->getDisplacements());
+
+    double maxDispl = 0.0;
+    for(const auto & val : reference){
+        maxDispl = std::max(maxDispl, norm2(val));
+    }
+
+    std::cout << " target points : " << npoints << " - RBF nodes : " << nnodes << std::endl;
+    std::cout << std::setw(14) << "tolerance" << std::setw(14) << "time [s]" << std::setw(14) << "speedup"
+              << std::setw(14) << "max error" << std::setw(14) << "rel. error" << std::endl;
+    std::cout << std::setw(14) << "exact" << std::setw(14) << exactTime << std::setw(14) << 1.0
+              << std::setw(14) << 0.0 << std::setw(14) << 0.0 << std::endl;
+
+    /* Far-field approximated evaluation with decreasing tolerances.
+     */
+    dvector1D tolerances = {{1.0E-2, 1.0E-3, 1.0E-4, 1.0E-5, 1.0E-6}};
+    for(double tol : tolerances){
+        mrbf->setFarFieldTolerance(tol);
+        start = std::chrono::system_clock::now();
+        mrbf->exec();
+        end = std::chrono::system_clock::now();
+        double time = std::chrono::duration<double>(end - start).count();
+
+        double maxError = 0.0;
+        dmpvecarr3E * approx = mrbf->getDisplacements();
+        for(auto it = reference.begin(); it != reference.end(); ++it){
+            maxError = std::max(maxError, norm2(approx->at(it.getId()) - *it));
+        }
+
+        std::cout << std::setw(14) << tol << std::setw(14) << time << std::setw(14) << exactTime/std::max(time, 1.0E-12)
+                  << std::setw(14) << maxError << std::setw(14) << maxError/std::max(maxDispl, 1.0E-18) << std::endl;
+    }
+
+    /* Clean up & exit;
+     */
+    delete mrbf;
+    delete cloud;
+}
+
+int main( int argc, char *argv[] ) {
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+    long npoints = 100000;
+    int nnodes = 5000;
+    if(argc > 1)    npoints = std::atol(argv[1]);
+    if(argc > 2)    nnodes = std::atoi(argv[2]);
+
+        /**<Calling mimmo Test routine*/
+        try{
+            test00007(npoints, nnodes) ;
+        }
+        catch(std::exception & e){
+            std::cout<<"manipulators_example_00007 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+    MPI_Finalize();
+#endif
+
+    return  0;
+}
@@ -540,6 +540,17 @@ BaseManipulation::clear(){
  */
 void
 BaseManipulation::exec(){
+    execProcess();
+    execPorts();
+    execPost();
+}
+
+/*!
+ * First stage of the execution: it checks the mandatory input ports
+ * and runs the execute method of the object, if active.
+ */
+void
+BaseManipulation::execProcess(){
 
     if (!MIMMO_EXPERT){
         std::map<int, std::vector<PortIn*> > families;
@@ -582,14 +593,28 @@ BaseManipulation::exec(){
     }
 
     if (m_active) execute();
+}
 
+/*!
+ * Second stage of the execution: it runs the linked output ports,
+ * communicating the results to the receivers.
+ */
+void
+BaseManipulation::execPorts(){
     for (std::unordered_map<PortID, PortOut*>::iterator i=m_portOut.begin(); i!=m_portOut.end(); i++){
         std::vector<BaseManipulation*>	linked = i->second->getLink();
         if (linked.size() > 0){
             i->second->exec();
         }
     }
+}
 
+/*!
+ * Last stage of the execution: it plots the optional results and applies
+ * the results, if requested.
+ */
+void
+BaseManipulation::execPost(){
     if(isPlotInExecution())	plotOptionalResults();
     if(isApply()) apply();
 }
@@ -946,13 +971,8 @@ void
 BaseManipulation::_apply(MimmoPiercedVector<darray3E> & displacements)
 {
     if (getGeometry() == nullptr) return;
-    darray3E vertexcoords;
-    long int ID;
-    for (const auto & vertex : getGeometry()->getVertices()){
-        vertexcoords = vertex.getCoords();
-        ID = vertex.getId();
-        if(displacements.exists(ID))     vertexcoords += displacements[ID];
-        getGeometry()->modifyVertex(vertexcoords, ID);
+    if(!getGeometry()->displaceVertices(displacements)){
+        (*m_log)<<"WARNING "<<m_name<<" : displacements found on vertices not belonging to the linked geometry, they are ignored"<<std::endl;
     }
 
     getGeometry()->getPatch()->updateBoundingBox(true);
@@ -118,6 +118,10 @@ class BaseManipulation{
      * see mimmo::setLogger
      */
     friend void mimmo::setLogger(std::string log);
+    /*!
+     * Chain runs the execution stages separately in parallel mode, see Chain::exec
+     */
+    friend class Chain;
 
 public:
     //type definitions
@@ -276,6 +280,11 @@ protected:
     virtual void     apply();
     void             _apply(MimmoPiercedVector<darray3E> & displacements);
 
+private:
+    void    execProcess();
+    void    execPorts();
+    void    execPost();
+
 };
 
 
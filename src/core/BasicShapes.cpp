@@ -401,11 +401,12 @@ livector1D BasicShape::excludeGeometry(bitpit::PatchKernel * tri){
 livector1D BasicShape::includeCloudPoints(const dvecarr3E & list){
 
 	if(list.empty())	return livector1D(0);
+	bvector1D included = arePointsIncluded(list);
 	livector1D result(list.size());
 	int counter = 0;
 	long real = 0;
-	for(const auto & vert : list){
-		if(isPointIncluded(vert)){
+	for(bool check : included){
+		if(check){
 			result[counter] = real;
 			++counter;
 		}
@@ -448,12 +449,18 @@ livector1D BasicShape::includeCloudPoints(bitpit::PatchKernel * tri){
 
 	if(tri == NULL)		return livector1D(0);
 	livector1D result(tri->getVertexCount());
+	dvecarr3E coords(tri->getVertexCount());
 	int counter = 0;
-	long id;
 	for(auto & vert : tri->getVertices()){
-		id = vert.getId();
-		if(isPointIncluded(tri, id)){
-			result[counter] = id;
+		result[counter] = vert.getId();
+		coords[counter] = vert.getCoords();
+		++counter;
+	}
+	bvector1D included = arePointsIncluded(coords);
+	counter = 0;
+	for(std::size_t i=0; i<included.size(); ++i){
+		if(included[i]){
+			result[counter] = result[i];
 			++counter;
 		}
 	}
@@ -597,6 +604,78 @@ bool BasicShape::isPointIncluded(bitpit::PatchKernel * tri, const long int & ind
 
 
 
+/*!
+ * Check inclusion of a list of points in the volume of the shape. Same criterion of
+ * isPointIncluded, but points are transformed to the shape reference system all at once
+ * through the batch methods toLocalCoords/localToBasicCoords.
+ * \param[in] points list of 3D points
+ * \return boolean flags, true if the point at the same position of the list is included
+ */
+bvector1D BasicShape::arePointsIncluded(const dvecarr3E & points){
+
+    dvecarr3E basic = toLocalCoords(points);
+    localToBasicCoords(basic);
+
+    double tol = 1.0E-12;
+    bvector1D result(points.size());
+    std::size_t counter = 0;
+    for(const auto & temp2 : basic){
+        bool check = true;
+        for(int i=0; i<3; ++i){
+            check = check && ((temp2[i] > -1.0*tol) && (temp2[i]< (1.0+tol)));
+        }
+        result[counter] = check;
+        ++counter;
+    }
+    return(result);
+};
+
+/*!
+ * Transform a list of points from local reference system of the shape to world
+ * reference system. Default implementation calls toWorldCoord on each point;
+ * derived shapes reimplement it with statically bound inner loops.
+ * \param[in] points list of points in local coordinates
+ * \return transformed points
+ */
+dvecarr3E BasicShape::toWorldCoords(const dvecarr3E & points){
+    dvecarr3E result(points.size());
+    std::size_t counter = 0;
+    for(const auto & point : points){
+        result[counter] = toWorldCoord(point);
+        ++counter;
+    }
+    return(result);
+};
+
+/*!
+ * Transform a list of points from world reference system to local reference
+ * system of the shape. Default implementation calls toLocalCoord on each point;
+ * derived shapes reimplement it with statically bound inner loops.
+ * \param[in] points list of points in world coordinates
+ * \return transformed points
+ */
+dvecarr3E BasicShape::toLocalCoords(const dvecarr3E & points){
+    dvecarr3E result(points.size());
+    std::size_t counter = 0;
+    for(const auto & point : points){
+        result[counter] = toLocalCoord(point);
+        ++counter;
+    }
+    return(result);
+};
+
+/*!
+ * Transform in place a list of points from local reference system of the shape
+ * to basic elemental shape reference system. Default implementation calls
+ * localToBasic on each point.
+ * \param[in,out] points list of points
+ */
+void BasicShape::localToBasicCoords(dvecarr3E & points){
+    for(auto & point : points){
+        point = localToBasic(point);
+    }
+};
+
 /*!
  * \return the nearest point belonging to an Axis Aligned Bounding Box, given a target vertex.
  * If the target is internal to or on surface of the AABB, return the target itself.
@@ -650,12 +729,18 @@ void    BasicShape::searchKdTreeMatches(bitpit::KdTree<3,bitpit::Vertex,long> &
         }
     }
 
+    dvecarr3E candCoords;
+    candCoords.reserve(candidates.size());
+    for (const auto & idCand : candidates){
+        candCoords.push_back(tree.nodes[idCand].object_->getCoords());
+    }
+    bvector1D included = arePointsIncluded(candCoords);
+
     result.clear();
     result.reserve(candidates.size());
-    for (const auto & idCand : candidates){
-        bitpit::KdNode<bitpit::Vertex, long> & target = tree.nodes[idCand];
-        if(isPointIncluded(target.object_->getCoords())){
-            result.push_back(target.label);
+    for (std::size_t i=0; i<candidates.size(); ++i){
+        if(included[i]){
+            result.push_back(tree.nodes[candidates[i]].label);
         }
     }
     if (squeeze)
@@ -706,15 +791,33 @@ void    BasicShape::searchBvTreeMatches(bitpit::PatchSkdTree & tree,  bitpit::Pa
         }
     }
 
-    result.clear();
-    result.reserve(toBeCandidates.size());
+    //collect vertices of candidate simplicies and check their inclusion all at once.
+    livector1D cellCandidates;
+    std::vector<std::size_t> vertexOffsets(1, 0);
+    dvecarr3E vertexCoords;
     for (const auto & idCand : toBeCandidates){
         const bitpit::SkdNode &node = tree.getNode(idCand);
         std::vector<long> cellids = node.getCells();
         for(long id : cellids){
-            if(isSimplexIncluded(geo, id)){
-                result.push_back(id);
+            bitpit::ConstProxyVector<long> vIds = geo->getCell(id).getVertexIds();
+            for(const auto & val: vIds){
+                vertexCoords.push_back(geo->getVertex(val).getCoords());
             }
+            cellCandidates.push_back(id);
+            vertexOffsets.push_back(vertexCoords.size());
+        }
+    }
+    bvector1D included = arePointsIncluded(vertexCoords);
+
+    result.clear();
+    result.reserve(cellCandidates.size());
+    for (std::size_t i=0; i<cellCandidates.size(); ++i){
+        bool check = true;
+        for(std::size_t j=vertexOffsets[i]; j<vertexOffsets[i+1]; ++j){
+            check = check && included[j];
+        }
+        if(check){
+            result.push_back(cellCandidates[i]);
         }
     }
     if (squeeze)
@@ -943,6 +1046,77 @@ darray3E	Cube::localToBasic(const darray3E &point){
 	return(point - getLocalOrigin());
 };
 
+/*!
+ * Transform a list of points from local reference system of the shape,
+ * to world reference system. Same operations of Cube::toWorldCoord, unrolled
+ * on each coordinate.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Cube::toWorldCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+	const dmatrix33E & inv = m_sdr_inverse;
+	const darray3E & sc = m_scaling;
+	const darray3E & orig = m_origin;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		double w0 = points[i][0]*sc[0];
+		double w1 = points[i][1]*sc[1];
+		double w2 = points[i][2]*sc[2];
+		result[i][0] = (w0*inv[0][0] + w1*inv[0][1] + w2*inv[0][2]) + orig[0];
+		result[i][1] = (w0*inv[1][0] + w1*inv[1][1] + w2*inv[1][2]) + orig[1];
+		result[i][2] = (w0*inv[2][0] + w1*inv[2][1] + w2*inv[2][2]) + orig[2];
+	}
+	return(result);
+};
+
+/*!
+ * Transform a list of points from world coordinate system, to local reference system
+ * of the shape. Same operations of Cube::toLocalCoord, unrolled on each coordinate.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Cube::toLocalCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+	const dmatrix33E & sdr = m_sdr;
+	const darray3E & sc = m_scaling;
+	const darray3E & orig = m_origin;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		double w0 = points[i][0] - orig[0];
+		double w1 = points[i][1] - orig[1];
+		double w2 = points[i][2] - orig[2];
+		result[i][0] = (w0*sdr[0][0] + w1*sdr[0][1] + w2*sdr[0][2])/sc[0];
+		result[i][1] = (w0*sdr[1][0] + w1*sdr[1][1] + w2*sdr[1][2])/sc[1];
+		result[i][2] = (w0*sdr[2][0] + w1*sdr[2][1] + w2*sdr[2][2])/sc[2];
+	}
+	return(result);
+};
+
+/*!
+ * Transform in place a list of points from local reference system of the shape,
+ * to unitary cube reference system. See Cube::localToBasic.
+ * \param[in,out] points list of targets
+ */
+void	Cube::localToBasicCoords(dvecarr3E &points){
+	darray3E lo = getLocalOrigin();
+	long size = points.size();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		points[i][0] -= lo[0];
+		points[i][1] -= lo[1];
+		points[i][2] -= lo[2];
+	}
+};
+
 /*!
  * Check if your new span values fit your current shape set up
  * and eventually return correct values.
@@ -1190,6 +1364,57 @@ darray3E	Cylinder::localToBasic(const darray3E &point){
 	return(result);
 };
 
+/*!
+ * Transform a list of points from local reference system of the shape,
+ * to world reference system. See Cylinder::toWorldCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Cylinder::toWorldCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		result[i] = Cylinder::toWorldCoord(points[i]);
+	}
+	return(result);
+};
+
+/*!
+ * Transform a list of points from world coordinate system, to local reference system
+ * of the shape. See Cylinder::toLocalCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Cylinder::toLocalCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		result[i] = Cylinder::toLocalCoord(points[i]);
+	}
+	return(result);
+};
+
+/*!
+ * Transform in place a list of points from local reference system of the shape,
+ * to basic elemental shape reference system. See Cylinder::localToBasic.
+ * \param[in,out] points list of targets
+ */
+void	Cylinder::localToBasicCoords(dvecarr3E &points){
+	long size = points.size();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		points[i] = Cylinder::localToBasic(points[i]);
+	}
+};
+
 /*!
  * Check if your new span values fit your current shape set up
  * and eventually return correct values.
@@ -1462,6 +1687,57 @@ darray3E	Sphere::localToBasic(const darray3E & point){
 	return(result);
 };
 
+/*!
+ * Transform a list of points from local reference system of the shape,
+ * to world reference system. See Sphere::toWorldCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Sphere::toWorldCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		result[i] = Sphere::toWorldCoord(points[i]);
+	}
+	return(result);
+};
+
+/*!
+ * Transform a list of points from world coordinate system, to local reference system
+ * of the shape. See Sphere::toLocalCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E	Sphere::toLocalCoords(const dvecarr3E &points){
+	long size = points.size();
+	dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		result[i] = Sphere::toLocalCoord(points[i]);
+	}
+	return(result);
+};
+
+/*!
+ * Transform in place a list of points from local reference system of the shape,
+ * to basic elemental shape reference system. See Sphere::localToBasic.
+ * \param[in,out] points list of targets
+ */
+void	Sphere::localToBasicCoords(dvecarr3E &points){
+	long size = points.size();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(long i=0; i<size; ++i){
+		points[i] = Sphere::localToBasic(points[i]);
+	}
+};
+
 /*!
  * Check if your new span values fit your current shape set up
  * and eventually return correct values.
@@ -1733,6 +2009,57 @@ darray3E    Wedge::localToBasic(const darray3E &point){
     return  point - getLocalOrigin();
 };
 
+/*!
+ * Transform a list of points from local reference system of the shape,
+ * to world reference system. See Wedge::toWorldCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E    Wedge::toWorldCoords(const dvecarr3E &points){
+    long size = points.size();
+    dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for(long i=0; i<size; ++i){
+        result[i] = Wedge::toWorldCoord(points[i]);
+    }
+    return(result);
+};
+
+/*!
+ * Transform a list of points from world coordinate system, to local reference system
+ * of the shape. See Wedge::toLocalCoord.
+ * \param[in] points list of targets
+ * \return transformed points
+ */
+dvecarr3E    Wedge::toLocalCoords(const dvecarr3E &points){
+    long size = points.size();
+    dvecarr3E result(size);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for(long i=0; i<size; ++i){
+        result[i] = Wedge::toLocalCoord(points[i]);
+    }
+    return(result);
+};
+
+/*!
+ * Transform in place a list of points from local reference system of the shape,
+ * to basic elemental shape reference system. See Wedge::localToBasic.
+ * \param[in,out] points list of targets
+ */
+void    Wedge::localToBasicCoords(dvecarr3E &points){
+    long size = points.size();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for(long i=0; i<size; ++i){
+        points[i] = Wedge::localToBasic(points[i]);
+    }
+};
+
 /*!
  * Check if your new span values fit your current shape set up
  * and eventually return correct values.
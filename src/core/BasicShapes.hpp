@@ -135,6 +135,10 @@ public:
     bool        isSimplexIncluded(bitpit::PatchKernel * , const long int &indexT);
     bool        isPointIncluded(const darray3E &);
     bool        isPointIncluded(bitpit::PatchKernel * , const long int &indexV);
+    bvector1D   arePointsIncluded(const dvecarr3E &);
+
+    virtual dvecarr3E   toWorldCoords(const dvecarr3E & points);
+    virtual dvecarr3E   toLocalCoords(const dvecarr3E & points);
 
     /*!
      * Pure virtual method to get if the current shape an a given Axis Aligned Bounding Box intersects
@@ -189,6 +193,8 @@ private:
      */
     virtual darray3E    localToBasic(const darray3E &point)=0;
 
+    virtual void        localToBasicCoords(dvecarr3E & points);
+
     /*!
      * Pure virtual method to check if your new span values fit your current shape set up
      * and eventually return correct values.
@@ -248,12 +254,15 @@ public:
 
     darray3E    toWorldCoord(const darray3E &point);
     darray3E    toLocalCoord(const darray3E &point);
+    dvecarr3E   toWorldCoords(const dvecarr3E &points);
+    dvecarr3E   toLocalCoords(const dvecarr3E &points);
     darray3E    getLocalOrigin();
     bool    intersectShapeAABBox(const darray3E &bMin, const darray3E &bMax);
 
 private:
     darray3E    basicToLocal(const darray3E &point);
     darray3E    localToBasic(const darray3E &point);
+    void        localToBasicCoords(dvecarr3E &points);
     void        checkSpan(double &, double &, double &);
     bool        checkInfLimits(double &, int & dir);
     void        setScaling(const double &, const double &, const double &);
@@ -281,12 +290,15 @@ public:
     //reimplementing pure virtuals
     darray3E	toWorldCoord(const darray3E &point);
     darray3E	toLocalCoord(const darray3E &point);
+    dvecarr3E	toWorldCoords(const dvecarr3E &points);
+    dvecarr3E	toLocalCoords(const dvecarr3E &points);
     darray3E	getLocalOrigin();
     bool		intersectShapeAABBox(const darray3E &bMin, const darray3E &bMax);
 
 private:
     darray3E	basicToLocal(const darray3E &point);
     darray3E	localToBasic(const darray3E &point);
+    void		localToBasicCoords(dvecarr3E &points);
     void 		checkSpan(double &, double &, double &);
     bool 		checkInfLimits( double &, int &);
     void 		setScaling(const double &, const double &, const double &);
@@ -315,12 +327,15 @@ public:
     //reimplementing pure virtuals
     darray3E    toWorldCoord(const darray3E &point);
     darray3E    toLocalCoord(const darray3E &point);
+    dvecarr3E   toWorldCoords(const dvecarr3E &points);
+    dvecarr3E   toLocalCoords(const dvecarr3E &points);
     darray3E    getLocalOrigin();
     bool        intersectShapeAABBox(const darray3E &bMin, const darray3E &bMax);
 
 private:
     darray3E    basicToLocal(const darray3E &point);
     darray3E    localToBasic(const darray3E &point);
+    void        localToBasicCoords(dvecarr3E &points);
     void        checkSpan(double &, double &, double &);
     bool        checkInfLimits(double &, int &);
     void        setScaling(const double &, const double &, const double &);
@@ -351,12 +366,15 @@ public:
     //reimplementing pure virtuals
     darray3E    toWorldCoord(const darray3E &point);
     darray3E    toLocalCoord(const darray3E &point);
+    dvecarr3E   toWorldCoords(const dvecarr3E &points);
+    dvecarr3E   toLocalCoords(const dvecarr3E &points);
     darray3E    getLocalOrigin();
     bool        intersectShapeAABBox(const darray3E &bMin, const darray3E &bMax);
 
 private:
     darray3E    basicToLocal(const darray3E &point);
     darray3E    localToBasic(const darray3E &point);
+    void        localToBasicCoords(dvecarr3E &points);
     void        checkSpan( double &, double &, double &);
     bool        checkInfLimits(double &, int &);
     void        setScaling(const double &, const double &, const double &);
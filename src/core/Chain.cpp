@@ -22,9 +22,125 @@
  *
 \*---------------------------------------------------------------------------*/
 #include "Chain.hpp"
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#if MIMMO_ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 namespace mimmo{
 
+namespace {
+
+/*!
+ * \param[in] thread if true measure the calling thread only, otherwise the whole process.
+ * \return CPU time consumed by the calling thread or by the process, in seconds.
+ */
+double profileCpuTime(bool thread){
+#if defined(__unix__) || defined(__APPLE__)
+    struct timespec ts;
+    if (clock_gettime(thread ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID, &ts) == 0){
+        return double(ts.tv_sec) + 1.e-9*double(ts.tv_nsec);
+    }
+#endif
+    return double(std::clock())/double(CLOCKS_PER_SEC);
+}
+
+/*!
+ * \return current resident set size of the process, in kB. Where it is not available
+ * (no /proc filesystem) the peak resident set size is returned instead (0 if not available either).
+ */
+long profileRSS(){
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (statm >> pages >> resident){
+        return resident*(long(sysconf(_SC_PAGESIZE))/1024);
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0){
+#if defined(__APPLE__)
+        return long(usage.ru_maxrss/1024);
+#else
+        return long(usage.ru_maxrss);
+#endif
+    }
+#endif
+    return 0;
+}
+
+/*!
+ * \return peak resident set size of the process (high-water mark), in kB (0 if not available).
+ */
+long profilePeakRSS(){
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0){
+#if defined(__APPLE__)
+        return long(usage.ru_maxrss/1024);
+#else
+        return long(usage.ru_maxrss);
+#endif
+    }
+#endif
+    return 0;
+}
+
+/*!
+ * \return index of the calling thread.
+ */
+int profileThread(){
+#if MIMMO_ENABLE_OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * \param[in] str input string
+ * \return string escaped to be written as a JSON string value.
+ */
+std::string profileJsonEscape(const std::string & str){
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str){
+        if (c == '"' || c == '\\') result.push_back('\\');
+        result.push_back(c);
+    }
+    return result;
+}
+
+/*!
+ * \param[in] str input string
+ * \return string escaped to be written as a quoted CSV field.
+ */
+std::string profileCsvEscape(const std::string & str){
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str){
+        if (c == '"') result.push_back('"');
+        result.push_back(c);
+    }
+    return result;
+}
+
+}
+
 uint8_t Chain::sm_chaincounter(1);
 
 /*!
@@ -39,6 +155,9 @@ Chain::Chain(){
     sm_chaincounter++;
     m_plotDebRes = false;
     m_outputDebRes = ".";
+    m_parallel = false;
+    m_profiling = false;
+    m_profilePath = ".";
     m_log = &bitpit::log::cout(MIMMO_LOG_FILE);
 };
 
@@ -62,6 +181,11 @@ void Chain::swap(Chain & x) noexcept{
     std::swap(m_objcounter,x.m_objcounter);
     std::swap(m_plotDebRes,x.m_plotDebRes);
     std::swap(m_outputDebRes,x.m_outputDebRes);
+    std::swap(m_parallel,x.m_parallel);
+    std::swap(m_profiling,x.m_profiling);
+    std::swap(m_profilePath,x.m_profilePath);
+    std::swap(m_profile,x.m_profile);
+    std::swap(m_profileStart,x.m_profileStart);
 };
 
 /*!
@@ -73,6 +197,9 @@ std::unique_ptr<Chain>  Chain::clone() const{
     std::unique_ptr<Chain> res(new Chain());
     res->setOutputDebugResults(m_outputDebRes);
     res->setPlotDebugResults(m_plotDebRes);
+    res->setParallelExecution(m_parallel);
+    res->setProfiling(m_profiling);
+    res->setProfilingOutput(m_profilePath);
 
     int count(0);
     for(BaseManipulation * pp : m_objects){
@@ -272,19 +399,114 @@ std::string Chain::getOutputDebugResults(){
     return m_outputDebRes;
 }
 
+/*!
+ * Activate parallel execution of the chain. Objects without mutual dependencies
+ * are executed concurrently as OpenMP tasks. If mimmo is not compiled with OpenMP
+ * the chain is always executed serially. Serial execution is the default.
+ * Objects running as tasks execute their inner OpenMP loops on a single thread (nested
+ * parallelism is not activated), so the inner loop parallelism of each object is traded for
+ * the concurrency between objects: activate it for chains with several independent branches
+ * of comparable cost. Chains with no concurrent objects are executed serially anyway.
+ * \param[in] active true/false to activate parallel execution
+ */
+void Chain::setParallelExecution(bool active){
+    m_parallel = active;
+}
+
+/*!
+ * \return true if parallel execution of the chain is active.
+ */
+bool Chain::isParallelExecution(){
+    return m_parallel;
+}
+
+/*!
+ * Activate profiling of the chain execution. Timings and memory usage of each object
+ * are recorded and written in the profiling reports at the end of each execution.
+ * \param[in] active true/false to activate profiling
+ */
+void Chain::setProfiling(bool active){
+    m_profiling = active;
+}
+
+/*!
+ * Specify the directory path to store the profiling reports.
+ * \param[in] path output directory path
+ */
+void Chain::setProfilingOutput(std::string path){
+    m_profilePath = path;
+}
+
+/*!
+ * \return true if profiling of the chain execution is active.
+ */
+bool Chain::isProfiling(){
+    return m_profiling;
+}
+
+/*!
+ * \return directory path to store the profiling reports.
+ */
+std::string Chain::getProfilingOutput(){
+    return m_profilePath;
+}
+
+/*!
+ * \return profiling records of the last profiled execution, ordered as the objects in the chain.
+ */
+const std::vector<Chain::ProfileRecord> & Chain::getProfilingRecords(){
+    return m_profile;
+}
+
+
+/*!
+ * \brief Dependency graph of the chain objects, used during parallel execution.
+ *
+ * Objects are addressed by their index in the chain. All the execution state is
+ * protected by the graph mutex, while a mutex for each geometry in use prevents
+ * concurrent execution of objects working on the same geometry.
+ * Each thread owns a task logger, whose messages are collected in a thread log buffer
+ * and moved to the chain logger under the logger mutex.
+ */
+struct Chain::TaskGraph{
+    std::vector<std::vector<int> >      children;   /**< chain indices of the children of each object */
+    std::vector<std::vector<int> >      coparents;  /**< chain indices of the preceding objects sharing a receiver with each object */
+    std::vector<int>                    pending;    /**< number of parents of each object still to be completed */
+    std::vector<bool>                   executed;   /**< objects already executed */
+    std::vector<bool>                   fired;      /**< objects with output ports already fired */
+    std::vector<bool>                   done;       /**< objects completed (executed, fired and plotted/applied) */
+    std::vector<std::vector<int> >      waiting;    /**< objects waiting for the completion of each object, since working on the same geometry */
+    std::map<MimmoObject*, std::mutex>  geoMutex;   /**< mutex of each geometry in use */
+    std::mutex                          mutex;      /**< graph state mutex */
+    std::mutex                          logMutex;   /**< chain logger mutex */
+    std::vector<bitpit::Logger*>        loggers;    /**< task logger of each thread */
+    std::vector<std::unique_ptr<std::stringbuf> > logBuffers; /**< log buffer of each thread */
+    std::vector<std::streambuf*>        logSinks;   /**< original stream buffer of each task logger */
+    std::exception_ptr                  error;      /**< first error raised during execution */
+    int                                 counter;    /**< counter of objects started */
+
+    /*!
+     * \param[in] geo target geometry
+     * \return mutex associated to the geometry
+     */
+    std::mutex & getGeometryMutex(MimmoObject * geo){
+        std::lock_guard<std::mutex> lock(mutex);
+        return geoMutex[geo];
+    }
+};
 
 /*!
  * It executes the chain, i.e. it executes all the manipulator objects
  * contained in the chain following the correct order.
  * In the case that a loop exists in the chain the execution doesn't start and
  * the process ends with an error.
+ * If parallel execution is active (see setParallelExecution), objects whose
+ * parents have been all executed run concurrently.
  * \param[in]	debug boolean to activate verbose execution mode.
  */
 void
 Chain::exec(bool debug){
 
-    std::vector<BaseManipulation*>::iterator it, itb = m_objects.begin();
-    std::vector<BaseManipulation*>::iterator itend = m_objects.end();
     bitpit::log::Priority oldPriority = m_log->getPriority();
     if(debug)
         m_log->setPriority(bitpit::log::NORMAL);
@@ -299,6 +521,56 @@ Chain::exec(bool debug){
     }
     (*m_log) << " " << std::endl;
     checkLoops();
+
+    if(m_profiling){
+        m_profile.clear();
+        m_profile.resize(m_objects.size());
+        for (std::size_t i=0; i<m_objects.size(); i++){
+            ProfileRecord & record = m_profile[i];
+            record.name = m_objects[i]->getName();
+            record.id = m_idObjects[i];
+            record.start.fill(0.);
+            record.wall.fill(0.);
+            record.cpu.fill(0.);
+            record.thread.fill(-1);
+            record.rssDelta = 0;
+            record.peakRssDelta = 0;
+        }
+        m_profileStart = std::chrono::steady_clock::now();
+    }
+
+#if MIMMO_ENABLE_OPENMP
+    if(m_parallel){
+        execParallel(debug);
+    }else{
+        execSerial(debug);
+    }
+#else
+    execSerial(debug);
+#endif
+
+    if(m_profiling){
+        writeProfilingReport();
+    }
+
+    if(debug)
+        m_log->setPriority(bitpit::log::NORMAL);
+    (*m_log) << " " << std::endl;
+    (*m_log) << "--------------------------------------------------" << std::endl;
+    (*m_log) << " " << std::endl;
+    m_log->setPriority(oldPriority);
+}
+
+/*!
+ * It executes all the manipulator objects of the chain one after the other,
+ * following the chain order.
+ * \param[in]	debug boolean to activate verbose execution mode.
+ */
+void
+Chain::execSerial(bool debug){
+
+    std::vector<BaseManipulation*>::iterator it, itb = m_objects.begin();
+    std::vector<BaseManipulation*>::iterator itend = m_objects.end();
     int i = 1;
     for (it = itb; it != itend; ++it){
         if(debug)
@@ -309,14 +581,458 @@ Chain::exec(bool debug){
             (*it)->setPlotInExecution(m_plotDebRes);
             (*it)->setOutputPlot(m_outputDebRes);
         }
-        (*it)->exec();
+        execStage(i-1, 0);
+        execStage(i-1, 1);
+        execStage(i-1, 2);
         i++;
     }
+}
+
+/*!
+ * It executes the manipulator objects of the chain as OpenMP tasks, following
+ * their dependency graph. An object is scheduled when all its parents in the chain
+ * have been completed. The output ports of an object are fired only after the ports
+ * of all the preceding objects in the chain sharing a receiver with it, so that receivers
+ * get their data in the same order of the serial execution. Objects working on the same
+ * geometry are executed following the chain order, as in the serial execution.
+ * Messages logged by the objects during their stages are collected in a buffer of the
+ * executing thread and written to the chain logger at the end of each stage.
+ * The first error raised by an object stops the scheduling of the remaining ones and
+ * it is re-thrown at the end of the execution.
+ * If no level of the dependency graph holds more than one object the chain is executed serially.
+ * \param[in]	debug boolean to activate verbose execution mode.
+ */
+void
+Chain::execParallel(bool debug){
+
+    int nobjects = int(m_objects.size());
+    if (nobjects == 0) return;
+
+    std::unordered_map<BaseManipulation*, int> chainIndex;
+    for (int i=0; i<nobjects; i++){
+        chainIndex[m_objects[i]] = i;
+    }
 
-    (*m_log) << " " << std::endl;
-    (*m_log) << "--------------------------------------------------" << std::endl;
-    (*m_log) << " " << std::endl;
-    m_log->setPriority(oldPriority);
+    TaskGraph graph;
+    graph.children.resize(nobjects);
+    graph.coparents.resize(nobjects);
+    graph.pending.resize(nobjects, 0);
+    graph.executed.resize(nobjects, false);
+    graph.fired.resize(nobjects, false);
+    graph.done.resize(nobjects, false);
+    graph.waiting.resize(nobjects);
+    graph.counter = 0;
+
+    std::unordered_map<BaseManipulation*, std::vector<int> > receivers;
+    for (int i=0; i<nobjects; i++){
+        std::unordered_set<int> coparents;
+        for (int j=0; j<m_objects[i]->getNChild(); j++){
+            BaseManipulation * child = m_objects[i]->getChild(j);
+            if (child == NULL) continue;
+            for (int k : receivers[child]){
+                coparents.insert(k);
+            }
+            receivers[child].push_back(i);
+            auto itc = chainIndex.find(child);
+            if (itc != chainIndex.end()){
+                graph.children[i].push_back(itc->second);
+                graph.pending[itc->second]++;
+            }
+        }
+        graph.coparents[i].assign(coparents.begin(), coparents.end());
+    }
+
+    // Objects run as tasks leave their inner OpenMP loops on a single thread: if no level
+    // of the dependency graph holds more than one object there is nothing to overlap, and
+    // the serial execution keeps all the threads available to each object.
+    if (getMaxConcurrency(graph.children) < 2){
+        execSerial(debug);
+        return;
+    }
+
+    int nthreads = 1;
+#if MIMMO_ENABLE_OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    graph.loggers.resize(nthreads);
+    graph.logBuffers.resize(nthreads);
+    graph.logSinks.resize(nthreads);
+    for (int t=0; t<nthreads; t++){
+        std::string name = MIMMO_LOG_FILE + "_task" + std::to_string(t);
+        if (!bitpit::log::manager().exists(name)){
+            bitpit::log::manager().create(name, false);
+        }
+        graph.loggers[t] = &bitpit::log::cout(name);
+        graph.logBuffers[t].reset(new std::stringbuf());
+        graph.logSinks[t] = graph.loggers[t]->rdbuf(graph.logBuffers[t].get());
+    }
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#endif
+    {
+#if MIMMO_ENABLE_OPENMP
+#pragma omp single
+#endif
+        {
+            for (int i=0; i<nobjects; i++){
+                if (graph.pending[i] == 0){
+#if MIMMO_ENABLE_OPENMP
+#pragma omp task firstprivate(i)
+#endif
+                    execTask(i, &graph, debug);
+                }
+            }
+        }
+    }
+
+    for (int t=0; t<nthreads; t++){
+        graph.loggers[t]->rdbuf(graph.logSinks[t]);
+    }
+
+    if (graph.error){
+        std::rethrow_exception(graph.error);
+    }
+}
+
+/*!
+ * Evaluate the maximum number of objects of the chain that can run concurrently, as the
+ * largest level of the dependency graph (objects whose longest path from a root of the
+ * graph has the same length).
+ * \param[in] children chain indices of the children of each object
+ * \return maximum number of objects in the same level of the graph
+ */
+int
+Chain::getMaxConcurrency(const std::vector<std::vector<int> > & children){
+
+    int nobjects = int(children.size());
+    std::vector<int> pending(nobjects, 0);
+    for (const auto & list : children){
+        for (int c : list) pending[c]++;
+    }
+
+    std::vector<int> level;
+    for (int i=0; i<nobjects; i++){
+        if (pending[i] == 0) level.push_back(i);
+    }
+    int maxWidth = 0;
+    while (!level.empty()){
+        maxWidth = std::max(maxWidth, int(level.size()));
+        std::vector<int> next;
+        for (int i : level){
+            for (int c : children[i]){
+                pending[c]--;
+                if (pending[c] == 0) next.push_back(c);
+            }
+        }
+        level.swap(next);
+    }
+    return maxWidth;
+}
+
+/*!
+ * It executes a manipulator object of the chain during parallel execution, then
+ * it fires the output ports of all the objects allowed to, and it schedules as new
+ * tasks the objects whose parents are all completed.
+ * \param[in]	idx index of the object in the chain.
+ * \param[in]	graph dependency graph of the chain.
+ * \param[in]	debug boolean to activate verbose execution mode.
+ */
+void
+Chain::execTask(int idx, TaskGraph * graph, bool debug){
+
+    BaseManipulation * obj = m_objects[idx];
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(graph->mutex);
+        failed = bool(graph->error);
+
+        // Wait for the completion of the preceding objects in the chain working
+        // on the same geometry: the task is scheduled again when they are done.
+        MimmoObject * geo = obj->getGeometry();
+        if (!failed && geo != NULL){
+            for (int k=0; k<idx; k++){
+                if (!graph->done[k] && m_objects[k]->getGeometry() == geo){
+                    graph->waiting[k].push_back(idx);
+                    return;
+                }
+            }
+        }
+    }
+
+    if (!failed){
+        try{
+            {
+                std::lock_guard<std::mutex> lock(graph->logMutex);
+                graph->counter++;
+                if(debug)
+                    m_log->setPriority(bitpit::log::NORMAL);
+                (*m_log) << " execution object " << graph->counter << "	: " << obj->getName() << std::endl;
+            }
+            if(m_plotDebRes){
+                obj->setPlotInExecution(m_plotDebRes);
+                obj->setOutputPlot(m_outputDebRes);
+            }
+            MimmoObject * geo = obj->getGeometry();
+            if (geo != NULL){
+                std::lock_guard<std::mutex> lock(graph->getGeometryMutex(geo));
+                execTaskStage(idx, 0, graph);
+            }else{
+                execTaskStage(idx, 0, graph);
+            }
+        }catch(...){
+            std::lock_guard<std::mutex> lock(graph->mutex);
+            if (!graph->error) graph->error = std::current_exception();
+        }
+    }
+
+    // Fire the output ports of every executed object whose preceding co-parents have fired.
+    std::vector<int> completed;
+    {
+        std::lock_guard<std::mutex> lock(graph->mutex);
+        graph->executed[idx] = true;
+        bool changed = true;
+        while (changed){
+            changed = false;
+            for (int k=0; k<int(m_objects.size()); k++){
+                if (!graph->executed[k] || graph->fired[k]) continue;
+                bool ready = true;
+                for (int j : graph->coparents[k]){
+                    ready = ready && graph->fired[j];
+                }
+                if (!ready) continue;
+                if (!graph->error){
+                    try{
+                        std::lock_guard<std::mutex> loglock(graph->logMutex);
+                        execStage(k, 1);
+                    }catch(...){
+                        graph->error = std::current_exception();
+                    }
+                }
+                graph->fired[k] = true;
+                completed.push_back(k);
+                changed = true;
+            }
+        }
+    }
+
+    for (int k : completed){
+        bool skip;
+        {
+            std::lock_guard<std::mutex> lock(graph->mutex);
+            skip = bool(graph->error);
+        }
+        if (!skip){
+            try{
+                MimmoObject * geo = m_objects[k]->getGeometry();
+                if (geo != NULL){
+                    std::lock_guard<std::mutex> lock(graph->getGeometryMutex(geo));
+                    execTaskStage(k, 2, graph);
+                }else{
+                    execTaskStage(k, 2, graph);
+                }
+            }catch(...){
+                std::lock_guard<std::mutex> lock(graph->mutex);
+                if (!graph->error) graph->error = std::current_exception();
+            }
+        }
+
+        std::vector<int> ready;
+        {
+            std::lock_guard<std::mutex> lock(graph->mutex);
+            graph->done[k] = true;
+            ready.swap(graph->waiting[k]);
+            for (int c : graph->children[k]){
+                graph->pending[c]--;
+                if (graph->pending[c] == 0) ready.push_back(c);
+            }
+        }
+        for (int c : ready){
+#if MIMMO_ENABLE_OPENMP
+#pragma omp task firstprivate(c)
+#endif
+            execTask(c, graph, debug);
+        }
+    }
+}
+
+/*!
+ * It runs an execution stage of an object of the chain during parallel execution.
+ * The object and its geometry log on the task logger of the executing thread; at the end
+ * of the stage the collected messages are written to the chain logger, so that the shared
+ * logger is never written concurrently.
+ * \param[in]	idx index of the object in the chain.
+ * \param[in]	stage execution stage: 0-execute, 2-plot/apply.
+ * \param[in]	graph dependency graph of the chain.
+ */
+void
+Chain::execTaskStage(int idx, int stage, TaskGraph * graph){
+
+    int thread = 0;
+#if MIMMO_ENABLE_OPENMP
+    thread = omp_get_thread_num();
+#endif
+    BaseManipulation * obj = m_objects[idx];
+    bitpit::Logger * objLog = obj->m_log;
+    obj->m_log = graph->loggers[thread];
+
+    std::exception_ptr error;
+    {
+        MimmoObject::ScopedLoggerRedirection redirection(obj->getGeometry(), graph->loggers[thread]);
+        try{
+            execStage(idx, stage);
+        }catch(...){
+            error = std::current_exception();
+        }
+    }
+
+    obj->m_log = objLog;
+
+    std::string text = graph->logBuffers[thread]->str();
+    graph->logBuffers[thread]->str("");
+    if (!text.empty()){
+        std::lock_guard<std::mutex> lock(graph->logMutex);
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)){
+            (*m_log) << line << std::endl;
+        }
+    }
+
+    if (error){
+        std::rethrow_exception(error);
+    }
+}
+
+/*!
+ * It runs an execution stage of an object of the chain, recording its
+ * timings and memory usage if profiling is active.
+ * \param[in]	idx index of the object in the chain.
+ * \param[in]	stage execution stage: 0-execute, 1-output ports, 2-plot/apply.
+ */
+void
+Chain::execStage(int idx, int stage){
+
+    BaseManipulation * obj = m_objects[idx];
+    std::chrono::steady_clock::time_point t0;
+    double cpu0 = 0.;
+    //in parallel mode the CPU time of the executing thread only is meaningful.
+#if MIMMO_ENABLE_OPENMP
+    bool threadCpu = m_parallel;
+#else
+    bool threadCpu = false;
+#endif
+    if(m_profiling){
+        if (stage == 0){
+            m_profile[idx].rssDelta = -profileRSS();
+            m_profile[idx].peakRssDelta = -profilePeakRSS();
+        }
+        t0 = std::chrono::steady_clock::now();
+        cpu0 = profileCpuTime(threadCpu);
+    }
+
+    switch(stage){
+    case 0:
+        obj->execProcess();
+        break;
+    case 1:
+        obj->execPorts();
+        break;
+    default:
+        obj->execPost();
+        break;
+    }
+
+    if(m_profiling){
+        ProfileRecord & record = m_profile[idx];
+        record.start[stage] = std::chrono::duration<double>(t0 - m_profileStart).count();
+        record.wall[stage] = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        record.cpu[stage] = profileCpuTime(threadCpu) - cpu0;
+        record.thread[stage] = profileThread();
+        if (stage == 2){
+            record.rssDelta += profileRSS();
+            record.peakRssDelta += profilePeakRSS();
+        }
+    }
+}
+
+/*!
+ * It writes the profiling records of the last execution in the profiling output
+ * directory, as JSON report (chain<ID>_profile.json), CSV report (chain<ID>_profile.csv)
+ * and Chrome trace event file (chain<ID>_trace.json), loadable in chrome://tracing.
+ */
+void
+Chain::writeProfilingReport(){
+
+    std::string stages[3] = {"execute", "ports", "post"};
+    std::string prefix = m_profilePath + "/chain" + std::to_string(int(m_id));
+
+    std::ofstream json(prefix + "_profile.json");
+    if (json.is_open()){
+        json << std::setprecision(9);
+        json << "{" << std::endl;
+        json << "  \"chain\": " << int(m_id) << "," << std::endl;
+        json << "  \"parallel\": " << (m_parallel ? "true" : "false") << "," << std::endl;
+        json << "  \"objects\": [" << std::endl;
+        for (std::size_t i=0; i<m_profile.size(); i++){
+            const ProfileRecord & record = m_profile[i];
+            json << "    {\"index\": " << i << ", \"id\": " << record.id << ", \"name\": \"" << profileJsonEscape(record.name) << "\"";
+            for (int stage=0; stage<3; stage++){
+                json << ", \"" << stages[stage] << "\": {\"start\": " << record.start[stage] << ", \"wall\": " << record.wall[stage]
+                     << ", \"cpu\": " << record.cpu[stage] << ", \"thread\": " << record.thread[stage] << "}";
+            }
+            json << ", \"rssDelta_kB\": " << record.rssDelta << ", \"peakRssDelta_kB\": " << record.peakRssDelta << "}";
+            if (i+1 < m_profile.size()) json << ",";
+            json << std::endl;
+        }
+        json << "  ]" << std::endl;
+        json << "}" << std::endl;
+        json.close();
+    }else{
+        (*m_log) << "warning: chain unable to write profiling report " << prefix << "_profile.json" << std::endl;
+    }
+
+    std::ofstream csv(prefix + "_profile.csv");
+    if (csv.is_open()){
+        csv << std::setprecision(9);
+        csv << "index,id,name,execute_wall,execute_cpu,ports_wall,ports_cpu,post_wall,post_cpu,rss_delta_kb,peak_rss_delta_kb" << std::endl;
+        for (std::size_t i=0; i<m_profile.size(); i++){
+            const ProfileRecord & record = m_profile[i];
+            csv << i << "," << record.id << ",\"" << profileCsvEscape(record.name) << "\"";
+            for (int stage=0; stage<3; stage++){
+                csv << "," << record.wall[stage] << "," << record.cpu[stage];
+            }
+            csv << "," << record.rssDelta << "," << record.peakRssDelta << std::endl;
+        }
+        csv.close();
+    }else{
+        (*m_log) << "warning: chain unable to write profiling report " << prefix << "_profile.csv" << std::endl;
+    }
+
+    std::ofstream trace(prefix + "_trace.json");
+    if (trace.is_open()){
+        trace << std::fixed << std::setprecision(3);
+        trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+        bool first = true;
+        for (std::size_t i=0; i<m_profile.size(); i++){
+            const ProfileRecord & record = m_profile[i];
+            for (int stage=0; stage<3; stage++){
+                if (record.thread[stage] < 0) continue;
+                if (!first) trace << "," << std::endl;
+                first = false;
+                trace << "  {\"name\": \"" << profileJsonEscape(record.name) << "\", \"cat\": \"" << stages[stage] << "\", \"ph\": \"X\""
+                      << ", \"ts\": " << 1.e6*record.start[stage] << ", \"dur\": " << 1.e6*record.wall[stage]
+                      << ", \"pid\": " << int(m_id) << ", \"tid\": " << record.thread[stage]
+                      << ", \"args\": {\"cpu_ms\": " << 1.e3*record.cpu[stage] << "}}";
+            }
+        }
+        trace << std::endl << "]}" << std::endl;
+        trace.close();
+    }else{
+        (*m_log) << "warning: chain unable to write profiling trace " << prefix << "_trace.json" << std::endl;
+    }
+
+    (*m_log) << " Profiling reports written in " << prefix << "_profile.json/.csv and " << prefix << "_trace.json" << std::endl;
 }
 
 /*!
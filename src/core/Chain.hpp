@@ -25,6 +25,8 @@
 #define __CHAIN_HPP__
 
 #include "BaseManipulation.hpp"
+#include <array>
+#include <chrono>
 #include <memory>
 
 namespace mimmo{
@@ -44,9 +46,50 @@ namespace mimmo{
  * conflicts in parent/child dependencies.
  * Closed connections loops in the chain are not allowed.
  *
+ * The chain can be executed serially (default) or in parallel mode (see setParallelExecution),
+ * available when mimmo is compiled with OpenMP. In parallel mode the dependency graph of the objects
+ * is built from their parent/child links and each object is executed as an OpenMP task as soon as all
+ * its parents in the chain are done, so that independent branches run concurrently.
+ * The output ports of objects sharing a receiver are still fired following the chain order, and
+ * objects working on the same geometry are executed one after the other following the chain order.
+ * Messages logged by an object in parallel mode are buffered by the executing thread and written
+ * to the chain logger at the end of each execution stage.
+ * Nested parallelism is not activated: an object running as a task executes its own OpenMP loops
+ * on a single thread. Parallel mode pays off when the independent branches carry comparable work,
+ * while a chain dominated by one heavy object runs faster serially, where that object gets all the
+ * threads. A chain whose dependency graph allows no concurrent objects is always executed serially.
+ *
+ * Execution profiling can be activated with setProfiling. For each object it records wall and CPU time
+ * of its execution stages (execute, output ports transfer, optional results plotting and apply) and the
+ * change of the process resident memory during its execution. CPU time is the one of the whole process
+ * in serial mode, including the threads spawned by the object, and the one of the executing thread in
+ * parallel mode, where threads spawned by the object are not accounted. Resident memory is sampled on the
+ * whole process (current resident set on Linux, peak resident set elsewhere): in parallel mode the change
+ * includes the allocations of the objects running concurrently. The growth of the process peak resident
+ * set (high-water mark) is recorded as well, to catch temporary allocations released before the end of
+ * the object execution; it is zero when the object stays below the peak reached before it. At the end of the execution the
+ * records are written in the profiling output directory as a JSON and a CSV report (chain<ID>_profile.json/.csv)
+ * and as a trace in Chrome trace event format (chain<ID>_trace.json).
+ *
  */
 class Chain{
 
+public:
+    /*!
+     * \brief Execution profile of a chain object.
+     * Stage entries are indexed as 0-execute, 1-output ports transfer, 2-plot/apply.
+     */
+    struct ProfileRecord{
+        std::string             name;           /**< name of the object */
+        int                     id;             /**< ID of the object in the chain */
+        std::array<double,3>    start;          /**< start time of each stage from chain execution start, in seconds */
+        std::array<double,3>    wall;           /**< wall time of each stage, in seconds */
+        std::array<double,3>    cpu;            /**< CPU time of each stage (process in serial mode, executing thread in parallel mode), in seconds */
+        std::array<int,3>       thread;         /**< thread executing each stage, -1 if stage not executed */
+        long                    rssDelta;       /**< change of process resident memory during execution, in kB */
+        long                    peakRssDelta;   /**< growth of process peak resident memory (high-water mark) during execution, in kB */
+    };
+
 protected:
 	//members
 	uint8_t							m_id;				/**<ID of the chain.*/
@@ -58,6 +101,11 @@ protected:
 
     bool                            m_plotDebRes;       /**<boolean to activate plotting of debug intermediate results */
     std::string                     m_outputDebRes;     /**<directory path to store the debug intermediate results, if plot is enabled*/
+    bool                            m_parallel;         /**<boolean to activate parallel execution of independent objects */
+    bool                            m_profiling;        /**<boolean to activate execution profiling */
+    std::string                     m_profilePath;      /**<directory path to store the profiling reports */
+    std::vector<ProfileRecord>      m_profile;          /**<execution profile of the objects, ordered as in the chain */
+    std::chrono::steady_clock::time_point m_profileStart; /**<start time of the profiled execution */
 	//static members
 	static	uint8_t					sm_chaincounter;	/**<Current global number of chain in the instance. */
 
@@ -84,6 +132,13 @@ public:
     void            setOutputDebugResults(std::string path);
     bool            isPlottingDebugResults();
     std::string     getOutputDebugResults();
+    void            setParallelExecution(bool active);
+    bool            isParallelExecution();
+    void            setProfiling(bool active);
+    void            setProfilingOutput(std::string path);
+    bool            isProfiling();
+    std::string     getProfilingOutput();
+    const std::vector<ProfileRecord> & getProfilingRecords();
 
 	//relationship methods
 	void 		exec(bool debug = false);
@@ -93,8 +148,17 @@ protected:
     void swap(Chain &x) noexcept;
     //check methods
 	void		checkLoops();
+    void        writeProfilingReport();
 
 private:
+    struct TaskGraph;
+    void        execSerial(bool debug);
+    void        execParallel(bool debug);
+    int         getMaxConcurrency(const std::vector<std::vector<int> > & children);
+    void        execTask(int idx, TaskGraph * graph, bool debug);
+    void        execTaskStage(int idx, int stage, TaskGraph * graph);
+    void        execStage(int idx, int stage);
+
     // preventing copy constr and assignment. use clone instead.
     Chain(const Chain & other);
     Chain & operator=(const Chain & other);
@@ -1221,6 +1221,7 @@ bool DataType::operator==(const DataType & other){
  */
 PortOut::PortOut(){
     m_objLink.clear();
+    m_direct = true;
 };
 
 /*!
@@ -1236,6 +1237,7 @@ PortOut::PortOut(const PortOut & other){
     m_obuffer	= other.m_obuffer;
     m_portLink	= other.m_portLink;
     m_datatype	= other.m_datatype;
+    m_direct	= other.m_direct;
     return;
 };
 
@@ -1285,6 +1287,25 @@ mimmo::PortOut::cleanBuffer(){
     m_obuffer.seekg(0);
 }
 
+/*!
+ * Enable/disable the direct transfer mode of the port. If enabled (default),
+ * data types marked by PortDirectTransfer are passed to the linked input ports
+ * of the same type without buffer serialization.
+ * \param[in] direct true to enable the direct transfer mode.
+ */
+void
+mimmo::PortOut::setDirectTransfer(bool direct){
+    m_direct = direct;
+}
+
+/*!
+ * \return true if the direct transfer mode of the port is enabled.
+ */
+bool
+mimmo::PortOut::isDirectTransfer(){
+    return m_direct;
+}
+
 /*!
  * It clears the links to objects and the related ports.
  */
@@ -1310,19 +1331,50 @@ mimmo::PortOut::clear(int j){
  * Execution of the PIN.
  * All the pins are called in execution of the sending owner after its own execution.
  * Reading stage of pin linked receivers is automatically performed within this execution.
+ * Links to input ports of the same data type are served by direct transfer when allowed
+ * (see setDirectTransfer), the remaining ones through the serialized buffer, which is
+ * written once at the first of them. Links are served in their original order:
+ * each run of consecutive direct links shares one read of the output data.
  */
 void
 mimmo::PortOut::exec(){
     if (m_objLink.size() > 0){
-        writeBuffer();
-        bitpit::IBinaryStream input(m_obuffer.data(), m_obuffer.getSize());
-        cleanBuffer();
+
+        bool direct = m_direct && canDirectTransfer();
+        std::unique_ptr<bitpit::IBinaryStream> input;
+        std::vector<PortIn*> directTargets;
+        directTargets.reserve(m_objLink.size());
         for (int j=0; j<(int)m_objLink.size(); j++){
-            if (m_objLink[j] != NULL){
-                m_objLink[j]->setBufferIn(m_portLink[j], input);
-                m_objLink[j]->readBufferIn(m_portLink[j]);
-                m_objLink[j]->cleanBufferIn(m_portLink[j]);
+            if (m_objLink[j] == NULL) continue;
+            PortIn * target = NULL;
+            if (direct){
+                auto it = m_objLink[j]->m_portIn.find(m_portLink[j]);
+                if (it != m_objLink[j]->m_portIn.end() && it->second != NULL && it->second->acceptsDirect(getDirectType())){
+                    target = it->second;
+                }
+            }
+            if (target != NULL){
+                directTargets.push_back(target);
+                continue;
+            }
+
+            //serve the pending direct links before this buffered one
+            if (!directTargets.empty()){
+                writeDirect(directTargets);
+                directTargets.clear();
+            }
+            if (!input){
+                writeBuffer();
+                input = std::unique_ptr<bitpit::IBinaryStream>(new bitpit::IBinaryStream(m_obuffer.data(), m_obuffer.getSize()));
+                cleanBuffer();
             }
+            m_objLink[j]->setBufferIn(m_portLink[j], *input);
+            m_objLink[j]->readBufferIn(m_portLink[j]);
+            m_objLink[j]->cleanBufferIn(m_portLink[j]);
+        }
+
+        if (!directTargets.empty()){
+            writeDirect(directTargets);
         }
     }
 };
@@ -28,10 +28,13 @@
 #include "MimmoPiercedVector.hpp"
 #include <binary_stream.hpp>
 #include <functional>
+#include <typeinfo>
+#include <type_traits>
 
 namespace mimmo{
 
 class BaseManipulation;
+class PortIn;
 struct FileDataInfo;
 class TrackingPointer;
 
@@ -78,6 +81,36 @@ public:
 
 };
 
+/*!
+ * \brief Trait marking the data types eligible for direct (unserialized) transfer between ports.
+ * \ingroup core
+ *
+ * Heavy payloads, i.e. std::vector and MimmoPiercedVector containers, are handed
+ * from the sender to the receivers without passing through the binary stream buffer.
+ * All other types keep the serialized exchange.
+ *
+ * A direct transfer hands over a copy of the whole container, while the serialized exchange
+ * streams only part of it. For MimmoPiercedVector the stream carries the linked geometry,
+ * the data location and the id/value pairs, and the receiver rebuilds the container from them.
+ * The field name is not streamed (its operators are commented out), so a name is kept only
+ * through a direct transfer. The same holds for the internal storage layout of the sender,
+ * e.g. the holes left by erased elements.
+ */
+template<typename T>
+struct PortDirectTransfer : std::false_type {};
+
+/*!
+ * \brief Direct transfer enabled for std::vector containers.
+ */
+template<typename T, typename A>
+struct PortDirectTransfer<std::vector<T, A> > : std::true_type {};
+
+/*!
+ * \brief Direct transfer enabled for MimmoPiercedVector containers.
+ */
+template<typename T>
+struct PortDirectTransfer<MimmoPiercedVector<T> > : std::true_type {};
+
 /*!
 * \class PortOut
 * \brief PortOut is the abstract PIN base class dedicated to exchange data from a target class to other ones (output).
@@ -101,6 +134,11 @@ public:
 *
 * The execution of the output PortT will automatically
 * exchange the buffer data, pass it to the input ports connected and makes them reading and decoding the data.
+*
+* Data types marked by PortDirectTransfer are instead passed directly to the connected
+* input ports sharing the same C++ type, skipping the buffer serialization (direct transfer mode,
+* active by default, see setDirectTransfer). Receivers with a different but stream-compatible
+* type fall back to the buffer exchange.
 */
 class PortOut{
 public:
@@ -109,6 +147,7 @@ public:
     std::vector<BaseManipulation*>  m_objLink;	/**<Outputs object to which communicate the data.*/
     std::vector<PortID>             m_portLink;	/**<ID of the input ports of the linked objects.*/
     DataType                        m_datatype;	/**<TAG of type of data communicated.*/
+    bool                            m_direct;	/**<Direct transfer mode enabled.*/
 
 public:
     PortOut();
@@ -127,11 +166,29 @@ public:
     virtual void	writeBuffer() = 0;
     void 			cleanBuffer();
 
+    void            setDirectTransfer(bool direct);
+    bool            isDirectTransfer();
+
     void clear();
     void clear(int j);
 
     void exec();
 
+protected:
+    /*!
+     * \return true if the data type of the port can be directly transferred.
+     */
+    virtual bool    canDirectTransfer(){return false;};
+    /*!
+     * \return type info of the data communicated by the port.
+     */
+    virtual const std::type_info & getDirectType(){return typeid(void);};
+    /*!
+     * Pass the data directly to the target input ports.
+     * \param[in] targets input ports receiving the data
+     */
+    virtual void    writeDirect(const std::vector<PortIn*> & /*targets*/){};
+
 };
 
 
@@ -182,6 +239,11 @@ public:
 
     void writeBuffer();
 
+protected:
+    bool canDirectTransfer();
+    const std::type_info & getDirectType();
+    void writeDirect(const std::vector<PortIn*> & targets);
+
 };
 
 
@@ -239,6 +301,18 @@ public:
     virtual void    readBuffer() = 0;
     void            cleanBuffer();
 
+    /*!
+     * \param[in] type type info of the data sent
+     * \return true if the port can receive directly data of the given type.
+     */
+    virtual bool    acceptsDirect(const std::type_info & /*type*/){return false;};
+    /*!
+     * Receive data directly from a sender port.
+     * \param[in] data pointer to the data sent
+     * \param[in] movable true if the data can be moved into the receiver
+     */
+    virtual void    readDirect(void * /*data*/, bool /*movable*/){};
+
 };
 
 
@@ -290,6 +364,8 @@ public:
     bool operator==(const PortInT & other);
 
     void readBuffer();
+    bool acceptsDirect(const std::type_info & type);
+    void readDirect(void * data, bool movable);
 
 };
 
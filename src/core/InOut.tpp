@@ -137,6 +137,50 @@ PortOutT<T,O>::writeBuffer(){
     }
 }
 
+/*!
+ * \return true if the data type T is marked for direct transfer (see PortDirectTransfer).
+ */
+template<typename T, typename O>
+bool
+PortOutT<T,O>::canDirectTransfer(){
+    return PortDirectTransfer<T>::value;
+}
+
+/*!
+ * \return type info of the data type T communicated.
+ */
+template<typename T, typename O>
+const std::type_info &
+PortOutT<T,O>::getDirectType(){
+    return typeid(T);
+}
+
+/*!
+ * It passes the data to be communicated directly to the target input ports,
+ * without serialization. The data recovered by the get function is a temporary
+ * copy, so it is moved into the last target; the data pointed by m_var_ is always copied.
+ * \param[in] targets input ports receiving the data
+ */
+template<typename T, typename O>
+void
+PortOutT<T,O>::writeDirect(const std::vector<PortIn*> & targets){
+    if (targets.empty())    return;
+    if (m_getVar_ != NULL){
+        T temp = ((m_obj_->*m_getVar_)());
+        std::size_t last = targets.size() - 1;
+        for (std::size_t j=0; j<last; j++){
+            targets[j]->readDirect(&temp, false);
+        }
+        targets[last]->readDirect(&temp, true);
+        return;
+    }
+    if (m_var_ != NULL){
+        for (PortIn * target : targets){
+            target->readDirect(m_var_, false);
+        }
+    }
+}
+
 
 
 /*!
@@ -262,4 +306,35 @@ PortInT<T, O>::readBuffer(){
     }
 }
 
+/*!
+ * \param[in] type type info of the data sent
+ * \return true if the data sent is of the same type T of the port.
+ */
+template<typename T, typename O>
+bool
+PortInT<T, O>::acceptsDirect(const std::type_info & type){
+    return (type == typeid(T));
+}
+
+/*!
+ * It stores the data received directly from a sender port in the linked m_var_
+ * or passes it to the linked set function.
+ * \param[in] data pointer to the data sent, of type T
+ * \param[in] movable true if the data can be moved into the receiver
+ */
+template<typename T, typename O>
+void
+PortInT<T, O>::readDirect(void * data, bool movable){
+    T & value = *(static_cast<T*>(data));
+    if (m_setVar_ != NULL){
+        if (movable)    (m_obj_->*m_setVar_)(std::move(value));
+        else            (m_obj_->*m_setVar_)(value);
+        return;
+    }
+    if (m_var_ != NULL){
+        if (movable)    (*m_var_) = std::move(value);
+        else            (*m_var_) = value;
+    }
+}
+
 }
@@ -0,0 +1,345 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+\*---------------------------------------------------------------------------*/
+# include "KdTreeUtils.hpp"
+# include <algorithm>
+# include <numeric>
+# include <cmath>
+# include <stdexcept>
+
+namespace mimmo{
+
+namespace kdTreeUtils{
+
+/*!
+ * Minimum size of a sub-range of points to be sorted by a dedicated OpenMP task in balancedInsertionOrder.
+ */
+#define KDTREEUTILS_TASK_SIZE 4096
+
+namespace {
+
+/*!
+ * Entry of the stack used to visit a KdTree: node index, node level and
+ * squared lower bound of the distance between the query point and the node subtree.
+ */
+struct KdStackEntry{
+    int node;
+    int level;
+    double bound;
+};
+
+/*!
+ * Fill recursively the balanced insertion order of a sub-range of points. The median point
+ * along the splitting direction of the level is written at position pos of the order, followed by
+ * the order of the lower half and of the upper half of the sub-range. If other points share the
+ * median coordinate, the split point is moved to the nearest end of their run, so that the lower
+ * half holds all the points not greater than it, as required by the insertion in bitpit::KdTree.
+ * \param[in] points pointer to the first point coordinates
+ * \param[in,out] idx pointer to the first point index, partially reordered on exit
+ * \param[in] begin first position of the sub-range in idx
+ * \param[in] end past-the-end position of the sub-range in idx
+ * \param[in] level level of the median point in the tree
+ * \param[out] order pointer to the first element of the insertion order
+ * \param[in] pos position of the median point in the insertion order
+ */
+void fillBalancedOrder(const std::array<double,3> *points, std::size_t *idx, std::size_t begin, std::size_t end,
+                       int level, std::size_t *order, std::size_t pos)
+{
+    if (begin >= end) return;
+
+    int dir = level%3;
+    auto less = [points, dir](std::size_t a, std::size_t b){return points[a][dir] < points[b][dir];};
+    std::size_t median = begin + (end - begin)/2;
+    std::nth_element(idx + begin, idx + median, idx + end, less);
+
+    //bitpit::KdTree sends the points with the same coordinate of a node to its left subtree:
+    //split at the boundary of the run of coordinates equal to the median one nearest to the median.
+    double value = points[idx[median]][dir];
+    std::size_t upper = std::partition(idx + median + 1, idx + end,
+                                       [points, dir, value](std::size_t a){return points[a][dir] == value;}) - idx - 1;
+    std::size_t lower = std::partition(idx + begin, idx + median,
+                                       [points, dir, value](std::size_t a){return points[a][dir] < value;}) - idx;
+    std::size_t split = upper;
+    if (lower > begin && (median + 1 - lower) <= (upper - median)){
+        //split on the greatest coordinate lower than the median one
+        std::size_t last = std::max_element(idx + begin, idx + lower, less) - idx;
+        std::swap(idx[last], idx[lower - 1]);
+        split = lower - 1;
+    }
+    order[pos] = idx[split];
+
+    std::size_t posLeft  = pos + 1;
+    std::size_t posRight = pos + 1 + (split - begin);
+    if (end - begin > KDTREEUTILS_TASK_SIZE){
+#if MIMMO_ENABLE_OPENMP
+#pragma omp task
+#endif
+        fillBalancedOrder(points, idx, begin, split, level+1, order, posLeft);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp task
+#endif
+        fillBalancedOrder(points, idx, split+1, end, level+1, order, posRight);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp taskwait
+#endif
+    }else{
+        fillBalancedOrder(points, idx, begin, split, level+1, order, posLeft);
+        fillBalancedOrder(points, idx, split+1, end, level+1, order, posRight);
+    }
+}
+
+/*!
+ * Squared distance between two points.
+ * \param[in] a first point
+ * \param[in] b second point
+ * \return squared distance
+ */
+inline double squaredDistance(const std::array<double,3> & a, const std::array<double,3> & b){
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return dx*dx + dy*dy + dz*dz;
+}
+
+} //end anonymous namespace
+
+/*!
+ * Compute an insertion order of a list of points which makes a KdTree balanced.
+ * Points are recursively split at the median along the direction of the tree level
+ * (x, y, z cyclically), and the median of each sub-range precedes its two halves in the order.
+ * Inserting the points in this order, the nodes of the tree are stored in depth-first order, so that
+ * subtrees are contiguous in memory. If the coordinates along each splitting direction are distinct,
+ * the tree has minimum depth. Points with equal coordinates (e.g. structured grids) are kept on the
+ * lower side of the split, as bitpit::KdTree does on insertion, moving the split to the end of their run:
+ * halves are then unbalanced by at most the run size and the tree can be a few levels deeper.
+ * Sub-ranges are sorted concurrently by OpenMP tasks, if enabled; the insertion of the points
+ * in the tree is up to the caller.
+ * \param[in] points list of point coordinates
+ * \return list of indices of the points in insertion order
+ */
+std::vector<std::size_t> balancedInsertionOrder(const std::vector<std::array<double,3> > & points)
+{
+    std::size_t nP = points.size();
+    std::vector<std::size_t> idx(nP);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::vector<std::size_t> order(nP);
+    if (nP == 0) return order;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif
+    fillBalancedOrder(points.data(), idx.data(), 0, nP, 0, order.data(), 0);
+
+    return order;
+}
+
+/*!
+ * Check if the nodes of a KdTree are still correctly ordered, i.e. if each node lies on the
+ * proper side of the splitting planes of all its ancestors. It is meant to verify a tree after its
+ * vertices have been moved without changing the tree hierarchy: if the ordering holds, the tree
+ * is still valid for searching and it does not need to be rebuilt.
+ * The hierarchy is visited level by level in O(n), each level being processed concurrently
+ * if OpenMP is enabled.
+ * \param[in] tree pointer to the vertex KdTree.
+ * \return true if the tree is correctly ordered
+ */
+bool checkOrdering(bitpit::KdTree<3, bitpit::Vertex, long> *tree)
+{
+    if(!tree){
+        throw std::runtime_error("Invalid use of kdTreeUtils::checkOrdering method: a void tree is detected.");
+    }
+    if (tree->n_nodes == 0) return true;
+
+    //bounds allowed to each node by the splitting planes of its ancestors
+    std::vector<std::array<double,3> > lower(tree->n_nodes, std::array<double,3>({{-1.0e+18, -1.0e+18, -1.0e+18}}));
+    std::vector<std::array<double,3> > upper(tree->n_nodes, std::array<double,3>({{1.0e+18, 1.0e+18, 1.0e+18}}));
+
+    std::vector<int> level(1, 0);
+    std::vector<int> nextLevel;
+    int depth = 0;
+    bool ordered = true;
+    while(!level.empty() && ordered){
+        int dir = depth%3;
+        int nLevel = int(level.size());
+        nextLevel.assign(2*level.size(), -1);
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for reduction(&&:ordered)
+#endif
+        for (int j=0; j<nLevel; ++j){
+            int id = level[j];
+            const bitpit::KdNode<bitpit::Vertex, long> & node = tree->nodes[id];
+            const std::array<double,3> & coords = node.object_->getCoords();
+            for (int d=0; d<3; ++d){
+                ordered = ordered && (coords[d] >= lower[id][d]) && (coords[d] <= upper[id][d]);
+            }
+            if (node.lchild_ >= 0){
+                lower[node.lchild_] = lower[id];
+                upper[node.lchild_] = upper[id];
+                upper[node.lchild_][dir] = coords[dir];
+                nextLevel[2*j] = node.lchild_;
+            }
+            if (node.rchild_ >= 0){
+                lower[node.rchild_] = lower[id];
+                upper[node.rchild_] = upper[id];
+                lower[node.rchild_][dir] = coords[dir];
+                nextLevel[2*j+1] = node.rchild_;
+            }
+        }
+
+        level.clear();
+        for (int id : nextLevel){
+            if (id >= 0) level.push_back(id);
+        }
+        ++depth;
+    }
+    return ordered;
+}
+
+/*!
+ * Batched search of the k nearest vertices of a list of points in a vertex KdTree.
+ * The tree is visited depth-first, entering first the child on the same side of the
+ * splitting plane of the query point, and pruning the subtrees farther than the current
+ * k-th neighbour. Points are processed concurrently if OpenMP is enabled.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] tree pointer to the vertex KdTree.
+ * \param[in] k number of neighbours requested for each point.
+ * \param[out] labels pointer to the first of nP*k labels of the neighbours, sorted by increasing distance
+ * for each point (bitpit::Vertex::NULL_ID if less than k vertices are available).
+ * \param[out] distances pointer to the first of nP*k distances of the neighbours (1.0e+18 if not found).
+ */
+void kNearest(int nP, const std::array<double,3> *P_, bitpit::KdTree<3, bitpit::Vertex, long> *tree, int k, long *labels, double *distances)
+{
+    if(!tree){
+        throw std::runtime_error("Invalid use of kdTreeUtils::kNearest method: a void tree is detected.");
+    }
+    if(k <= 0) return;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i=0; i<nP; ++i){
+        long * lab = labels + std::size_t(i)*k;
+        double * dist = distances + std::size_t(i)*k;
+        std::fill(lab, lab + k, bitpit::Vertex::NULL_ID);
+        std::fill(dist, dist + k, 1.0e+18);
+        if (tree->n_nodes == 0) continue;
+
+        const std::array<double,3> & point = P_[i];
+        int nfound = 0;
+        std::vector<KdStackEntry> stack;
+        stack.push_back(KdStackEntry{0, 0, 0.});
+
+        while(!stack.empty()){
+            KdStackEntry entry = stack.back();
+            stack.pop_back();
+            //dist stores squared distances during the search
+            if (nfound == k && entry.bound >= dist[k-1]) continue;
+
+            const bitpit::KdNode<bitpit::Vertex, long> & node = tree->nodes[entry.node];
+            const std::array<double,3> & coords = node.object_->getCoords();
+            double d2 = squaredDistance(point, coords);
+            if (nfound < k || d2 < dist[k-1]){
+                int pos = std::min(nfound, k-1);
+                while (pos > 0 && dist[pos-1] > d2){
+                    dist[pos] = dist[pos-1];
+                    lab[pos] = lab[pos-1];
+                    --pos;
+                }
+                dist[pos] = d2;
+                lab[pos] = node.label;
+                nfound = std::min(nfound+1, k);
+            }
+
+            int dir = entry.level%3;
+            double diff = point[dir] - coords[dir];
+            int nearChild = (diff <= 0.) ? node.lchild_ : node.rchild_;
+            int farChild  = (diff <= 0.) ? node.rchild_ : node.lchild_;
+            if (farChild >= 0){
+                stack.push_back(KdStackEntry{farChild, entry.level+1, std::max(entry.bound, diff*diff)});
+            }
+            if (nearChild >= 0){
+                stack.push_back(KdStackEntry{nearChild, entry.level+1, entry.bound});
+            }
+        }
+
+        for (int j=0; j<nfound; ++j){
+            dist[j] = std::sqrt(dist[j]);
+        }
+    }
+}
+
+/*!
+ * Batched search of the vertices of a KdTree lying within a given distance from a list of points.
+ * Subtrees whose splitting planes are farther than the radius are pruned.
+ * Points are processed concurrently if OpenMP is enabled.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] tree pointer to the vertex KdTree.
+ * \param[in] r search radius.
+ * \param[out] result labels of the vertices found for each point (resized to nP).
+ */
+void radiusSearch(int nP, const std::array<double,3> *P_, bitpit::KdTree<3, bitpit::Vertex, long> *tree, double r, livector2D & result)
+{
+    if(!tree){
+        throw std::runtime_error("Invalid use of kdTreeUtils::radiusSearch method: a void tree is detected.");
+    }
+    result.clear();
+    result.resize(std::max(nP, 0));
+    if (tree->n_nodes == 0 || r < 0.) return;
+    double r2 = r*r;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i=0; i<nP; ++i){
+        const std::array<double,3> & point = P_[i];
+        std::vector<std::pair<int,int> > stack;
+        stack.push_back(std::make_pair(0, 0));
+
+        while(!stack.empty()){
+            std::pair<int,int> entry = stack.back();
+            stack.pop_back();
+
+            const bitpit::KdNode<bitpit::Vertex, long> & node = tree->nodes[entry.first];
+            const std::array<double,3> & coords = node.object_->getCoords();
+            if (squaredDistance(point, coords) <= r2){
+                result[i].push_back(node.label);
+            }
+
+            double diff = point[entry.second%3] - coords[entry.second%3];
+            if (node.lchild_ >= 0 && diff <= r){
+                stack.push_back(std::make_pair(node.lchild_, entry.second+1));
+            }
+            if (node.rchild_ >= 0 && diff >= -r){
+                stack.push_back(std::make_pair(node.rchild_, entry.second+1));
+            }
+        }
+    }
+}
+
+} //end namespace kdTreeUtils
+
+} //end namespace mimmo
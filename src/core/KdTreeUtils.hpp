@@ -0,0 +1,49 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+\*---------------------------------------------------------------------------*/
+# ifndef __KDTREEUTILS_HPP__
+# define __KDTREEUTILS_HPP__
+
+# include "mimmoTypeDef.hpp"
+# include <bitpit_patchkernel.hpp>
+# include <bitpit_SA.hpp>
+
+namespace mimmo{
+
+
+/*!
+ * \brief Utilities employing vertex KdTree.
+ * \ingroup core
+ */
+namespace kdTreeUtils{
+
+    std::vector<std::size_t> balancedInsertionOrder(const std::vector<std::array<double,3> > & points);
+    bool checkOrdering(bitpit::KdTree<3, bitpit::Vertex, long> *tree);
+
+    void kNearest(int nP, const std::array<double,3> *P_, bitpit::KdTree<3, bitpit::Vertex, long> *tree, int k, long *labels, double *distances);
+    void radiusSearch(int nP, const std::array<double,3> *P_, bitpit::KdTree<3, bitpit::Vertex, long> *tree, double r, livector2D & result);
+}; //end namespace kdTreeUtils
+
+} //end namespace mimmo
+
+#endif
@@ -22,13 +22,16 @@
  *
 \*---------------------------------------------------------------------------*/
 #include "MimmoObject.hpp"
+#include "MimmoPiercedVector.hpp"
 #include "MimmoNamespace.hpp"
 #include "SkdTreeUtils.hpp"
+#include "KdTreeUtils.hpp"
 #if MIMMO_ENABLE_MPI
     #include "communications.hpp"
 #endif
 #include <Operators.hpp>
 #include <set>
+#include <algorithm>
 #include <cassert>
 
 namespace mimmo{
@@ -181,6 +184,8 @@ MimmoObject::MimmoObject(int type){
 	m_skdTreeSupported = (m_type != 3);
 	m_skdTreeSync = false;
 	m_kdTreeSync = false;
+	m_revision = 0;
+	m_kdTreeRevalidable = false;
 	m_AdjBuilt = false;
 	m_IntBuilt = false;
 #if MIMMO_ENABLE_MPI
@@ -193,6 +198,7 @@ MimmoObject::MimmoObject(int type){
 	m_patchInfo.update();
 	m_infoSync = true;
 	m_pointConnectivitySync = false;
+	m_coordinatesSoASync = false;
 }
 
 /*!
@@ -272,6 +278,8 @@ MimmoObject::MimmoObject(int type, dvecarr3E & vertex, livector2D * connectivity
 	m_skdTreeSupported = (m_type != 3);
 	m_skdTreeSync = false;
 	m_kdTreeSync = false;
+	m_revision = 0;
+	m_kdTreeRevalidable = false;
 	m_AdjBuilt = false;
 	m_IntBuilt = false;
 
@@ -316,6 +324,7 @@ MimmoObject::MimmoObject(int type, dvecarr3E & vertex, livector2D * connectivity
 	m_patchInfo.update();
 	m_infoSync = true;
 	m_pointConnectivitySync = false;
+	m_coordinatesSoASync = false;
 };
 
 /*!
@@ -414,6 +423,8 @@ MimmoObject::MimmoObject(int type, bitpit::PatchKernel* geometry){
 	m_skdTreeSupported = (m_type != 3);
 	m_skdTreeSync = false;
 	m_kdTreeSync = false;
+	m_revision = 0;
+	m_kdTreeRevalidable = false;
 
     m_AdjBuilt = geometry->getAdjacenciesBuildStrategy() != bitpit::PatchKernel::AdjacenciesBuildStrategy::ADJACENCIES_NONE;
 	m_IntBuilt = geometry->getInterfacesBuildStrategy() != bitpit::PatchKernel::InterfacesBuildStrategy::INTERFACES_NONE;
@@ -435,6 +446,7 @@ MimmoObject::MimmoObject(int type, bitpit::PatchKernel* geometry){
 	m_patchInfo.update();
 	m_infoSync = true;
 	m_pointConnectivitySync = false;
+	m_coordinatesSoASync = false;
 }
 
 /*!
@@ -535,6 +547,8 @@ MimmoObject::MimmoObject(int type, std::unique_ptr<bitpit::PatchKernel> & geomet
 	m_skdTreeSupported = (m_type != 3);
 	m_skdTreeSync = false;
 	m_kdTreeSync = false;
+	m_revision = 0;
+	m_kdTreeRevalidable = false;
 
 	//check if adjacencies and interfaces are built.(Patch called it BuildStrategy -- NONE is unbuilt)
     m_AdjBuilt = m_patch->getAdjacenciesBuildStrategy() != bitpit::PatchKernel::AdjacenciesBuildStrategy::ADJACENCIES_NONE;
@@ -557,6 +571,7 @@ MimmoObject::MimmoObject(int type, std::unique_ptr<bitpit::PatchKernel> & geomet
 	m_patchInfo.update();
 	m_infoSync = true;
 	m_pointConnectivitySync = false;
+	m_coordinatesSoASync = false;
 }
 
 /*!
@@ -564,6 +579,29 @@ MimmoObject::MimmoObject(int type, std::unique_ptr<bitpit::PatchKernel> & geomet
  */
 MimmoObject::~MimmoObject(){};
 
+/*!
+ * Constructor. Messages of the geometry are redirected to the target logger.
+ * \param[in] geometry target geometry, if NULL doing nothing
+ * \param[in] logger logger receiving the messages of the geometry
+ */
+MimmoObject::ScopedLoggerRedirection::ScopedLoggerRedirection(MimmoObject * geometry, bitpit::Logger * logger){
+    m_geometry = geometry;
+    m_original = NULL;
+    if (m_geometry != NULL){
+        m_original = m_geometry->m_log;
+        m_geometry->m_log = logger;
+    }
+}
+
+/*!
+ * Destructor. The original logger of the geometry is restored.
+ */
+MimmoObject::ScopedLoggerRedirection::~ScopedLoggerRedirection(){
+    if (m_geometry != NULL){
+        m_geometry->m_log = m_original;
+    }
+}
+
 /*!
  * Copy constructor of MimmoObject.
  * Internal allocated PatchKernel is copied from the argument object as a soft link
@@ -591,6 +629,8 @@ MimmoObject::MimmoObject(const MimmoObject & other){
 
 	m_skdTreeSync    = false;
 	m_kdTreeSync    = false;
+	m_revision = 0;
+	m_kdTreeRevalidable = false;
 
 	//instantiate empty trees:
 	switch(m_type){
@@ -626,6 +666,7 @@ MimmoObject::MimmoObject(const MimmoObject & other){
 #endif
 
 	m_pointConnectivitySync = false;
+	m_coordinatesSoASync = false;
 };
 
 /*!
@@ -660,6 +701,9 @@ void MimmoObject::swap(MimmoObject & x) noexcept
 	std::swap(m_kdTree, x.m_kdTree);
 	std::swap(m_skdTreeSync, x.m_skdTreeSync);
 	std::swap(m_kdTreeSync, x.m_kdTreeSync);
+	m_revision = std::max(m_revision, x.m_revision) + 1;
+	x.m_revision = m_revision;
+	std::swap(m_kdTreeRevalidable, x.m_kdTreeRevalidable);
 	std::swap(m_infoSync, x.m_infoSync);
 #if MIMMO_ENABLE_MPI
 	std::swap(m_communicator, x.m_communicator);
@@ -669,6 +713,7 @@ void MimmoObject::swap(MimmoObject & x) noexcept
 	m_pointGhostExchangeInfoSync = false;
 #endif
 	m_pointConnectivitySync = false; //point connectivity is not copied
+	m_coordinatesSoASync = false; //coordinates snapshot is not copied
 }
 
 
@@ -1301,6 +1346,18 @@ MimmoObject::isKdTreeSync(){
     return m_kdTreeSync;
 }
 
+/*!
+ * Return the geometry revision counter. It is incremented each time vertices or cells
+ * are added, modified, displaced or removed through the MimmoObject interface, so that
+ * data evaluated on the geometry can be checked against later modifications.
+ * Changes made directly on the linked bitpit::PatchKernel are not tracked.
+ * \return current geometry revision
+ */
+long
+MimmoObject::getRevision() const{
+    return m_revision;
+}
+
 /*!
  * \return pointer to geometry KdTree internal structure
  */
@@ -1927,6 +1984,7 @@ void MimmoObject::deleteOrphanGhostCells(){
     //clean marked ghosts;
     if(!markToDelete.empty()){
         getPatch()->deleteCells(markToDelete);
+        ++m_revision;
     }
     //erase temporarely adjacencies
     if(checkResetAdjacencies){
@@ -1964,12 +2022,15 @@ MimmoObject::addVertex(const darray3E & vertex, const long idtag){
 	}
 
 	m_skdTreeSync = false;
+	++m_revision;
 	m_kdTreeSync = false;
+	m_kdTreeRevalidable = false;
 	m_infoSync = false;
 #if MIMMO_ENABLE_MPI
 	m_pointGhostExchangeInfoSync = false;
 #endif
     m_pointConnectivitySync = false;
+    m_coordinatesSoASync = false;
 	return true;
 };
 
@@ -1998,12 +2059,15 @@ MimmoObject::addVertex(const bitpit::Vertex & vertex, const long idtag){
 	}
 
 	m_skdTreeSync = false;
+	++m_revision;
 	m_kdTreeSync = false;
+	m_kdTreeRevalidable = false;
 	m_infoSync = false;
 #if MIMMO_ENABLE_MPI
 	m_pointGhostExchangeInfoSync = false;
 #endif
     m_pointConnectivitySync = false;
+    m_coordinatesSoASync = false;
 	return true;
 };
 
@@ -2021,8 +2085,11 @@ MimmoObject::modifyVertex(const darray3E & vertex, const long & id){
 	bitpit::Vertex &vert = getPatch()->getVertex(id);
 	vert.setCoords(vertex);
 	m_skdTreeSync = false;
+	++m_revision;
+	m_kdTreeRevalidable = m_kdTreeRevalidable || m_kdTreeSync;
 	m_kdTreeSync = false;
 	m_infoSync = false;
+	m_coordinatesSoASync = false;
 #if MIMMO_ENABLE_MPI
 	m_pointGhostExchangeInfoSync = false;
 #endif
@@ -2030,6 +2097,120 @@ MimmoObject::modifyVertex(const darray3E & vertex, const long & id){
 };
 
 
+/*!
+ * Modify the coordinates of a list of vertices of the geometry in one pass.
+ * Vertices are updated concurrently if OpenMP is enabled, and the synchronization
+ * status of the geometry is reset once. Since the topology is untouched, the vertex kdTree
+ * is marked for revalidation: on the next build its hierarchy is kept if the moved vertices
+ * still satisfy its ordering (see revalidateKdTree), otherwise it is rebuilt from scratch.
+ * \param[in] vertices new coordinates of the vertices
+ * \param[in] ids labels of the vertices to modify, same size of vertices
+ * \return false if the sizes do not match or if any of the ids is not in the geometry (existent ones are modified anyway)
+ */
+bool
+MimmoObject::modifyVertices(const dvecarr3E & vertices, const livector1D & ids){
+
+	if(vertices.size() != ids.size()) return false;
+
+	bitpit::PiercedVector<bitpit::Vertex> & verts = getVertices();
+	long nV = long(ids.size());
+	bool check = true;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for reduction(&&:check)
+#endif
+	for(long i=0; i<nV; ++i){
+		if(!verts.exists(ids[i])){
+			check = false;
+			continue;
+		}
+		verts.rawAt(verts.getRawIndex(ids[i])).setCoords(vertices[i]);
+	}
+
+	if(nV > 0){
+		m_skdTreeSync = false;
+		++m_revision;
+		m_kdTreeRevalidable = m_kdTreeRevalidable || m_kdTreeSync;
+		m_kdTreeSync = false;
+		m_infoSync = false;
+		m_coordinatesSoASync = false;
+#if MIMMO_ENABLE_MPI
+		m_pointGhostExchangeInfoSync = false;
+#endif
+	}
+	return check;
+};
+
+/*!
+ * Displace all the vertices of the geometry by a field of displacements, in one pass.
+ * The raw positions of the displacements in their storage are matched to the vertices
+ * walking the two containers together: when the field is aligned with the vertex storage
+ * (e.g. it is filled following the geometry vertices order) no id lookup is needed.
+ * Vertices are then updated concurrently if OpenMP is enabled, and the synchronization
+ * status of the geometry is reset once (the vertex kdTree is marked for revalidation, see modifyVertices).
+ * Vertices with no displacement in the field are left untouched.
+ * \param[in] displacements displacement field, referred to vertex ids
+ * \param[in] factor scaling factor of the displacements
+ * \return false if any of the displacement ids is not in the geometry (existent ones are displaced anyway)
+ */
+bool
+MimmoObject::displaceVertices(const MimmoPiercedVector<darray3E> & displacements, double factor){
+
+	bitpit::PiercedVector<bitpit::Vertex> & verts = getVertices();
+	std::size_t nV = verts.size();
+	if(displacements.empty()) return true;
+	if(nV == 0) return false;
+
+	//raw positions of each vertex and of its displacement (-1 if missing)
+	std::vector<std::size_t> vertRaw;
+	std::vector<long> dispRaw;
+	vertRaw.reserve(nV);
+	dispRaw.reserve(nV);
+	std::size_t nMatched = 0;
+	auto itD = displacements.cbegin();
+	auto itDEnd = displacements.cend();
+	for(auto it = verts.begin(); it != verts.end(); ++it){
+		long id = it.getId();
+		vertRaw.push_back(it.getRawIndex());
+		if(itD != itDEnd && itD.getId() == id){
+			dispRaw.push_back(long(itD.getRawIndex()));
+			++itD;
+			++nMatched;
+		}else if(displacements.exists(id)){
+			dispRaw.push_back(long(displacements.getRawIndex(id)));
+			++nMatched;
+		}else{
+			dispRaw.push_back(-1);
+		}
+	}
+
+	long nLoop = long(nV);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+	for(long i=0; i<nLoop; ++i){
+		if(dispRaw[i] < 0) continue;
+		bitpit::Vertex & vertex = verts.rawAt(vertRaw[i]);
+		const darray3E & disp = displacements.rawAt(std::size_t(dispRaw[i]));
+		darray3E coords = vertex.getCoords();
+		for(int j=0; j<3; ++j){
+			coords[j] += factor*disp[j];
+		}
+		vertex.setCoords(coords);
+	}
+
+	m_skdTreeSync = false;
+	++m_revision;
+	m_kdTreeRevalidable = m_kdTreeRevalidable || m_kdTreeSync;
+	m_kdTreeSync = false;
+	m_infoSync = false;
+	m_coordinatesSoASync = false;
+#if MIMMO_ENABLE_MPI
+	m_pointGhostExchangeInfoSync = false;
+#endif
+	return (nMatched == displacements.size());
+};
+
 /*!
  * See method addConnectedCell(const livector1D & conn, bitpit::ElementType type, long PID, long idtag, int rank) doxy.
  * The only difference is the automatic assignment to PID= 0 for the current element and the automatic assignment of ID.
@@ -2100,6 +2281,7 @@ MimmoObject::addConnectedCell(const livector1D & conn, bitpit::ElementType type,
 	setPIDCell(checkedID, PID);
 
 	m_skdTreeSync = false;
+	++m_revision;
 	m_AdjBuilt = false;
 	m_IntBuilt = false;
 	m_infoSync = false;
@@ -2167,7 +2349,9 @@ MimmoObject::addCell(bitpit::Cell & cell, const long idtag, int rank){
     setPIDCell(checkedID, cell.getPID());
 
     m_skdTreeSync = false;
+    ++m_revision;
     m_kdTreeSync = false;
+    m_kdTreeRevalidable = false;
 	m_infoSync = false;
     m_AdjBuilt = false;
     m_IntBuilt = false;
@@ -2337,7 +2521,10 @@ MimmoObject::cleanGeometry(){
 	if(m_skdTreeSupported)  patch->deleteOrphanVertices();
 
 	m_kdTreeSync = false;
+	++m_revision;
+	m_kdTreeRevalidable = false;
 	m_infoSync = false;
+	m_coordinatesSoASync = false;
 #if MIMMO_ENABLE_MPI
 	m_pointGhostExchangeInfoSync = false;
 #endif
@@ -2779,6 +2966,9 @@ void MimmoObject::getBoundingBox(std::array<double,3> & pmin, std::array<double,
 /*!
  * Reset and build again cell skdTree of your geometry (if supports connectivity elements).
  * Ghost cells are insert in the tree.
+ * The tree is always rebuilt from scratch once out of sync, vertex displacements included:
+ * the bounding boxes of bitpit::SkdNode are not accessible from outside bitpit, so they
+ * cannot be refitted in place here.
  *\param[in] value build the minimum leaf of the tree as a bounding box containing value elements at most.
  */
 void MimmoObject::buildSkdTree(int value){
@@ -2795,25 +2985,80 @@ void MimmoObject::buildSkdTree(int value){
 /*!
  * Reset and build again vertex kdTree of your geometry.
  * Nodes fo ghost cells are insert in the tree.
+ * Vertices are inserted in the balanced order provided by kdTreeUtils::balancedInsertionOrder
+ * (median split along x,y,z cyclically, computed in parallel if OpenMP is enabled), so that the
+ * tree is balanced and its nodes are stored depth-first, whatever the vertex numbering (depth is
+ * minimum for distinct coordinates, a few levels more on structured grids, see balancedInsertionOrder).
+ * The insertion itself is serial, as required by bitpit::KdTree: each vertex walks down a balanced
+ * tree, so the build costs O(n log n) whatever the input ordering.
+ * If the tree is out of sync only because of vertex displacements, its current hierarchy is
+ * kept when still valid (see revalidateKdTree).
  */
 void MimmoObject::buildKdTree(){
 	if( getNVertices() == 0)  return;
-	long label;
 
 	if (!m_kdTreeSync){
+		if(revalidateKdTree())   return;
 		cleanKdTree();
 		//TODO Why : + m_kdTree->MAXSTK ?
 		m_kdTree->nodes.resize(getNVertices() + m_kdTree->MAXSTK);
 
-		for(auto & val : getVertices()){
-			label = val.getId();
-			m_kdTree->insert(&val, label);
+		bitpit::PiercedVector<bitpit::Vertex> & vertices = getVertices();
+		std::vector<bitpit::Vertex*> vptr;
+		std::vector<std::array<double,3> > coords;
+		vptr.reserve(vertices.size());
+		coords.reserve(vertices.size());
+		for(auto & val : vertices){
+			vptr.push_back(&val);
+			coords.push_back(val.getCoords());
+		}
+
+		std::vector<std::size_t> order = kdTreeUtils::balancedInsertionOrder(coords);
+		long label;
+		for(std::size_t i : order){
+			label = vptr[i]->getId();
+			m_kdTree->insert(vptr[i], label);
 		}
 		m_kdTreeSync = true;
 	}
 	return;
 }
 
+/*!
+ * Check if the vertex kdTree is still valid after its vertices have been moved, so that it
+ * can be marked as synchronized again without rebuilding it.
+ * This is a validation only: nodes and splitting planes are never modified, i.e. the tree is
+ * not refitted nor rebalanced. The check is attempted only if the tree went out of sync by vertex
+ * displacements alone (modifyVertex, modifyVertices, displaceVertices). Nodes are checked to still
+ * reference the geometry vertices, and their ordering with respect to the splitting planes is
+ * verified in O(n) by kdTreeUtils::checkOrdering.
+ * Rigid translations, as well as small deformations, typically preserve the ordering; any other
+ * change requires a full rebuild. The cell skdTree is not involved and is always rebuilt.
+ * \return true if the tree is valid and synchronized again, false if a full rebuild is needed.
+ */
+bool MimmoObject::revalidateKdTree(){
+	if(m_kdTreeSync)            return true;
+	if(!m_kdTreeRevalidable)     return false;
+	m_kdTreeRevalidable = false;
+
+	bitpit::PiercedVector<bitpit::Vertex> & vertices = getVertices();
+	long nNodes = long(m_kdTree->n_nodes);
+	if(nNodes != long(vertices.size()))  return false;
+
+	bool valid = true;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for reduction(&&:valid)
+#endif
+	for(long i=0; i<nNodes; ++i){
+		const bitpit::KdNode<bitpit::Vertex, long> & node = m_kdTree->nodes[i];
+		valid = valid && vertices.exists(node.label) && (&(vertices.at(node.label)) == node.object_);
+	}
+	if(!valid)  return false;
+
+	m_kdTreeSync = kdTreeUtils::checkOrdering(m_kdTree.get());
+	return m_kdTreeSync;
+}
+
 /*!
  * Clean the KdTree of the class
  */
@@ -2821,6 +3066,7 @@ void	MimmoObject::cleanKdTree(){
 	m_kdTree->n_nodes = 0;
 	m_kdTree->nodes.clear();
     m_kdTreeSync = false;
+    m_kdTreeRevalidable = false;
 }
 
 /*!
@@ -3019,13 +3265,16 @@ void MimmoObject::resetPatch(){
 	m_AdjBuilt = false;
 	m_IntBuilt = false;
 	m_skdTreeSync = false;
+	++m_revision;
 	m_kdTreeSync = false;
+	m_kdTreeRevalidable = false;
  	m_patchInfo.reset();
  	m_infoSync = false;
 #if MIMMO_ENABLE_MPI
 	m_pointGhostExchangeInfoSync = false;
 #endif
     m_pointConnectivitySync = false;
+    m_coordinatesSoASync = false;
 };
 
 /*!
@@ -3122,7 +3371,9 @@ void MimmoObject::reset(int type){
 
 	m_skdTreeSupported = (m_type != 3);
 	m_skdTreeSync = false;
+	++m_revision;
 	m_kdTreeSync = false;
+	m_kdTreeRevalidable = false;
 	m_AdjBuilt = false;
 	m_IntBuilt = false;
 #if MIMMO_ENABLE_MPI
@@ -3131,6 +3382,7 @@ void MimmoObject::reset(int type){
 	m_patchInfo.setPatch(m_patch.get());
 	m_infoSync = false;
     m_pointConnectivitySync = false;
+    m_coordinatesSoASync = false;
 }
 
 /*!
@@ -3709,65 +3961,129 @@ double MimmoObject::evalInterfaceArea(const long & id){
 
 /*!
   Build the Node-Node connectivity of the tessellated mesh,(nodes connected by edges)
-  and store it internally.
+  and store it internally in compressed sparse row format: the 1-Ring neighbours of
+  each vertex are stored contiguously, ordered by id, and addressed by the vertex raw index.
+  Edges are collected and sorted in parallel, if OpenMP is enabled.
  */
 void
 MimmoObject::buildPointConnectivity()
 {
-	m_pointConnectivity.clear();
-	m_pointConnectivity.reserve(getNVertices());
-//	std::set<long> visited;
+	cleanPointConnectivity();
+
+	bitpit::PiercedVector<bitpit::Vertex> & vertices = getVertices();
+	std::size_t nraw = 0;
+	for (auto it = vertices.begin(); it != vertices.end(); ++it){
+		nraw = std::max(nraw, std::size_t(it.getRawIndex()) + 1);
+	}
+
+	std::vector<const bitpit::Cell*> cells;
+	cells.reserve(getNCells());
+	for (bitpit::Cell & cell : getCells()){
+		cells.push_back(&cell);
+	}
+	long ncells = long(cells.size());
 
 	//ONLY EDGE CONNECTIVITY
-    std::set<std::pair<long,long> > edges;
-    for (bitpit::Cell & cell : getCells()){
-    	int ne = 0;
-    	if (m_type == 1)
-    		ne = cell.getFaceCount();
-    	if (m_type == 2)
-    		ne = cell.getEdgeCount();
-
-    	for (int i=0; i<ne; i++){
-    		bitpit::ConstProxyVector<long> ids;
-        	if (m_type == 1)
-        		ids = cell.getFaceVertexIds(i);
-        	if (m_type == 2)
-        		ids = cell.getEdgeVertexIds(i);
-    		//Always two nodes!?! I think yes...
-    		long id1 = ids[0];
-    		long id2 = ids[1];
-    		std::pair<long,long> item;
-    		if (id1<id2)
-    			item=std::pair<long,long>(id1,id2);
-    		else
-    			item = std::pair<long,long>(id2,id1);
-    		if (!edges.count(item)){
-    			edges.insert(item);
-    			m_pointConnectivity[id1].insert(id2);
-    			m_pointConnectivity[id2].insert(id1);
-    		}
-    	}
-    }
+	//count the edge ends of each vertex (edges shared by cells are counted more times).
+	std::vector<std::size_t> count(nraw + 1, 0);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long icell = 0; icell < ncells; ++icell){
+		const bitpit::Cell & cell = *cells[icell];
+		int ne = 0;
+		if (m_type == 1)
+			ne = cell.getFaceCount();
+		if (m_type == 2)
+			ne = cell.getEdgeCount();
+		for (int i=0; i<ne; i++){
+			bitpit::ConstProxyVector<long> ids;
+			if (m_type == 1)
+				ids = cell.getFaceVertexIds(i);
+			if (m_type == 2)
+				ids = cell.getEdgeVertexIds(i);
+			std::size_t raw1 = vertices.getRawIndex(ids[0]);
+			std::size_t raw2 = vertices.getRawIndex(ids[1]);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic
+#endif
+			count[raw1 + 1]++;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic
+#endif
+			count[raw2 + 1]++;
+		}
+	}
+	for (std::size_t i = 0; i < nraw; ++i){
+		count[i + 1] += count[i];
+	}
 
-//
-//	//ONE RING CELL CONNECTIVITY
-//	for (bitpit::Cell & cell : getCells()){
-//		long idcell = cell.getId();
-//		int nv = cell.getVertexCount();
-//		for (int iv=0; iv<nv; iv++){
-//			long id = cell.getVertexId(iv);
-//			if (!visited.count(id)){
-//				livector1D list = getPatch()->findCellVertexOneRing(idcell, iv);
-//				visited.insert(id);
-//				for(const auto & cellIndex : list){
-//			          bitpit::ConstProxyVector<long> ids = getPatch()->getCell(cellIndex).getVertexIds();
-//			          m_pointConnectivity[id].insert(ids.begin(), ids.end());
-//				}
-//				m_pointConnectivity[id].erase(id);
-//			}
-//		}
-//	}
-    m_pointConnectivitySync = true;
+	//fill the neighbours of each vertex, duplicates included.
+	std::vector<long> neighbours(count[nraw]);
+	std::vector<std::size_t> cursor(count.begin(), count.end() - 1);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long icell = 0; icell < ncells; ++icell){
+		const bitpit::Cell & cell = *cells[icell];
+		int ne = 0;
+		if (m_type == 1)
+			ne = cell.getFaceCount();
+		if (m_type == 2)
+			ne = cell.getEdgeCount();
+		for (int i=0; i<ne; i++){
+			bitpit::ConstProxyVector<long> ids;
+			if (m_type == 1)
+				ids = cell.getFaceVertexIds(i);
+			if (m_type == 2)
+				ids = cell.getEdgeVertexIds(i);
+			//Always two nodes!?! I think yes...
+			long id1 = ids[0];
+			long id2 = ids[1];
+			std::size_t raw1 = vertices.getRawIndex(id1);
+			std::size_t raw2 = vertices.getRawIndex(id2);
+			std::size_t pos1, pos2;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic capture
+#endif
+			pos1 = cursor[raw1]++;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic capture
+#endif
+			pos2 = cursor[raw2]++;
+			neighbours[pos1] = id2;
+			neighbours[pos2] = id1;
+		}
+	}
+	std::vector<std::size_t>().swap(cursor);
+
+	//sort and remove duplicates on each vertex row.
+	std::vector<std::size_t> offsets(nraw + 1, 0);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+	for (long raw = 0; raw < long(nraw); ++raw){
+		auto begin = neighbours.begin() + count[raw];
+		auto end = neighbours.begin() + count[raw + 1];
+		std::sort(begin, end);
+		offsets[raw + 1] = std::distance(begin, std::unique(begin, end));
+	}
+	for (std::size_t i = 0; i < nraw; ++i){
+		offsets[i + 1] += offsets[i];
+	}
+
+	//compact the rows in the final CSR structure.
+	m_pointConnectivity.resize(offsets[nraw]);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long raw = 0; raw < long(nraw); ++raw){
+		std::copy(neighbours.begin() + count[raw], neighbours.begin() + count[raw] + (offsets[raw + 1] - offsets[raw]),
+				m_pointConnectivity.begin() + offsets[raw]);
+	}
+	m_pointConnectivityOffsets.swap(offsets);
+
+	m_pointConnectivitySync = true;
 }
 
 /*!
@@ -3776,20 +4092,25 @@ MimmoObject::buildPointConnectivity()
 void
 MimmoObject::cleanPointConnectivity()
 {
-	std::unordered_map<long, std::unordered_set<long> >().swap(m_pointConnectivity);
-    m_pointConnectivitySync = false;
+	std::vector<std::size_t>().swap(m_pointConnectivityOffsets);
+	std::vector<long>().swap(m_pointConnectivity);
+	m_pointConnectivitySync = false;
 }
 
 /*!
-    Get the connectivity of a target node/vertex
+    Get the connectivity of a target node/vertex, as a view on the internal
+    compressed connectivity structure (no copy is performed). The view is valid
+    until the point connectivity is rebuilt or cleaned.
     \param[in] id of target node
-    \return connectivity nodes list of id-target.
+    \return connectivity nodes list of id-target, ordered by id.
  */
-std::unordered_set<long> &
+bitpit::ConstProxyVector<long>
 MimmoObject::getPointConnectivity(const long & id)
 {
-	assert(m_pointConnectivity.count(id) > 0 && "MimmoObject::not valid id in getPointConnectivity call");
-	return m_pointConnectivity[id];
+	std::size_t raw = getVertices().getRawIndex(id);
+	assert(raw + 1 < m_pointConnectivityOffsets.size() && "MimmoObject::not valid id in getPointConnectivity call");
+	std::size_t begin = m_pointConnectivityOffsets[raw];
+	return bitpit::ConstProxyVector<long>(m_pointConnectivity.data() + begin, m_pointConnectivityOffsets[raw + 1] - begin);
 }
 
 /*!
@@ -3800,6 +4121,63 @@ MimmoObject::isPointConnectivitySync(){
 	return m_pointConnectivitySync;
 }
 
+/*!
+    Get a contiguous structure-of-arrays snapshot of the vertex coordinates, meant
+    for hot loops and vectorized kernels. The snapshot is built on first request
+    and kept until the geometry is modified through MimmoObject methods (addVertex,
+    modifyVertex, cleanGeometry, ...): in that case it is rebuilt on the next request.
+    Coordinates modified directly on the bitpit patch are not tracked: call
+    cleanVertexCoordinatesSoA to force an update.
+    The method is not thread safe, call it outside parallel regions.
+    \return reference to the coordinates snapshot.
+ */
+const VertexCoordinatesSoA &
+MimmoObject::getVertexCoordinatesSoA()
+{
+	if (m_coordinatesSoASync)   return m_coordinatesSoA;
+
+	bitpit::PiercedVector<bitpit::Vertex> & vertices = getVertices();
+	std::size_t nV = vertices.size();
+
+	m_coordinatesSoA.ids.resize(nV);
+	m_coordinatesSoA.x.resize(nV);
+	m_coordinatesSoA.y.resize(nV);
+	m_coordinatesSoA.z.resize(nV);
+	m_coordinatesSoA.index.clear();
+	m_coordinatesSoA.index.reserve(nV);
+	std::size_t i = 0;
+	for (auto it = vertices.begin(); it != vertices.end(); ++it){
+		const std::array<double,3> & coords = it->getCoords();
+		m_coordinatesSoA.ids[i] = it.getId();
+		m_coordinatesSoA.x[i] = coords[0];
+		m_coordinatesSoA.y[i] = coords[1];
+		m_coordinatesSoA.z[i] = coords[2];
+		m_coordinatesSoA.index[it.getId()] = i;
+		++i;
+	}
+
+	m_coordinatesSoASync = true;
+	return m_coordinatesSoA;
+}
+
+/*!
+    Clean the structure-of-arrays snapshot of the vertex coordinates.
+ */
+void
+MimmoObject::cleanVertexCoordinatesSoA()
+{
+	m_coordinatesSoA = VertexCoordinatesSoA();
+	m_coordinatesSoASync = false;
+}
+
+/*!
+    \return true if the structure-of-arrays snapshot of the vertex coordinates is built and up to date.
+*/
+bool
+MimmoObject::isVertexCoordinatesSoASync(){
+	return m_coordinatesSoASync;
+}
+
 /*!
  * Triangulate the linked geometry. It works only for surface geometries (type = 1).
  * After the method call the geometry (internal or linked) is forever modified.
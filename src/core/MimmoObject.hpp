@@ -97,6 +97,27 @@ protected:
 };
 
 
+template<typename mpv_t> class MimmoPiercedVector;
+
+/*!
+ * \ingroup core
+ * \brief Contiguous structure-of-arrays snapshot of the vertex coordinates of a MimmoObject.
+ *
+ * Coordinates are stored in dense arrays, following the vertex order of the geometry
+ * (holes of the bitpit PiercedVector are skipped). ids and index provide the
+ * index->id and id->index maps respectively.
+ */
+struct VertexCoordinatesSoA{
+    std::vector<double>                     x;      /**< x coordinates of vertices.*/
+    std::vector<double>                     y;      /**< y coordinates of vertices.*/
+    std::vector<double>                     z;      /**< z coordinates of vertices.*/
+    std::vector<long>                       ids;    /**< id of the vertex at each dense index.*/
+    std::unordered_map<long, std::size_t>   index;  /**< dense index of each vertex id.*/
+
+    /*! \return number of vertices in the snapshot.*/
+    std::size_t size() const { return ids.size(); }
+};
+
 /*!
 * \class MimmoObject
   \ingroup core
@@ -126,7 +147,9 @@ protected:
     std::unique_ptr<bitpit::KdTree<3,bitpit::Vertex,long> > m_kdTree;          /**< ordered tree of geometry vertices for fast searching purposes */
     bool                                                    m_skdTreeSync;     /**< track correct building of bvtree. Set false if any geometry modifications occur */
     bool                                                    m_kdTreeSync;      /**< track correct building of kdtree. Set false if any geometry modifications occur*/
+    bool                                                    m_kdTreeRevalidable;/**< track if kdtree is out of sync only for vertex displacements, i.e. its hierarchy can be checked and kept*/
     bool                                                    m_skdTreeSupported;/**< Flag for geometries not supporting skdTree building*/
+    long                                                    m_revision;        /**< geometry revision, incremented at each modification of vertices or cells */
 
     bool                                                    m_AdjBuilt;     /**< track correct building of adjacencies along with geometry modifications */
     bool                                                    m_IntBuilt;     /**< track correct building of interfaces  along with geometry modifications */
@@ -153,10 +176,32 @@ protected:
  	bitpit::PatchNumberingInfo	m_patchInfo;			/**< Patch Numbering Info structure for cells.*/
     bool                        m_infoSync;				/**< Track correct building of patch info along with geometry modifications */
 
-    std::unordered_map<long, std::unordered_set<long> >	m_pointConnectivity;		/**< Point-Point connectivity. 1-Ring neighbours of each vertex.*/
+    std::vector<std::size_t>                            m_pointConnectivityOffsets;	/**< Point-Point connectivity CSR offsets, indexed by vertex raw index.*/
+    std::vector<long>                                   m_pointConnectivity;		/**< Point-Point connectivity CSR list. 1-Ring neighbours of each vertex.*/
     bool                        						m_pointConnectivitySync;	/**< Track correct building of points connectivity along with geometry modifications */
 
+    VertexCoordinatesSoA                                m_coordinatesSoA;			/**< Structure-of-arrays snapshot of vertex coordinates.*/
+    bool                                                m_coordinatesSoASync;		/**< Track correct building of coordinates snapshot along with geometry modifications */
+
 public:
+    /*!
+     * \class ScopedLoggerRedirection
+     * \brief Redirect the messages of a MimmoObject to another logger, for the lifetime of the redirection.
+     * The original logger of the geometry is restored at destruction.
+     */
+    class ScopedLoggerRedirection{
+    public:
+        ScopedLoggerRedirection(MimmoObject * geometry, bitpit::Logger * logger);
+        ~ScopedLoggerRedirection();
+
+        ScopedLoggerRedirection(const ScopedLoggerRedirection &) = delete;
+        ScopedLoggerRedirection & operator=(const ScopedLoggerRedirection &) = delete;
+
+    private:
+        MimmoObject *       m_geometry;     /**< Redirected geometry, NULL if none.*/
+        bitpit::Logger *    m_original;     /**< Original logger of the geometry.*/
+    };
+
     MimmoObject(int type = 1);
     MimmoObject(int type, dvecarr3E & vertex, livector2D * connectivity = NULL);
     MimmoObject(int type, bitpit::PatchKernel* geometry);
@@ -204,6 +249,7 @@ public:
     bitpit::PatchNumberingInfo*                     getPatchInfo();
     bool                          isSkdTreeSync();
     bool                          isKdTreeSync();
+    long                          getRevision() const;
     bool                          isInfoSync();
 
     int getRank() const;
@@ -231,6 +277,8 @@ public:
     bool        addVertex(const darray3E & vertex, long idtag = bitpit::Vertex::NULL_ID);
     bool        addVertex(const bitpit::Vertex & vertex, long idtag = bitpit::Vertex::NULL_ID);
     bool        modifyVertex(const darray3E & vertex, const long & id);
+    bool        modifyVertices(const dvecarr3E & vertices, const livector1D & ids);
+    bool        displaceVertices(const MimmoPiercedVector<darray3E> & displacements, double factor = 1.0);
 
     bool        addConnectedCell(const livector1D & locConn, bitpit::ElementType type, int rank = -1);
     bool        addConnectedCell(const livector1D & locConn, bitpit::ElementType type, long idtag, int rank = -1);
@@ -271,6 +319,7 @@ public:
     void        getBoundingBox(std::array<double,3> & pmin, std::array<double,3> & pmax);
     void        buildSkdTree(int value = 1);
     void        buildKdTree();
+    bool        revalidateKdTree();
     void		buildPatchInfo();
 	void        buildAdjacencies();
     void        buildInterfaces();
@@ -315,9 +364,13 @@ public:
 
     void						buildPointConnectivity();
     void						cleanPointConnectivity();
-    std::unordered_set<long> &	getPointConnectivity(const long & id);
+    bitpit::ConstProxyVector<long>	getPointConnectivity(const long & id);
     bool						isPointConnectivitySync();
 
+    const VertexCoordinatesSoA &	getVertexCoordinatesSoA();
+    void						cleanVertexCoordinatesSoA();
+    bool						isVertexCoordinatesSoASync();
+
     void						triangulate();
 
 protected:
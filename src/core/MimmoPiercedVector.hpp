@@ -85,6 +85,7 @@ public:
     void                   setDataLocation(MPVLocation loc);
     void                   setDataLocation(int loc);
     void                   setData(std::vector<mpv_t> &rawdata);
+    void                   setData(const std::vector<long> & ids, const std::vector<mpv_t> & data);
 
     bool checkDataSizeCoherence();
     bool checkDataIdsCoherence();
@@ -286,6 +286,26 @@ MimmoPiercedVector<mpv_t>::setData(std::vector<mpv_t>& data){
 	}
 }
 
+/*!
+ * Set the data of the inner PiercedVector from a dense data compound, and the list of
+ * the ids each data refers to (e.g. VertexCoordinatesSoA::ids of the linked geometry).
+ * Data are inserted in the dense order on a clean container, so that the raw index
+ * of each element matches its dense index (rawAt(i) refers to data[i]).
+ * Geometry and location are not modified.
+ * \param[in] ids ids of the data, same size of data
+ * \param[in] data dense data to copy from
+ */
+template<typename mpv_t>
+void
+MimmoPiercedVector<mpv_t>::setData(const std::vector<long> & ids, const std::vector<mpv_t> & data){
+	bitpit::PiercedVector<mpv_t, long int>::clear();
+	std::size_t size = std::min(ids.size(), data.size());
+	this->reserve(size);
+	for(std::size_t i = 0; i < size; ++i){
+		this->insert(ids[i], data[i]);
+	}
+}
+
 /*!
  * Check data coherence with the geometry linked. Return a coherence boolean flag which is
  * false if:
@@ -27,11 +27,229 @@
 # include <bitpit_surfunstructured.hpp>
 # include <surface_skd_tree.hpp>
 # include <CG.hpp>
+# include <algorithm>
+# include <cstdint>
 
 namespace mimmo{
 
 namespace skdTreeUtils{
 
+/*!
+ * Number of spatially ordered points processed in sequence by a thread in batched queries.
+ */
+#define SKDTREEUTILS_BATCH_CHUNK 256
+
+/*!
+ * Number of selection leaves whose intersections with a target tree are searched together by a thread in extractTarget.
+ */
+#define SKDTREEUTILS_LEAF_BATCH 64
+
+namespace {
+
+/*!
+ * Spread the lower 21 bits of an integer, interleaving them with two zero bits.
+ * \param[in] v input integer
+ * \return spread integer
+ */
+uint64_t spreadBits(uint64_t v){
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffff;
+    v = (v | v << 16) & 0x1f0000ff0000ff;
+    v = (v | v << 8)  & 0x100f00f00f00f00f;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3;
+    v = (v | v << 2)  & 0x1249249249249249;
+    return v;
+}
+
+/*!
+ * Sort a list of points along the Morton curve of their bounding box, so that
+ * consecutive points in the resulting order are spatially close.
+ * \param[in] nP number of points
+ * \param[in] P pointer to the first point coordinates
+ * \return indices of the points in Morton order
+ */
+std::vector<int> spatialOrder(int nP, const std::array<double,3> *P){
+
+    std::vector<int> order(nP);
+    if (nP == 0) return order;
+
+    std::array<double,3> pmin = P[0], pmax = P[0];
+    for (int i=1; i<nP; ++i){
+        for (int j=0; j<3; ++j){
+            pmin[j] = std::min(pmin[j], P[i][j]);
+            pmax[j] = std::max(pmax[j], P[i][j]);
+        }
+    }
+    std::array<double,3> scale;
+    for (int j=0; j<3; ++j){
+        double span = pmax[j] - pmin[j];
+        scale[j] = (span > 0.0) ? double((1 << 21) - 1)/span : 0.0;
+    }
+
+    std::vector<std::pair<uint64_t, int> > keys(nP);
+    for (int i=0; i<nP; ++i){
+        uint64_t key = 0;
+        for (int j=0; j<3; ++j){
+            key |= spreadBits(uint64_t((P[i][j] - pmin[j])*scale[j])) << j;
+        }
+        keys[i] = std::make_pair(key, i);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (int i=0; i<nP; ++i){
+        order[i] = keys[i].second;
+    }
+    return order;
+}
+
+/*!
+ * Evaluate the search radius of a point using the result of the previous point
+ * of the sequence as hint. The closest cell of the previous point is found at a distance
+ * lower than prevDist + |P-prevP| from the current point, so the search can be restricted
+ * to it without changing the result.
+ * \param[in] P current point
+ * \param[in] prevP previous point
+ * \param[in] prevDist unsigned distance of the previous point
+ * \param[in] tol geometric tolerance of the tree patch
+ * \return search radius hint
+ */
+double radiusHint(const std::array<double,3> & P, const std::array<double,3> & prevP, double prevDist, double tol){
+    return (prevDist + norm2(P - prevP))*(1.0 + 1.0e-06) + tol;
+}
+
+/*!
+ * Find the closest cell of a tree to a point inside a search radius.
+ * Reentrant version of bitpit::SurfaceSkdTree::findPointClosestCell: the traversal
+ * stacks are local, so that concurrent threads can query the same tree (the tree
+ * is only read).
+ * \param[in] point target point
+ * \param[in] tree tree of the geometry
+ * \param[in] r search radius
+ * \param[out] id label of the closest cell (bitpit::Cell::NULL_ID if none is found inside the radius)
+ * \param[out] h distance of the closest cell (1.0e+18 if none is found inside the radius)
+ */
+void findClosestCell(const std::array<double,3> & point, const bitpit::PatchSkdTree & tree, double r, long *id, double *h){
+
+    *id = bitpit::Cell::NULL_ID;
+    *h = 1.E+18;
+
+    const bitpit::SkdNode &root = tree.getNode(0);
+    double distance = std::min(r, root.evalPointMaxDistance(point));
+
+    std::vector<std::size_t> candidateIds;
+    std::vector<double> candidateMinDistances;
+    std::vector<std::size_t> nodeStack;
+    nodeStack.push_back(0);
+    while (!nodeStack.empty()) {
+        std::size_t nodeId = nodeStack.back();
+        const bitpit::SkdNode &node = tree.getNode(nodeId);
+        nodeStack.pop_back();
+
+        double nodeMinDistance = node.evalPointMinDistance(point);
+        if (nodeMinDistance > distance) {
+            continue;
+        }
+        distance = std::min(node.evalPointMaxDistance(point), distance);
+
+        bool isLeaf = true;
+        for (int i = bitpit::SkdNode::CHILD_BEGIN; i != bitpit::SkdNode::CHILD_END; ++i) {
+            std::size_t childId = node.getChildId(static_cast<bitpit::SkdNode::ChildLocation>(i));
+            if (childId != bitpit::SkdNode::NULL_ID) {
+                isLeaf = false;
+                nodeStack.push_back(childId);
+            }
+        }
+        if (isLeaf) {
+            candidateIds.push_back(nodeId);
+            candidateMinDistances.push_back(nodeMinDistance);
+        }
+    }
+
+    double distanceMin = r;
+    for (std::size_t k = 0; k < candidateIds.size(); ++k) {
+        if (candidateMinDistances[k] > std::min(distance, distanceMin)) {
+            continue;
+        }
+        long idwork = bitpit::Cell::NULL_ID;
+        double distwork = distanceMin;
+        tree.getNode(candidateIds[k]).findPointClosestCell(point, &idwork, &distwork);
+        if (idwork != bitpit::Cell::NULL_ID && distwork <= distanceMin) {
+            distanceMin = distwork;
+            *id = idwork;
+        }
+    }
+    if (*id != bitpit::Cell::NULL_ID) {
+        *h = distanceMin;
+    }
+}
+
+/*!
+ * Evaluate the signed distance and the pseudo-normal of a point from a given cell of a surface patch.
+ * \param[in] P target point
+ * \param[in] spatch surface patch
+ * \param[in] id label of the cell
+ * \param[out] n pseudo-normal of the cell with respect to the point
+ * \return signed distance of the point from the cell
+ */
+double evalSignedDistance(const std::array<double,3> & P, const bitpit::SurfUnstructured *spatch, long id, std::array<double,3> &n){
+
+    double h = 1.E+18;
+    const bitpit::Cell & cell = spatch->getCell(id);
+    bitpit::ConstProxyVector<long> vertIds = cell.getVertexIds();
+    dvecarr3E VS(vertIds.size());
+    int count = 0;
+    for (const auto & iV: vertIds){
+        VS[count] = spatch->getVertexCoords(iV);
+        ++count;
+    }
+
+    darray3E xP = {{0.0,0.0,0.0}};
+    darray3E normal= {{0.0,0.0,0.0}};
+
+    if ( vertIds.size() == 3 ){ //TRIANGLE
+        darray3E lambda;
+        h = bitpit::CGElem::distancePointTriangle(P, VS[0], VS[1], VS[2],lambda);
+        int count = 0;
+        for(const auto &val: lambda){
+            normal += val * spatch->evalVertexNormal(id,count) ;
+            xP += val * VS[count];
+            ++count;
+        }
+    }else if ( vertIds.size() == 2 ){ //LINE/SEGMENT
+        darray2E lambda;
+        h = bitpit::CGElem::distancePointSegment(P, VS[0], VS[1], lambda);
+        int count = 0;
+        for(const auto &val: lambda){
+            normal += val * spatch->evalVertexNormal(id,count) ;
+            xP += val * VS[count];
+            ++count;
+        }
+    }else{ //GENERAL POLYGON
+        std::vector<double> lambda;
+        h = bitpit::CGElem::distancePointPolygon(P, VS,lambda);
+        int count = 0;
+        for(const auto &val: lambda){
+            normal += val * spatch->evalVertexNormal(id,count) ;
+            xP += val * VS[count];
+            ++count;
+        }
+    }
+
+    double s =  sign( dotProduct(normal, P - xP) );
+    if(s == 0.0)    s =1.0;
+    h = s * h;
+    //pseudo-normal (direction P and xP closest point on triangle)
+    n = s * (P - xP);
+    double normX = norm2(n);
+    if(normX < 1.E-15){
+        n = normal/norm2(normal);
+    }else{
+        n /= norm2(n);
+    }
+    return h;
+}
+
+}
+
 /*!
  * It computes the unsigned distance of a point to a geometry linked in a SkdTree
  * object. The geometry has to be a surface mesh, in particular an object of type
@@ -98,59 +316,8 @@ double signedDistance(std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, l
 
     //signed distance only for 2D element patches(quads, pixels, triangles or segments)
     if (id != bitpit::Cell::NULL_ID){
-    	const bitpit::Cell & cell = spatch->getCell(id);
-    	bitpit::ConstProxyVector<long> vertIds = cell.getVertexIds();
-    	dvecarr3E VS(vertIds.size());
-    	int count = 0;
-    	for (const auto & iV: vertIds){
-    		VS[count] = spatch->getVertexCoords(iV);
-    		++count;
-    	}
-
-    	darray3E xP = {{0.0,0.0,0.0}};
-    	darray3E normal= {{0.0,0.0,0.0}};
-
-    	if ( vertIds.size() == 3 ){ //TRIANGLE
-    		darray3E lambda;
-    		h = bitpit::CGElem::distancePointTriangle((*P_), VS[0], VS[1], VS[2],lambda);
-    		int count = 0;
-    		for(const auto &val: lambda){
-    			normal += val * spatch->evalVertexNormal(id,count) ;
-    			xP += val * VS[count];
-    			++count;
-    		}
-    	}else if ( vertIds.size() == 2 ){ //LINE/SEGMENT
-    		darray2E lambda;
-    		h = bitpit::CGElem::distancePointSegment((*P_), VS[0], VS[1], lambda);
-    		int count = 0;
-    		for(const auto &val: lambda){
-    			normal += val * spatch->evalVertexNormal(id,count) ;
-    			xP += val * VS[count];
-    			++count;
-    		}
-    	}else{ //GENERAL POLYGON
-    		std::vector<double> lambda;
-    		h = bitpit::CGElem::distancePointPolygon((*P_), VS,lambda);
-    		int count = 0;
-    		for(const auto &val: lambda){
-    			normal += val * spatch->evalVertexNormal(id,count) ;
-    			xP += val * VS[count];
-    			++count;
-    		}
-    	}
-
-    	double s =  sign( dotProduct(normal, (*P_) - xP) );
-    	if(s == 0.0)    s =1.0;
-    	h = s * h;
-    	//pseudo-normal (direction P and xP closest point on triangle)
-    	n = s * ((*P_) - xP);
-    	double normX = norm2(n);
-    	if(normX < 1.E-15){
-    		n = normal/norm2(normal);
-    	}else{
-    		n /= norm2(n);
-    	}
-    }//end if not id null
+        h = evalSignedDistance(*P_, spatch, id, n);
+    }
     return h;
 
 }
@@ -205,6 +372,8 @@ std::vector<long> selectByPatch(bitpit::PatchSkdTree *selection, bitpit::PatchSk
  * leaf nodes in leafSelection.
  * \param[in] tol Distance threshold used to select the elements of target.
  * the next-th node is not a leaf node the method is recursively called.
+ * Selection leaves are split in batches, each one traversing the target tree
+ * concurrently if OpenMP is enabled (the target tree is only read).
  *
  *
  */
@@ -213,61 +382,74 @@ void extractTarget(bitpit::PatchSkdTree *target, const std::vector<const bitpit:
     if(leafSelection.empty())   return;
     std::size_t rootId  =0;
 
-    std::vector<std::size_t> candidates;
-    std::vector<std::pair< std::size_t, std::vector<const bitpit::SkdNode*> > > nodeStack;
-
-    std::vector<const bitpit::SkdNode*> tocheck;
-    for (int i=0; i<(int)leafSelection.size(); i++){
-        if (bitpit::CGElem::intersectBoxBox(leafSelection[i]->getBoxMin()-tol,
-                                            leafSelection[i]->getBoxMax()+tol,
-                                            target->getNode(rootId).getBoxMin(),
-                                            target->getNode(rootId).getBoxMax() ) )
-        {
-            tocheck.push_back(leafSelection[i]);
+    //mark candidate leaves of the target tree, visiting it once for each batch of selection leaves.
+    std::vector<char> candidates(target->getNodeCount(), 0);
+    int nLeafs = int(leafSelection.size());
+    int nbatches = (nLeafs + SKDTREEUTILS_LEAF_BATCH - 1)/SKDTREEUTILS_LEAF_BATCH;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b=0; b<nbatches; ++b){
+
+        int iend = std::min(nLeafs, (b+1)*SKDTREEUTILS_LEAF_BATCH);
+        std::vector<std::pair< std::size_t, std::vector<const bitpit::SkdNode*> > > nodeStack;
+
+        std::vector<const bitpit::SkdNode*> tocheck;
+        for (int i=b*SKDTREEUTILS_LEAF_BATCH; i<iend; i++){
+            if (bitpit::CGElem::intersectBoxBox(leafSelection[i]->getBoxMin()-tol,
+                                                leafSelection[i]->getBoxMax()+tol,
+                                                target->getNode(rootId).getBoxMin(),
+                                                target->getNode(rootId).getBoxMax() ) )
+            {
+                tocheck.push_back(leafSelection[i]);
+            }
         }
-    }
-    nodeStack.push_back(std::make_pair(rootId, tocheck) );
-
-    while(!nodeStack.empty()){
-
-        std::pair<std::size_t,  std::vector<const bitpit::SkdNode*> >  touple = nodeStack.back();
-        const bitpit::SkdNode & node = target->getNode(touple.first);
-        nodeStack.pop_back();
-
-
-        bool isLeaf = true;
-        for (int i = bitpit::SkdNode::CHILD_BEGIN; i != bitpit::SkdNode::CHILD_END; ++i) {
-            bitpit::SkdNode::ChildLocation childLocation = static_cast<bitpit::SkdNode::ChildLocation>(i);
-            std::size_t childId = node.getChildId(childLocation);
-            if (childId != bitpit::SkdNode::NULL_ID) {
-                isLeaf = false;
-                tocheck.clear();
-                for (int i=0; i<(int)touple.second.size(); i++){
-                    if (bitpit::CGElem::intersectBoxBox(touple.second[i]->getBoxMin()-tol,
-                                                        touple.second[i]->getBoxMax()+tol,
-                                                        target->getNode(childId).getBoxMin(),
-                                                        target->getNode(childId).getBoxMax() ) )
-                    {
-                        tocheck.push_back(touple.second[i]);
+        if(!tocheck.empty())    nodeStack.push_back(std::make_pair(rootId, tocheck) );
+
+        while(!nodeStack.empty()){
+
+            std::pair<std::size_t,  std::vector<const bitpit::SkdNode*> >  touple = nodeStack.back();
+            const bitpit::SkdNode & node = target->getNode(touple.first);
+            nodeStack.pop_back();
+
+
+            bool isLeaf = true;
+            for (int i = bitpit::SkdNode::CHILD_BEGIN; i != bitpit::SkdNode::CHILD_END; ++i) {
+                bitpit::SkdNode::ChildLocation childLocation = static_cast<bitpit::SkdNode::ChildLocation>(i);
+                std::size_t childId = node.getChildId(childLocation);
+                if (childId != bitpit::SkdNode::NULL_ID) {
+                    isLeaf = false;
+                    tocheck.clear();
+                    for (int i=0; i<(int)touple.second.size(); i++){
+                        if (bitpit::CGElem::intersectBoxBox(touple.second[i]->getBoxMin()-tol,
+                                                            touple.second[i]->getBoxMax()+tol,
+                                                            target->getNode(childId).getBoxMin(),
+                                                            target->getNode(childId).getBoxMax() ) )
+                        {
+                            tocheck.push_back(touple.second[i]);
+                        }
                     }
+                    if(!tocheck.empty())    nodeStack.push_back(std::make_pair(childId, tocheck) );
                 }
-                if(!tocheck.empty())    nodeStack.push_back(std::make_pair(childId, tocheck) );
             }
-        }
 
-        if (isLeaf) {
-            candidates.push_back(touple.first);
+            if (isLeaf) {
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic write
+#endif
+                candidates[touple.first] = 1;
+            }
         }
     }
 
-    std::unordered_set<long> cellExtracted;
-    for(const auto & nodeId: candidates){
-        const bitpit::SkdNode & node = target->getNode(nodeId);
-        std::vector<long> cellids = node.getCells();
-        cellExtracted.insert(cellids.begin(), cellids.end());
+    //cells are partitioned among the tree leaves, no duplicates can be found.
+    std::size_t nnodes = candidates.size();
+    for(std::size_t nodeId = 0; nodeId < nnodes; ++nodeId){
+        if(!candidates[nodeId]) continue;
+        std::vector<long> cellids = target->getNode(nodeId).getCells();
+        extracted.insert(extracted.end(), cellids.begin(), cellids.end());
     }
-
-    extracted.insert(extracted.end(), cellExtracted.begin(), cellExtracted.end());
 }
 
 /*!
@@ -486,7 +668,183 @@ long closestCellToPoint(const std::array<double, 3> &point, bitpit::PatchSkdTree
     return id;
 }
 
+/*!
+ * Batched version of the unsigned distance of points to a surface geometry linked in a SkdTree
+ * (see distance for single point). Points are visited in spatially coherent order, split in chunks
+ * processed concurrently if OpenMP is enabled, and the distance of the previous point of a chunk
+ * is used to restrict the search radius of the current one. Each thread traverses the tree
+ * with its own stacks (the shared tree is only read); resulting distances are the same of the single point method.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] bvtree_ Pointer to Boundary Volume Hierarchy tree that stores the geometry.
+ * \param[out] id pointer to the first of nP labels of the elements found as minimum distance elements.
+ * \param[out] distances pointer to the first of nP unsigned distances (1.0e+18 if no element is found).
+ * \param[in] r Length of the side of the box or radius of the sphere used to search.
+ */
+void distance(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, long *id, double *distances, double r)
+{
+    if(!bvtree_ ){
+        throw std::runtime_error("Invalid use of skdTreeUtils::distance method: a void tree is detected.");
+    }
+    if(!dynamic_cast<const bitpit::SurfUnstructured*>(&(bvtree_->getPatch()))){
+        throw std::runtime_error("Invalid use of skdTreeUtils::distance method: a not surface patch tree is detected.");
+    }
 
+    double tol = bvtree_->getPatch().getTol();
+    std::vector<int> order = spatialOrder(nP, P_);
+    int nchunks = (nP + SKDTREEUTILS_BATCH_CHUNK - 1)/SKDTREEUTILS_BATCH_CHUNK;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c=0; c<nchunks; ++c){
+        int kend = std::min(nP, (c+1)*SKDTREEUTILS_BATCH_CHUNK);
+        int prev = -1;
+        for (int k=c*SKDTREEUTILS_BATCH_CHUNK; k<kend; ++k){
+            int i = order[k];
+            double radius = r;
+            if (prev >= 0){
+                radius = std::min(r, radiusHint(P_[i], P_[prev], distances[prev], tol));
+            }
+            double h;
+            findClosestCell(P_[i], *bvtree_, radius, &(id[i]), &h);
+            distances[i] = h;
+            if (h < 1.E+18) prev = i;
+        }
+    }
+}
+
+/*!
+ * Batched version of the signed distance of points to a surface geometry linked in a SkdTree
+ * (see signedDistance for single point). Points are visited in spatially coherent order, split in chunks
+ * processed concurrently if OpenMP is enabled, and the distance of the previous point of a chunk
+ * is used to restrict the search radius of the current one. Each thread traverses the tree
+ * with its own stacks (the shared tree is only read); resulting distances are the same of the single point method.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] bvtree_ Pointer to Boundary Volume Hierarchy tree that stores the geometry.
+ * \param[out] id pointer to the first of nP labels of the elements found as minimum distance elements.
+ * \param[out] n pointer to the first of nP pseudo-normals of the elements found.
+ * \param[out] distances pointer to the first of nP signed distances (1.0e+18 if no element is found).
+ * \param[in] r Length of the side of the box or radius of the sphere used to search.
+ */
+void signedDistance(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, long *id, std::array<double,3> *n, double *distances, double r)
+{
+    if(!bvtree_ ){
+        throw std::runtime_error("Invalid use of skdTreeUtils::signedDistance method: a void tree is detected.");
+    }
+    const bitpit::SurfUnstructured *spatch = dynamic_cast<const bitpit::SurfUnstructured*>(&(bvtree_->getPatch()));
+    if(!spatch){
+        throw std::runtime_error("Invalid use of skdTreeUtils::signedDistance method: a not surface patch tree is detected.");
+    }
+
+    double tol = bvtree_->getPatch().getTol();
+    std::vector<int> order = spatialOrder(nP, P_);
+    int nchunks = (nP + SKDTREEUTILS_BATCH_CHUNK - 1)/SKDTREEUTILS_BATCH_CHUNK;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c=0; c<nchunks; ++c){
+        int kend = std::min(nP, (c+1)*SKDTREEUTILS_BATCH_CHUNK);
+        int prev = -1;
+        for (int k=c*SKDTREEUTILS_BATCH_CHUNK; k<kend; ++k){
+            int i = order[k];
+            double radius = r;
+            if (prev >= 0){
+                radius = std::min(r, radiusHint(P_[i], P_[prev], std::abs(distances[prev]), tol));
+            }
+            double h;
+            findClosestCell(P_[i], *bvtree_, radius, &(id[i]), &h);
+            if (id[i] != bitpit::Cell::NULL_ID){
+                h = evalSignedDistance(P_[i], spatch, id[i], n[i]);
+                prev = i;
+            }
+            distances[i] = h;
+        }
+    }
+}
+
+/*!
+ * Batched version of the projection of points on a surface geometry linked in a SkdTree
+ * (see projectPoint for single point). Points are visited in spatially coherent order, split in chunks
+ * processed concurrently if OpenMP is enabled, and the distance of the previous point of a chunk
+ * is used as initial search radius of the current one. Each thread traverses the tree
+ * with its own stacks (the shared tree is only read); resulting distances are the same of the single point method.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] bvtree_ Pointer to Boundary Volume Hierarchy tree that stores the geometry.
+ * \param[out] projP pointer to the first of nP projected points.
+ * \param[in] r_ Initial length of the sphere radius used to search, when no hint is available.
+ */
+void projectPoint(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, std::array<double,3> *projP, double r_)
+{
+    if(!bvtree_ ){
+        throw std::runtime_error("Invalid use of skdTreeUtils::projectPoint method: a void tree is detected.");
+    }
+    const bitpit::SurfUnstructured *spatch = dynamic_cast<const bitpit::SurfUnstructured*>(&(bvtree_->getPatch()));
+    if(!spatch){
+        throw std::runtime_error("Invalid use of skdTreeUtils::projectPoint method: a not surface patch tree is detected.");
+    }
+
+    double tol = bvtree_->getPatch().getTol();
+    std::vector<int> order = spatialOrder(nP, P_);
+    int nchunks = (nP + SKDTREEUTILS_BATCH_CHUNK - 1)/SKDTREEUTILS_BATCH_CHUNK;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c=0; c<nchunks; ++c){
+        int kend = std::min(nP, (c+1)*SKDTREEUTILS_BATCH_CHUNK);
+        int prev = -1;
+        double prevDist = 0.0;
+        std::array<double,3> normal;
+        long id;
+        for (int k=c*SKDTREEUTILS_BATCH_CHUNK; k<kend; ++k){
+            int i = order[k];
+            double radius = r_;
+            if (prev >= 0){
+                radius = std::min(r_, radiusHint(P_[i], P_[prev], prevDist, tol));
+            }
+            radius = std::max(radius, tol);
+            double dist;
+            do {
+                findClosestCell(P_[i], *bvtree_, radius, &id, &dist);
+                radius *= 1.5;
+            } while (id == bitpit::Cell::NULL_ID);
+            dist = evalSignedDistance(P_[i], spatch, id, normal);
+            projP[i] = P_[i] - dist*normal;
+            prev = i;
+            prevDist = std::abs(dist);
+        }
+    }
+}
+
+/*!
+ * Batched version of the search of the closest cell of a target mesh to points
+ * (see closestCellToPoint for single point). Points are visited in spatially coherent order,
+ * split in chunks processed concurrently if OpenMP is enabled.
+ * \param[in] nP number of points
+ * \param[in] P_ pointer to the first point coordinates.
+ * \param[in] tree reference to SkdTree relative to the target mesh (can be a surface or a volume).
+ * \param[out] id pointer to the first of nP ids of the closest cells (bitpit::Cell::NULL_ID if no cell is found).
+ */
+void closestCellToPoint(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree &tree, long *id)
+{
+    std::vector<int> order = spatialOrder(nP, P_);
+    int nchunks = (nP + SKDTREEUTILS_BATCH_CHUNK - 1)/SKDTREEUTILS_BATCH_CHUNK;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c=0; c<nchunks; ++c){
+        int kend = std::min(nP, (c+1)*SKDTREEUTILS_BATCH_CHUNK);
+        for (int k=c*SKDTREEUTILS_BATCH_CHUNK; k<kend; ++k){
+            int i = order[k];
+            id[i] = closestCellToPoint(P_[i], tree);
+        }
+    }
+}
 
 }
 
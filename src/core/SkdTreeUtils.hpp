@@ -42,6 +42,11 @@ namespace skdTreeUtils{
     std::array<double,3> projectPoint(std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, double r_ = 1.0e+18);
     long locatePointOnPatch(const std::array<double, 3> &point, bitpit::PatchSkdTree &tree);
     long closestCellToPoint(const std::array<double, 3> &point, bitpit::PatchSkdTree &tree);
+
+    void distance(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, long *id, double *distances, double r);
+    void signedDistance(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, long *id, std::array<double,3> *n, double *distances, double r);
+    void projectPoint(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree *bvtree_, std::array<double,3> *projP, double r_ = 1.0e+18);
+    void closestCellToPoint(int nP, const std::array<double,3> *P_, bitpit::PatchSkdTree &tree, long *id);
 }; //end namespace skdTreeUtils
 
 } //end namespace mimmo
@@ -44,6 +44,7 @@
 #include "Chain.hpp"
 #include "InOut.hpp"
 #include "IOConnections.hpp"
+#include "KdTreeUtils.hpp"
 #include "Lattice.hpp"
 #include "MimmoCGUtils.hpp"
 #include "MimmoFvMesh.hpp"
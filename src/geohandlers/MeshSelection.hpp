@@ -34,6 +34,8 @@
 
 namespace mimmo{
 
+class MimmoGeometry;
+
 /*!
  * \ingroup geohandlers
  * \brief Enum class for choiche of method to select sub-patch
@@ -394,6 +396,10 @@ protected:
    of the same topology, provided externally. Extraction criterium
  * is based on euclidean nearness, within a prescribed tolerance.
  * Point clouds are not suitable for this selection method.
+ * External files are read serially, then the skd-trees of all the mapping geometries are
+ * built and compared concurrently if OpenMP is enabled (serially in MPI builds), all sharing
+ * read-only the skd-tree of the target geometry, which is built once and kept as long as the
+ * target is not modified.
  *
  * Ports available in SelectionByMapping Class :
  *
@@ -496,8 +502,8 @@ protected:
     void swap(SelectionByMapping &) noexcept;
 
 private:
-    livector1D getProximity(std::pair<std::string, int> val);
-    livector1D getProximity(MimmoObject * obj);
+    std::unique_ptr<MimmoGeometry> readFile(const std::pair<std::string, int> & val);
+    bool getProximity(MimmoObject * obj, bitpit::PatchSkdTree * targetTree, livector1D & result);
     svector1D extractInfo(std::string);
 };
 
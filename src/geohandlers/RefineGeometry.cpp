@@ -433,7 +433,6 @@ RefineGeometry::smoothing()
 		{
 			// First sub-step (positive) of laplacian smoothing
 			std::unordered_map<long, std::array<double,3>> newcoordinates;
-			std::unordered_set<long> pointconnectivity;
 			std::array<double,3> newcoords, oldcoords, neighcoords;
 			double weight, sumweights;
 			newcoordinates.reserve(geometry->getNVertices());
@@ -441,7 +440,7 @@ RefineGeometry::smoothing()
 			for (long id : geometry->getVertices().getIds()){
 
 				oldcoords = geometry->getVertexCoords(id);
-				pointconnectivity = geometry->getPointConnectivity(id);
+				bitpit::ConstProxyVector<long> pointconnectivity = geometry->getPointConnectivity(id);
 				newcoords = std::array<double,3>{{0.,0.,0.}};
 
 				sumweights = 0.;
@@ -477,7 +476,6 @@ RefineGeometry::smoothing()
 		{
 			//Second sub-step (negative) of laplacian anti-smoothing
 			std::unordered_map<long, std::array<double,3>> newcoordinates;
-			std::unordered_set<long> pointconnectivity;
 			std::array<double,3> newcoords, oldcoords, neighcoords;
 			double weight, sumweights;
 			newcoordinates.reserve(geometry->getNVertices());
@@ -485,7 +483,7 @@ RefineGeometry::smoothing()
 			for (long id : geometry->getVertices().getIds()){
 
 				oldcoords = geometry->getVertexCoords(id);
-				pointconnectivity = geometry->getPointConnectivity(id);
+				bitpit::ConstProxyVector<long> pointconnectivity = geometry->getPointConnectivity(id);
 				newcoords = std::array<double,3>{{0.,0.,0.}};
 
 				sumweights = 0.;
@@ -25,6 +25,7 @@
 #include "MeshSelection.hpp"
 #include "MimmoGeometry.hpp"
 #include "SkdTreeUtils.hpp"
+#include <exception>
 
 namespace mimmo{
 
@@ -353,18 +354,50 @@ livector1D
 SelectionByMapping::extractSelection(){
 
     if(!(getGeometry()->isSkdTreeSync()))    getGeometry()->buildSkdTree();
+    bitpit::PatchSkdTree * targetTree = getGeometry()->getSkdTree();
     std::set<long> cellList;
 
+    //external files are read serially: a missing or unreadable file aborts the selection.
+    std::vector<std::unique_ptr<MimmoGeometry> > readers;
+    readers.reserve(m_geolist.size());
+    std::vector<MimmoObject*> mappingGeos;
+    mappingGeos.reserve(m_geolist.size() + m_mimmolist.size());
     for (auto & file : m_geolist){
-        livector1D list = getProximity(file);
-        cellList.insert(list.begin(), list.end());
+        readers.push_back(readFile(file));
+        mappingGeos.push_back(readers.back()->getGeometry());
+    }
+    mappingGeos.insert(mappingGeos.end(), m_mimmolist.begin(), m_mimmolist.end());
+
+    //skd-trees of the mapping geometries are built and mapped concurrently.
+    //Errors are collected per geometry and raised after the parallel region.
+    int nTasks = int(mappingGeos.size());
+    std::vector<livector1D> lists(nTasks);
+    std::vector<char> failed(nTasks, 0);
+    std::vector<std::exception_ptr> errors(nTasks);
+
+#if MIMMO_ENABLE_OPENMP && !MIMMO_ENABLE_MPI
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i=0; i<nTasks; ++i){
+        try{
+            failed[i] = !getProximity(mappingGeos[i], targetTree, lists[i]);
+        }catch(...){
+            errors[i] = std::current_exception();
+        }
     }
 
-
-    for (auto & mimmoptr : m_mimmolist){
-        livector1D list = getProximity(mimmoptr);
-        cellList.insert(list.begin(), list.end());
+    for (int i=0; i<nTasks; ++i){
+        if(errors[i]){
+            std::rethrow_exception(errors[i]);
+        }
+        if(failed[i]){
+            m_log->setPriority(bitpit::log::NORMAL);
+            (*m_log)<< m_name << " failed to read or unsuitable geometry in SelectionByMapping::getProximity"<<std::endl;
+            m_log->setPriority(bitpit::log::DEBUG);
+        }
+        cellList.insert(lists[i].begin(), lists[i].end());
     }
+    readers.clear();
 
 /* check if dual */
     livector1D result;
@@ -394,53 +427,44 @@ SelectionByMapping::extractSelection(){
 };
 
 /*!
- * Return portion of target geometry near to an external geometry
- * \param[in] val Pair with file of external geometry to be compared and
- * number of total raw points for level set evaluation
+ * Read an external geometry file. Its skd-tree is not built here.
+ * \param[in] val Pair with file of external geometry to be compared and its file type
+ * \return reader of the file, owning the geometry read
  */
-livector1D
-SelectionByMapping::getProximity(std::pair<std::string, int> val){
+std::unique_ptr<MimmoGeometry>
+SelectionByMapping::readFile(const std::pair<std::string, int> & val){
 
     svector1D info = extractInfo(val.first);
 
-    MimmoGeometry * geo = new MimmoGeometry();
+    std::unique_ptr<MimmoGeometry> geo(new MimmoGeometry());
     geo->setIOMode(IOMode::READ);
     geo->setDir(info[0]);
     geo->setFilename(info[1]);
     geo->setFileType(val.second);
-    geo->setBuildSkdTree(true);
+    geo->setBuildSkdTree(false);
     geo->execute();
-
-    if(geo->getGeometry()->getNVertices() == 0 || geo->getGeometry()->getNCells() == 0 || geo->getGeometry()->getType()==3 ){
-        m_log->setPriority(bitpit::log::NORMAL);
-        (*m_log)<< m_name << " failed to read or unsuitable geometry in SelectionByMapping::getProximity"<<std::endl;
-        m_log->setPriority(bitpit::log::DEBUG);
-        return livector1D();
-    }
-    livector1D result = mimmo::skdTreeUtils::selectByPatch(geo->getGeometry()->getSkdTree(), getGeometry()->getSkdTree(), m_tolerance);
-    delete geo;
-    geo=NULL;
-
-    return    result;
+    return geo;
 };
 
 /*!
- * Return portion of target geometry near to an external geometry
+ * Return portion of target geometry near to an external geometry.
+ * The skd-tree of the external geometry is built here if needed.
+ * It can be called concurrently on different geometries; nothing is logged.
  * \param[in] obj Pointer to external geometry to be compared.
+ * \param[in] targetTree skd-tree of the target geometry, only read
+ * \param[out] result ids of cells of target geometry near to the external one
+ * \return false if the geometry is empty or a point cloud
  */
-livector1D
-SelectionByMapping::getProximity(MimmoObject* obj){
+bool
+SelectionByMapping::getProximity(MimmoObject* obj, bitpit::PatchSkdTree * targetTree, livector1D & result){
 
-    if(obj->getNVertices() == 0 || obj->getNCells() == 0){
-        m_log->setPriority(bitpit::log::NORMAL);
-        (*m_log)<< m_name << " failed to read geometry in SelectionByMapping::getProximity"<<std::endl;
-        m_log->setPriority(bitpit::log::DEBUG);
-        return livector1D();
+    if(obj->getNVertices() == 0 || obj->getNCells() == 0 || obj->getType() == 3){
+        return false;
     }
 
-    livector1D result = mimmo::skdTreeUtils::selectByPatch(obj->getSkdTree(), getGeometry()->getSkdTree(), m_tolerance);
+    result = mimmo::skdTreeUtils::selectByPatch(obj->getSkdTree(), targetTree, m_tolerance);
 
-    return    result;
+    return true;
 };
 
 /*!
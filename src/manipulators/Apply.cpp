@@ -143,13 +143,8 @@ Apply::execute(){
 
 	checkInput();
 
-	darray3E vertexcoords;
-	long int ID;
-	for (const auto & vertex : m_geometry->getVertices()){
-		vertexcoords = vertex.getCoords();
-		ID = vertex.getId();
-		vertexcoords += m_factor*m_input[ID];
-		getGeometry()->modifyVertex(vertexcoords, ID);
+	if(!getGeometry()->displaceVertices(m_input, m_factor)){
+		(*m_log)<<"WARNING "<<m_name<<" : displacements found on vertices not belonging to the linked geometry, they are ignored"<<std::endl;
 	}
 
 #if MIMMO_ENABLE_MPI
@@ -258,7 +258,6 @@ BendGeometry::execute(){
 
     m_displ.clear();
     m_displ.setDataLocation(mimmo::MPVLocation::POINT);
-    m_displ.reserve(getGeometry()->getNVertices());
     m_displ.setGeometry(getGeometry());
 
 
@@ -271,22 +270,27 @@ BendGeometry::execute(){
 
     checkFilter();
 
-    long ID;
-    darray3E value;
-    darray3E point, point0;
-    for (const auto & vertex : m_geometry->getVertices()){
-        point = vertex.getCoords();
+    const VertexCoordinatesSoA & coords = getGeometry()->getVertexCoordinatesSoA();
+    long nV = long(coords.size());
+    dvecarr3E displ(nV);
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < nV; ++i){
+        darray3E point({{coords.x[i], coords.y[i], coords.z[i]}});
+        darray3E point0 = point;
         if (m_local){
-            point0 = point;
             point = toLocalCoord(point);
         }
-        ID = vertex.getId();
+        double filter = m_filter[coords.ids[i]];
+        darray3E value;
         value.fill(0.0);
         for (int j=0; j<3; j++){
             for (int z=0; z<3; z++){
                 if (m_degree[j][z] > 0){
                     for (int k=0; k<(int)m_degree[j][z]+1; k++){
-                        value[j] += pow(point[z],(double)k)*m_coeffs[j][z][k]*m_filter[ID];
+                        value[j] += pow(point[z],(double)k)*m_coeffs[j][z][k]*filter;
                     }
                 }
             }
@@ -296,8 +300,10 @@ BendGeometry::execute(){
             point = toGlobalCoord(point);
             value = point - point0;
         }
-        m_displ.insert(ID, value);
+        displ[i] = value;
     }
+
+    m_displ.setData(coords.ids, displ);
 };
 
 /*!
@@ -34,6 +34,12 @@ FFDLattice::FFDLattice(){
     m_mapNodes.resize(3);
     m_globalDispl = false;
     m_bfilter = false;
+    m_cacheActive = false;
+    m_cacheValid = false;
+    m_cacheGeometry = NULL;
+    m_cacheRevision = 0;
+    m_cacheStencil = 0;
+    m_cacheShapeType = ShapeType::CUBE;
     m_name = "mimmo.FFDlattice";
 };
 
@@ -49,6 +55,12 @@ FFDLattice::FFDLattice(const bitpit::Config::Section & rootXML){
     m_mapNodes.resize(3);
     m_globalDispl = false;
     m_bfilter = false;
+    m_cacheActive = false;
+    m_cacheValid = false;
+    m_cacheGeometry = NULL;
+    m_cacheRevision = 0;
+    m_cacheStencil = 0;
+    m_cacheShapeType = ShapeType::CUBE;
     m_name = "mimmo.FFDlattice";
 
     std::string fallback_name = "ClassNONE";
@@ -64,7 +76,7 @@ FFDLattice::FFDLattice(const bitpit::Config::Section & rootXML){
 /*! Destructor */
 FFDLattice::~FFDLattice(){};
 
-/*! Copy Constructor. Result displacements are never copied.
+/*! Copy Constructor. Result displacements and cached evaluation structures are never copied.
  *\param[in] other FFDLattice where copy from
  */
 FFDLattice::FFDLattice(const FFDLattice & other):Lattice(other){
@@ -79,6 +91,11 @@ FFDLattice::FFDLattice(const FFDLattice & other):Lattice(other){
     m_bfilter = other.m_bfilter;
     m_filter = other.m_filter;
     m_collect_wg = other.m_collect_wg;
+    m_cacheActive = other.m_cacheActive;
+    m_cacheValid = false;
+    m_cacheGeometry = NULL;
+    m_cacheRevision = 0;
+    m_cacheStencil = 0;
 };
 
 
@@ -107,6 +124,21 @@ void FFDLattice::swap(FFDLattice & x) noexcept
    std::swap(m_bfilter, x.m_bfilter);
    m_filter.swap(x.m_filter);
    std::swap(m_collect_wg, x.m_collect_wg);
+   std::swap(m_cacheActive, x.m_cacheActive);
+   std::swap(m_cacheValid, x.m_cacheValid);
+   std::swap(m_cacheGeometry, x.m_cacheGeometry);
+   std::swap(m_cacheRevision, x.m_cacheRevision);
+   std::swap(m_cacheShapeType, x.m_cacheShapeType);
+   std::swap(m_cacheOrigin, x.m_cacheOrigin);
+   std::swap(m_cacheSpan, x.m_cacheSpan);
+   std::swap(m_cacheInfLimits, x.m_cacheInfLimits);
+   std::swap(m_cacheRefSystem, x.m_cacheRefSystem);
+   std::swap(m_cacheCoordType, x.m_cacheCoordType);
+   std::swap(m_cacheList, x.m_cacheList);
+   std::swap(m_cacheLocal, x.m_cacheLocal);
+   std::swap(m_cacheStencil, x.m_cacheStencil);
+   std::swap(m_cacheNodes, x.m_cacheNodes);
+   std::swap(m_cacheCoeffs, x.m_cacheCoeffs);
    m_gdispl.swap(x.m_gdispl);
    Lattice::swap(x);
 }
@@ -142,6 +174,7 @@ FFDLattice::clearLattice(){
     Lattice::clearLattice();
     clearKnots(); //clear all knots stuff;
     clearFilter();
+    clearCache();
     m_displ.clear();
 
 };
@@ -153,6 +186,21 @@ FFDLattice::clearFilter(){
     m_bfilter = false;
 };
 
+/*!Clean structures of cached evaluation. They will be recomputed on next execution,
+ * if cached evaluation is active.
+ */
+void
+FFDLattice::clearCache(){
+    m_cacheValid = false;
+    m_cacheGeometry = NULL;
+    m_cacheRevision = 0;
+    m_cacheStencil = 0;
+    m_cacheList.clear();
+    m_cacheLocal.clear();
+    m_cacheNodes.clear();
+    m_cacheCoeffs.clear();
+};
+
 
 /*! Return a vector of six elements reporting the real number of knots
     effectively stored in the current class (first 3 elements) and the
@@ -263,6 +311,12 @@ FFDLattice::getDeformation(){
 bool
 FFDLattice::isDisplGlobal(){return(m_globalDispl);}
 
+/*! Check if cached evaluation of the deformation is active. See setCachedEvaluation method.
+ * \return cached evaluation flag
+ */
+bool
+FFDLattice::isCachedEvaluation(){return(m_cacheActive);}
+
 
 /*! Set the degree of nurbs curve in each direction. If the number of control nodes are
  * not initialized, they are set to the minimum number admissible.
@@ -493,6 +547,26 @@ FFDLattice::setFilter(dmpvector1D *filter){
     m_filter = *filter;
 };
 
+/*! Enable/disable cached evaluation of the deformation.
+ * If active, on first execution the vertices of the geometry included in the lattice
+ * are stored together with the indices of the control nodes influencing each of them and
+ * the related weighted basis coefficients. Following executions reuse these structures,
+ * and the deformation is computed as a sparse product with the control nodes displacements,
+ * skipping inclusion test, knot search and basis evaluation.
+ * Useful when only displacements change between executions (e.g. optimization loops).
+ * Cached structures are discarded automatically when lattice shape, dimensions, degrees,
+ * nodal weights, coordinate types or linked geometry change.
+ * Note that applying the deformation to the linked geometry modifies its vertices, hence
+ * it invalidates the cache as well.
+ * Results equal the ones of the standard evaluation up to round-off.
+ * \param[in] flag true to activate cached evaluation
+ */
+void
+FFDLattice::setCachedEvaluation(bool flag){
+    m_cacheActive = flag;
+    if(!flag) clearCache();
+};
+
 /*! Plot your current lattice as a structured grid to *vtu file.
    Wrapped method of plotGrid of mother class UStrucMesh.
 
@@ -594,6 +668,9 @@ FFDLattice::execute(){
     m_gdispl.reserve(getGeometry()->getNVertices());
     m_gdispl.setGeometry(getGeometry());
 
+    //discard cached structures if geometry changed: check before trees are rebuilt
+    checkCache();
+
     //build trees
     if(container->isSkdTreeSupported() && !container->isSkdTreeSync())    container->buildSkdTree();
     else if(!container->isKdTreeSync())                                container->buildKdTree();
@@ -654,11 +731,24 @@ FFDLattice::apply(livector1D & list){
     if(container->isEmpty() || !isBuilt()) return dvecarr3E(0);
 
 
-    //check simplex included and extract their vertex in global IDs;
-    if(container->isSkdTreeSupported()) list= container->getVertexFromCellList(getShape()->includeGeometry(container));
-    else                               list= getShape()->includeCloudPoints(container);
-    //return deformation
-    dvecarr3E result = nurbsEvaluator(list);
+    dvecarr3E result;
+    if(m_cacheActive){
+        checkCache();
+        if(!m_cacheValid){
+            //check simplex included and extract their vertex in global IDs;
+            if(container->isSkdTreeSupported()) list= container->getVertexFromCellList(getShape()->includeGeometry(container));
+            else                               list= getShape()->includeCloudPoints(container);
+            buildCache(list);
+        }
+        list = m_cacheList;
+        result = cachedEvaluator();
+    }else{
+        //check simplex included and extract their vertex in global IDs;
+        if(container->isSkdTreeSupported()) list= container->getVertexFromCellList(getShape()->includeGeometry(container));
+        else                               list= getShape()->includeCloudPoints(container);
+        //return deformation
+        result = nurbsEvaluator(list);
+    }
     if(m_bfilter){
 
         checkFilter();
@@ -730,6 +820,34 @@ FFDLattice::checkFilter(){
     }
 }
 
+/*!
+ * Check if cached evaluation structures are still coherent with the current lattice
+ * and linked geometry. If not, they are discarded.
+ * Changes of the geometry vertices are detected through the geometry revision counter
+ * (see MimmoObject::getRevision).
+ */
+void
+FFDLattice::checkCache(){
+    if(!m_cacheValid) return;
+
+    MimmoObject * container = getGeometry();
+    bool check = isBuilt() && container != NULL && container == m_cacheGeometry;
+    check = check && container->getRevision() == m_cacheRevision;
+    check = check && getShapeType() == m_cacheShapeType;
+    check = check && getOrigin() == m_cacheOrigin;
+    check = check && getSpan() == m_cacheSpan;
+    check = check && getInfLimits() == m_cacheInfLimits;
+    check = check && getRefSystem() == m_cacheRefSystem;
+    check = check && getCoordType() == m_cacheCoordType;
+
+    if(!check){
+        m_log->setPriority(bitpit::log::Verbosity::DEBUG);
+        (*m_log)<<m_name<<" : lattice or geometry changed, cached evaluation structures discarded"<<std::endl;
+        m_log->setPriority(bitpit::log::Verbosity::NORMAL);
+        clearCache();
+    }
+}
+
 /*! Convert a target displacement (expressed in local shape ref frame) in XYZ frame
  *    \param[in] target  target displacement
  *  \param[in] i reference displacement index
@@ -848,6 +966,15 @@ FFDLattice::nurbsEvaluator(darray3E & pointOr){
 /*! Return displacement of a list of points,
  * under the deformation effect of the whole Lattice.
  *
+ * Points are processed in blocks of FFDLATTICE_EVAL_BLOCK elements: for each block
+ * local coordinates are stored in a structure-of-arrays layout, knot intervals and
+ * basis functions of the three directions are computed in a single pass into a
+ * preallocated buffer, and then the tensor-product sum is accumulated point by point
+ * on fixed-size arrays. No memory is allocated inside the evaluation loop.
+ * Blocks are distributed among threads if OpenMP support is enabled.
+ * The arithmetic performed on each point is the same of the single point evaluator,
+ * so results do not depend on block size or number of threads.
+ *
  * \param[in] list 3D points
  * \return points displacements
  */
@@ -855,131 +982,289 @@ dvecarr3E
 FFDLattice::nurbsEvaluator(livector1D & list){
 
     bitpit::PatchKernel * tri = getGeometry()->getPatch();
-    long int id;
-    int lsize = list.size();
-    livector1D::iterator it, itend = list.end();
-    darray3E target, point;
-    ivector1D knotInterval(3,0);
-    dvector1D BSbasisi0, BSbasisi1, BSbasisi2;
-    dvector1D valH(4,0), temp1(4,0),temp2(4,0);
+    long lsize = list.size();
 
     dvecarr3E displ = recoverFullGridDispl();
     dvector1D weig = recoverFullNodeWeights();
 
-    int uind, vind, wind, index;
-
-    int intv, i, j, k;
-
     int i0 = m_mapdeg[0];
     int i1 = m_mapdeg[1];
     int i2 = m_mapdeg[2];
-    iarray3E mappedIndex;
 
     int md0 = m_deg[i0];
     int md1 = m_deg[i1];
     int md2 = m_deg[i2];
+    int maxdd = std::max(md0, std::max(md1, md2)) + 1;
 
     dvecarr3E outres(lsize);
-    dvecarr3E::iterator itout = outres.begin();
     darray3E scaling = getShape()->getScaling();
+    bool globalDispl = isDisplGlobal();
+
+    const long nBlocks = (lsize + FFDLATTICE_EVAL_BLOCK - 1) / FFDLATTICE_EVAL_BLOCK;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#endif
+    {
+        //per-thread work buffers, sized once.
+        //basis layout: [direction][point in block][basis index]
+        dvector1D basisBuffer(3 * FFDLATTICE_EVAL_BLOCK * maxdd);
+        dvector1D left(maxdd), right(maxdd);
+        double coords[3][FFDLATTICE_EVAL_BLOCK];
+        int knotInterval[3][FFDLATTICE_EVAL_BLOCK];
+        darray3E target, point;
+        iarray3E mappedIndex;
+        double valH[4], temp1[4], temp2[4];
+        double bbasisw2, bbasis1, bbasis0;
+        int index, intv, i, j, k;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp for schedule(static)
+#endif
+        for(long b = 0; b < nBlocks; ++b){
+
+            long first = b * FFDLATTICE_EVAL_BLOCK;
+            int nb = int(std::min(lsize - first, long(FFDLATTICE_EVAL_BLOCK)));
+
+            //gather local coordinates of the block
+            for(int p = 0; p < nb; ++p){
+                target = tri->getVertex(list[first + p]).getCoords();
+                point = transfToLocal(target);
+                for(i=0; i<3; ++i){
+                    coords[i][p] = point[i];
+                }
+            }
 
-    double bbasisw2;
-    double bbasis1, bbasis0;
+            //knot intervals and basis functions of the block
+            for(i=0; i<3; ++i){
+                double * dirBasis = basisBuffer.data() + i * FFDLATTICE_EVAL_BLOCK * maxdd;
+                for(int p = 0; p < nb; ++p){
+                    knotInterval[i][p] = getKnotInterval(coords[i][p], i);
+                    basisITS0(knotInterval[i][p], i, coords[i][p], dirBasis + p * maxdd, left.data(), right.data());
+                }
+            }
 
-    for(it = list.begin(); it != itend; ++it){
+            //tensor-product sum
+            for(int p = 0; p < nb; ++p){
 
-        for(intv=0; intv<4; ++intv){
-            valH[intv] = 0.0;
-        }
-        id  = *it;
-        target = tri->getVertex(id).getCoords();
-        point = transfToLocal(target);
+                const double * BSbasisi0 = basisBuffer.data() + (i0 * FFDLATTICE_EVAL_BLOCK + p) * maxdd;
+                const double * BSbasisi1 = basisBuffer.data() + (i1 * FFDLATTICE_EVAL_BLOCK + p) * maxdd;
+                const double * BSbasisi2 = basisBuffer.data() + (i2 * FFDLATTICE_EVAL_BLOCK + p) * maxdd;
 
-        // get reference Interval int the knot matrix
-        for(i=0; i<3; i++){
-            knotInterval[i] = getKnotInterval(point[i],i);
-        }
-        BSbasisi0 = basisITS0(knotInterval[i0], i0, point[i0]);
-        BSbasisi1 = basisITS0(knotInterval[i1], i1, point[i1]);
-        BSbasisi2 = basisITS0(knotInterval[i2], i2, point[i2]);
+                int uind = knotInterval[i0][p] - md0;
+                int vind = knotInterval[i1][p] - md1;
+                int wind = knotInterval[i2][p] - md2;
 
-        uind = knotInterval[i0] - md0;
-        vind = knotInterval[i1] - md1;
-        wind = knotInterval[i2] - md2;
+                for(intv=0; intv<4; ++intv){
+                    valH[intv] = 0.0;
+                }
 
+                for(i=0; i<=md0; ++i){
 
-        for(i=0; i<=md0; ++i){
+                    mappedIndex[i0] = uind + i;
 
-            mappedIndex[i0] = uind + i;
+                    for(intv=0; intv<4; ++intv){
+                        temp1[intv] = 0.0;
+                    }
 
-            for(int intv=0; intv<4; ++intv){
-                temp1[intv] = 0.0;
-            }
+                    for(j=0; j<=md1; ++j){
 
-            for(j=0; j<=md1; ++j){
+                        mappedIndex[i1] = vind + j;
 
-                mappedIndex[i1] = vind + j;
+                        for(intv=0; intv<4; ++intv){
+                            temp2[intv] = 0.0;
+                        }
 
-                for(intv=0; intv<4; ++intv){
-                    temp2[intv] = 0.0;
-                }
+                        for(k=0; k<=md2; ++k){
 
-                for(k=0; k<=md2; ++k){
+                            mappedIndex[i2] = wind + k;
 
-                    mappedIndex[i2] = wind + k;
+                            index = accessMapNodes(mappedIndex[0], mappedIndex[1], mappedIndex[2]);
 
-                    index = accessMapNodes(mappedIndex[0], mappedIndex[1], mappedIndex[2]);
+                            bbasisw2 = BSbasisi2[k]* weig[index];
 
-                    bbasisw2 = BSbasisi2[k]* weig[index];
+                            for(intv=0; intv<3; ++intv){
+                                temp2[intv] += bbasisw2 * displ[index][intv];
+                            }
+                            temp2[3] += bbasisw2;
 
-                    for(intv=0; intv<3; ++intv){
-                        temp2[intv] += bbasisw2 * displ[index][intv];
-                    }
-                    temp2[3] += bbasisw2;
+                        }
+                        bbasis1 = BSbasisi1[j];
+                        for(intv=0; intv<4; ++intv){
+                            temp1[intv] += bbasis1*temp2[intv];
+                        }
 
+                    }
+                    bbasis0 = BSbasisi0[i];
+                    for(intv=0; intv<4; ++intv){
+                        valH[intv] += bbasis0*temp1[intv];
+                    }
                 }
-                bbasis1 = BSbasisi1[j];
-                for(intv=0; intv<4; ++intv){
-                    temp1[intv] += bbasis1*temp2[intv];
+
+                darray3E & res = outres[first + p];
+                if(globalDispl){
+
+                    //adding to local point displ rescaled
+                    for(i=0; i<3; ++i){
+                        res[i] = valH[i]/valH[3];
+                    }
+
+                }else{
+
+                    //adding to local point displ rescaled
+                    for(i=0; i<3; ++i){
+                        point[i] = coords[i][p] + valH[i]/(valH[3]*scaling[i]);
+                    }
+                    target = tri->getVertex(list[first + p]).getCoords();
+
+                    //get absolute displ as difference of
+                    res = transfToGlobal(point) - target;
                 }
+            }
+        }//next block
+    }
+
+    return(outres);
+
+};
+
+/*! Fill the cached evaluation structures for a list of geometry vertices:
+ * local coordinates, indices of the control nodes influencing each vertex and related
+ * weighted tensor-product basis coefficients. Current lattice and geometry
+ * configuration is stored to detect later changes.
+ * \param[in] list ids of geometry vertices included in the lattice
+ */
+void
+FFDLattice::buildCache(livector1D & list){
+
+    clearCache();
+
+    bitpit::PatchKernel * tri = getGeometry()->getPatch();
+    long lsize = list.size();
+    dvector1D weig = recoverFullNodeWeights();
+
+    int i0 = m_mapdeg[0];
+    int i1 = m_mapdeg[1];
+    int i2 = m_mapdeg[2];
 
+    int md0 = m_deg[i0];
+    int md1 = m_deg[i1];
+    int md2 = m_deg[i2];
+    int maxdd = std::max(md0, std::max(md1, md2)) + 1;
+
+    m_cacheStencil = (md0+1)*(md1+1)*(md2+1);
+    m_cacheList = list;
+    m_cacheLocal.resize(lsize);
+    m_cacheNodes.resize(lsize * m_cacheStencil);
+    m_cacheCoeffs.resize(lsize * m_cacheStencil);
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#endif
+    {
+        dvector1D BSbasis(3*maxdd), left(maxdd), right(maxdd);
+        iarray3E knotInterval, mappedIndex;
+        darray3E target;
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp for schedule(static)
+#endif
+        for(long p = 0; p < lsize; ++p){
+
+            target = tri->getVertex(list[p]).getCoords();
+            darray3E & point = m_cacheLocal[p];
+            point = transfToLocal(target);
+
+            for(int i=0; i<3; ++i){
+                knotInterval[i] = getKnotInterval(point[i],i);
+                basisITS0(knotInterval[i], i, point[i], BSbasis.data() + i*maxdd, left.data(), right.data());
             }
-            bbasis0 = BSbasisi0[i];
-            for(intv=0; intv<4; ++intv){
-                valH[intv] += bbasis0*temp1[intv];
+            const double * BSbasisi0 = BSbasis.data() + i0*maxdd;
+            const double * BSbasisi1 = BSbasis.data() + i1*maxdd;
+            const double * BSbasisi2 = BSbasis.data() + i2*maxdd;
+
+            int uind = knotInterval[i0] - md0;
+            int vind = knotInterval[i1] - md1;
+            int wind = knotInterval[i2] - md2;
+
+            long pos = p * m_cacheStencil;
+            for(int i=0; i<=md0; ++i){
+                mappedIndex[i0] = uind + i;
+                for(int j=0; j<=md1; ++j){
+                    mappedIndex[i1] = vind + j;
+                    for(int k=0; k<=md2; ++k){
+                        mappedIndex[i2] = wind + k;
+                        int index = accessMapNodes(mappedIndex[0], mappedIndex[1], mappedIndex[2]);
+                        m_cacheNodes[pos] = index;
+                        m_cacheCoeffs[pos] = BSbasisi0[i]*BSbasisi1[j]*BSbasisi2[k]*weig[index];
+                        ++pos;
+                    }
+                }
             }
         }
+    }
 
+    m_cacheGeometry = getGeometry();
+    m_cacheRevision = m_cacheGeometry->getRevision();
+    m_cacheShapeType = getShapeType();
+    m_cacheOrigin = getOrigin();
+    m_cacheSpan = getSpan();
+    m_cacheInfLimits = getInfLimits();
+    m_cacheRefSystem = getRefSystem();
+    m_cacheCoordType = getCoordType();
+    m_cacheValid = true;
+};
 
-        if(isDisplGlobal()){
-
-            //adding to local point displ rescaled
-            for(i=0; i<3; ++i){
-                (*itout)[i] = valH[i]/valH[3];
-            }
+/*! Return displacement of the vertices stored in the cached evaluation structures,
+ * under the deformation effect of the whole Lattice, as a sparse product between
+ * cached basis coefficients and current control nodes displacements.
+ * \return vertices displacements, ordered as m_cacheList
+ */
+dvecarr3E
+FFDLattice::cachedEvaluator(){
 
-        }else{
+    bitpit::PatchKernel * tri = getGeometry()->getPatch();
+    long lsize = m_cacheList.size();
 
-            //adding to local point displ rescaled
-            for(i=0; i<3; ++i){
-                point[i]+= valH[i]/(valH[3]*scaling[i]);
-            }
+    dvecarr3E displ = recoverFullGridDispl();
+    darray3E scaling = getShape()->getScaling();
+    bool globalDispl = isDisplGlobal();
 
-            //get absolute displ as difference of
-            for(i=0; i<3; ++i){
-                (*itout)[i] = transfToGlobal(point)[i] - target[i];
-            }
+    dvecarr3E outres(lsize);
 
-        }
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for(long p = 0; p < lsize; ++p){
 
-        itout++;
+        double valH[4] = {0.0, 0.0, 0.0, 0.0};
+        const int * nodes = m_cacheNodes.data() + p * m_cacheStencil;
+        const double * coeffs = m_cacheCoeffs.data() + p * m_cacheStencil;
 
-    }//next list id
+        for(int s = 0; s < m_cacheStencil; ++s){
+            const darray3E & d = displ[nodes[s]];
+            for(int intv=0; intv<3; ++intv){
+                valH[intv] += coeffs[s] * d[intv];
+            }
+            valH[3] += coeffs[s];
+        }
 
-    itout = outres.end();
+        darray3E & res = outres[p];
+        if(globalDispl){
+            for(int i=0; i<3; ++i){
+                res[i] = valH[i]/valH[3];
+            }
+        }else{
+            darray3E point;
+            for(int i=0; i<3; ++i){
+                point[i] = m_cacheLocal[p][i] + valH[i]/(valH[3]*scaling[i]);
+            }
+            darray3E target = tri->getVertex(m_cacheList[p]).getCoords();
+            res = transfToGlobal(point) - target;
+        }
+    }
 
     return(outres);
-
 };
 
 /*! Return a specified component of a displacement of a given point, under the deformation effect of the whole Lattice.
@@ -1068,13 +1353,36 @@ FFDLattice::nurbsEvaluatorScalar(darray3E & coordOr, int targ){
 dvector1D
 FFDLattice::basisITS0(int k, int pos, double coord){
 
+    int dd1 = m_deg[pos]+1;
+    dvector1D basis(dd1);
+    dvector1D left(dd1), right(dd1);
+    basisITS0(k, pos, coord, basis.data(), left.data(), right.data());
+    return(basis);
+};
+
+/*!Evaluate the local basis function of a Nurbs Curve on caller-provided buffers, without
+ * allocating memory. Same algorithm of basisITS0(int k, int pos, double coord).
+ *\param[in] k  local knot interval in which coord resides -> theoretical knot indexing,
+ *\param[in] pos identifies which nurbs curve of lattice (3 curve for 3 box direction) you are pointing
+ *\param[in] coord the evaluation point on the curve
+ *\param[out] basis buffer of at least degree+1 elements, filled with the local basis
+ *\param[in] left work buffer of at least degree+1 elements
+ *\param[in] right work buffer of at least degree+1 elements
+ */
+void
+FFDLattice::basisITS0(int k, int pos, double coord, double * basis, double * left, double * right){
+
     //return local basis function given the local interval in theoretical knot index,
     //local degree of the curve -> Please refer to NURBS book of PEIGL for this Inverted Triangular Scheme Algorithm (pag 74);
     int dd1 = m_deg[pos]+1;
-    dvector1D basis(dd1,1);
-    dvector1D left(dd1,0), right(dd1,0);
     double saved, tmp;
 
+    for(int j = 0; j < dd1; ++j){
+        basis[j] = 1.0;
+        left[j] = 0.0;
+        right[j] = 0.0;
+    }
+
     for(int j = 1; j < dd1; ++j){
         saved = 0.0;
         left[j] = coord - getKnotValue(k+1-j, pos);
@@ -1088,8 +1396,6 @@ FFDLattice::basisITS0(int k, int pos, double coord){
 
         basis[j] = saved;
     }//next j
-
-    return(basis);
 };
 
 /*!Return list of equally spaced knots for the Nurbs curve in a specific lattice direction
@@ -1576,6 +1882,9 @@ FFDLattice::build(){
     //empty m_collect_wg
     m_collect_wg.clear();
 
+    //lattice changed, cached evaluation is no longer valid
+    clearCache();
+
     setKnotsStructure();
     orderDimension();
     return check;
@@ -1634,6 +1943,17 @@ FFDLattice::absorbSectionXML(const bitpit::Config::Section & slotXML, std::strin
         setDisplGlobal(temp);
     };
 
+    if(slotXML.hasOption("CachedEvaluation")){
+        std::string input = slotXML.get("CachedEvaluation");
+        input = bitpit::utils::string::trim(input);
+        bool temp = false;
+        if(!input.empty()){
+            std::stringstream ss(input);
+            ss>>temp;
+        }
+        setCachedEvaluation(temp);
+    };
+
 };
 
 /*!
@@ -1672,6 +1992,10 @@ FFDLattice::flushSectionXML(bitpit::Config::Section & slotXML, std::string name)
         slotXML.set("DisplGlobal", std::to_string(int(isDisplGlobal())));
     }
 
+    if(isCachedEvaluation()){
+        slotXML.set("CachedEvaluation", std::to_string(1));
+    }
+
 };
 
 }
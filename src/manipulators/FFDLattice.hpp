@@ -26,6 +26,9 @@
 
 #include "Lattice.hpp"
 
+/*! Number of points evaluated together in a block by the FFDLattice list evaluator. */
+#define FFDLATTICE_EVAL_BLOCK 64
+
 namespace mimmo{
 
 /*!
@@ -127,6 +130,8 @@ namespace mimmo{
  * - <B>CoordType</B>: Set Boundary conditions for each NURBS interpolant on their extrema. Available choice are <tt>CLAMPED,SYMMETRIC,UNCLAMPED, PERIODIC</tt>;
  * - <B>Degrees</B>: degrees for NURBS interpolant in each spatial direction;
  * - <B>DisplGlobal</B>:0/1 use shape-local/global x,y,z reference system to define displacements of lattice node;
+ * - <B>CachedEvaluation</B>:0/1 store the point-to-control-node weights on first execution and reuse them
+ *   in the following ones (see FFDLattice::setCachedEvaluation);
  *
  * Geometry, displacements field and filter field have to be mandatorily passed through port.
  */
@@ -148,6 +153,23 @@ private:
     dmpvector1D   m_filter;      /**< Filter scalar field defined on geometry nodes for displacements modulation*/
     bool         m_bfilter;      /**< Boolean to recognize if a filter field for for displacements modulation is set or not */
 
+    //cached evaluation
+    bool         m_cacheActive;   /**< True if cached evaluation of the deformation is enabled */
+    bool         m_cacheValid;    /**< True if cached structures are coherent with current lattice and geometry */
+    MimmoObject* m_cacheGeometry; /**< Geometry the cache was built on */
+    long         m_cacheRevision; /**< Revision of the geometry the cache was built on */
+    ShapeType    m_cacheShapeType;/**< Shape type of the lattice the cache was built on */
+    darray3E     m_cacheOrigin;   /**< Origin of the lattice the cache was built on */
+    darray3E     m_cacheSpan;     /**< Span of the lattice the cache was built on */
+    darray3E     m_cacheInfLimits;/**< Inferior limits of the lattice the cache was built on */
+    dmatrix33E   m_cacheRefSystem;/**< Reference system of the lattice the cache was built on */
+    std::array<CoordType,3> m_cacheCoordType; /**< Coordinate types of the lattice the cache was built on */
+    livector1D   m_cacheList;     /**< Ids of the geometry vertices included in the lattice */
+    dvecarr3E    m_cacheLocal;    /**< Local coordinates of the included vertices */
+    int          m_cacheStencil;  /**< Number of control nodes influencing each vertex */
+    ivector1D    m_cacheNodes;    /**< Full grid indices of control nodes influencing each vertex, m_cacheStencil per vertex */
+    dvector1D    m_cacheCoeffs;   /**< Weighted tensor-product basis coefficient of each influencing control node */
+
 public:
     FFDLattice();
     FFDLattice(const bitpit::Config::Section & rootXML);
@@ -173,6 +195,7 @@ public:
     dmpvecarr3E* getDeformation();
     bool         isDisplGlobal();
     iarray3E     getDegrees();
+    bool         isCachedEvaluation();
 
     void         setDegrees(iarray3E curveDegrees);
     void         setDisplacements(dvecarr3E displacements);
@@ -187,6 +210,8 @@ public:
     void         setNodalWeight(dvector1D );
 
     void        setFilter(dmpvector1D * );
+    void        setCachedEvaluation(bool flag);
+    void        clearCache();
 
     //plotting wrappers
     void        plotGrid(std::string directory, std::string filename, int counter, bool binary, bool deformed);
@@ -213,15 +238,19 @@ protected:
     virtual void plotOptionalResults();
     void         swap(FFDLattice &) noexcept;
     void         checkFilter();
+    void         checkCache();
 
 private:
     //Nurbs Evaluators
     darray3E    nurbsEvaluator(darray3E &);
     dvecarr3E   nurbsEvaluator(livector1D &);
     double      nurbsEvaluatorScalar(darray3E &, int);
+    void        buildCache(livector1D &);
+    dvecarr3E   cachedEvaluator();
 
     //Nurbs utilities
     dvector1D    basisITS0(int k, int pos, double coord);
+    void         basisITS0(int k, int pos, double coord, double * basis, double * left, double * right);
     dvector1D    getNodeSpacing(int dir);
 
     //knots mantenaince utilities
@@ -23,6 +23,10 @@
  \ *---------------------------------------------------------------------------*/
 
 #include "MRBF.hpp"
+#include <chrono>
+#if MIMMO_ENABLE_BITPIT_LA
+#include <bitpit_LA.hpp>
+#endif
 
 namespace mimmo{
 
@@ -36,6 +40,12 @@ MRBF::MRBF(){
 	m_bfilter = false;
 	m_SRRatio = -1.0;
     m_functype = -1;
+    m_sparseSolve = false;
+    m_sparseTol = 1.0e-8;
+    m_sparseRestart = 30;
+    m_farFieldTol = 0.0;
+    m_gridSpacing = 0.0;
+    m_gridDim = {{0,0,0}};
 };
 
 /*!
@@ -51,6 +61,12 @@ MRBF::MRBF(const bitpit::Config::Section & rootXML){
 	m_bfilter = false;
 	m_SRRatio = -1.0;
     m_functype = -1;
+    m_sparseSolve = false;
+    m_sparseTol = 1.0e-8;
+    m_sparseRestart = 30;
+    m_farFieldTol = 0.0;
+    m_gridSpacing = 0.0;
+    m_gridDim = {{0,0,0}};
 
 	std::string fallback_name = "ClassNONE";
 	std::string input = rootXML.get("ClassName", fallback_name);
@@ -75,6 +91,12 @@ MRBF::MRBF(const MRBF & other):BaseManipulation(other), bitpit::RBF(other){
 	m_supRIsValue = other.m_supRIsValue;
 	m_bfilter = other.m_bfilter;
     m_functype = other.m_functype;
+    m_sparseSolve = other.m_sparseSolve;
+    m_sparseTol = other.m_sparseTol;
+    m_sparseRestart = other.m_sparseRestart;
+    m_farFieldTol = other.m_farFieldTol;
+    m_gridSpacing = 0.0;
+    m_gridDim = {{0,0,0}};
 	if(m_bfilter)    m_filter = other.m_filter;
 };
 
@@ -98,6 +120,17 @@ void MRBF::swap(MRBF & x) noexcept
 	std::swap(m_supRIsValue, x.m_supRIsValue);
 	std::swap(m_bfilter, x.m_bfilter);
     std::swap(m_functype, x.m_functype);
+    std::swap(m_sparseSolve, x.m_sparseSolve);
+    std::swap(m_sparseTol, x.m_sparseTol);
+    std::swap(m_sparseRestart, x.m_sparseRestart);
+    std::swap(m_farFieldTol, x.m_farFieldTol);
+	std::swap(m_gridOrigin, x.m_gridOrigin);
+	std::swap(m_gridSpacing, x.m_gridSpacing);
+	std::swap(m_gridDim, x.m_gridDim);
+	m_gridOffsets.swap(x.m_gridOffsets);
+	m_gridNodes.swap(x.m_gridNodes);
+	m_tree.swap(x.m_tree);
+	m_treeNodes.swap(x.m_treeNodes);
 	m_filter.swap(x.m_filter);
 	m_displ.swap(x.m_displ);
 	RBF::swap(x);
@@ -162,6 +195,8 @@ MRBF::setMode(int type){
 	break;
 	case 2 : setMode(MRBFSol::GREEDY);
 	break;
+	case 3 : setMode(MRBFSol::GREEDYINCR);
+	break;
 	default: setMode(MRBFSol::NONE);
 	break;
 	}
@@ -375,7 +410,8 @@ MRBF::setSupportRadiusValue(double suppR_){
 }
 
 /*!It sets the tolerance for greedy - interpolation algorithm.
- * Tolerance infos are not used in MRBFSol::NONE mode.
+ * Tolerance infos are not used in MRBFSol::NONE and MRBFSol::WHOLE modes
+ * (see MRBF::setSparseSolverTolerance for the sparse iterative solver).
  * \param[in] tol Target tolerance.
  */
 void
@@ -383,6 +419,97 @@ MRBF::setTol(double tol){
 	m_tol = tol;
 }
 
+/*!
+ * Activate/deactivate the sparse iterative solver for MRBFSol::WHOLE interpolation.
+ * If active, and the RBF kernel is compactly supported, the interpolation matrix is assembled
+ * as a sparse matrix and solved with the PETSc-backed bitpit::SystemSolver (restarted GMRES,
+ * see MRBF::setSparseSolverTolerance and MRBF::setSparseSolverRestart).
+ * Otherwise (global kernels or bitpit LA module not available), or if the iterative solver
+ * does not converge, the dense solver of bitpit::RBF is used.
+ * \param[in] sparse true to activate the sparse solver.
+ */
+void
+MRBF::setSparseSolver(bool sparse){
+	m_sparseSolve = sparse;
+}
+
+/*!
+ * \return true if the sparse iterative solver is requested for MRBFSol::WHOLE interpolation.
+ */
+bool
+MRBF::isSparseSolver(){
+	return m_sparseSolve;
+}
+
+/*!
+ * Set the relative residual tolerance of the sparse iterative solver (see MRBF::setSparseSolver).
+ * It is independent from the greedy tolerance of MRBF::setTol. Default is 1.0e-8.
+ * \param[in] tol relative tolerance of the sparse iterative solver (must be > 0).
+ */
+void
+MRBF::setSparseSolverTolerance(double tol){
+	if(tol > 0.0)    m_sparseTol = tol;
+}
+
+/*!
+ * \return relative residual tolerance of the sparse iterative solver.
+ */
+double
+MRBF::getSparseSolverTolerance(){
+	return m_sparseTol;
+}
+
+/*!
+ * Set the number of iterations between two restarts of the GMRES sparse iterative solver
+ * (see MRBF::setSparseSolver). Larger values help convergence of badly conditioned systems
+ * (large support radius compared to nodes spacing), at the price of memory. Default is 30.
+ * \param[in] restart GMRES restart (must be > 0).
+ */
+void
+MRBF::setSparseSolverRestart(int restart){
+	if(restart > 0)    m_sparseRestart = restart;
+}
+
+/*!
+ * \return GMRES restart of the sparse iterative solver.
+ */
+int
+MRBF::getSparseSolverRestart(){
+	return m_sparseRestart;
+}
+
+/*!
+ * Set the tolerance of the far-field approximated evaluation, used with global kernels decaying
+ * with the distance only (mimmo heaviside and bitpit gaussian kernels); for any other kernel
+ * a warning is issued at execution and exact evaluation is performed.
+ * A cluster of RBF nodes is approximated by a single kernel evaluation in its center (monopole
+ * approximation, no higher order terms) when the kernel variation over the cluster, seen from
+ * the target point, is lower than the tolerance. The error on each field in a point is then
+ * bounded by tol * sum(|w_i|), the sum running over the absolute weights of all the active nodes.
+ * A value <= 0 (default) disables the approximation and exact evaluation is performed.
+ * \param[in] tol kernel tolerance of the far-field approximation.
+ */
+void
+MRBF::setFarFieldTolerance(double tol){
+	m_farFieldTol = std::max(0.0, tol);
+}
+
+/*!
+ * \return tolerance of the far-field approximated evaluation. 0 means exact evaluation.
+ */
+double
+MRBF::getFarFieldTolerance(){
+	return m_farFieldTol;
+}
+
+/*!
+ * \return wall time in seconds of each iteration of the last MRBFSol::GREEDYINCR node selection.
+ */
+dvector1D
+MRBF::getGreedyIterationTimes(){
+	return m_greedyTimes;
+}
+
 /*!
  * Set a field  of 3D displacements on your RBF Nodes. According to MRBFSol mode
  * active in the class set: displacements as direct RBF weights coefficients in MRBFSol::NONE mode,
@@ -591,17 +718,60 @@ MRBF::execute(){
 	RBF::setSupportRadius(radius);
 
 
-	if (m_solver == MRBFSol::WHOLE)    solve();
+	if (m_solver == MRBFSol::WHOLE){
+		if(!m_sparseSolve || solveSparse() != 0)    solve();
+	}
 	if (m_solver == MRBFSol::GREEDY)    greedy(m_tol);
+	if (m_solver == MRBFSol::GREEDYINCR)    greedyIncremental(m_tol);
+
+	//compact kernels: index active nodes to evaluate each vertex on its neighbourhood only.
+	bool localEval = hasCompactSupport();
+	if(localEval)    buildNodeGrid();
+
+	//global kernels: optional far-field approximation on the hierarchy of nodes clusters.
+	bool treeEval = !localEval && m_farFieldTol > 0.0;
+	if(treeEval && !hasDecayingKernel()){
+		(*m_log)<<"warning: "<<m_name<<" far-field approximation is available only for kernels decaying with the distance. Using exact evaluation."<<std::endl;
+		treeEval = false;
+	}
+	if(treeEval)    buildNodeTree();
 
 
-	dvector1D displ;
-	darray3E adispl;
-	for(const auto & vertex : container->getVertices()){
-		displ = bitpit::RBF::evalRBF(vertex.getCoords());
-		for (int j=0; j<3; ++j)
-			adispl[j] = displ[j];
-		m_displ.insert(vertex.getId(), adispl);
+	//Pre-size the displacement field in vertex order and store its raw positions,
+	//so that each vertex evaluation writes in its own slot (thread safe and deterministic).
+	long nVertices = container->getNVertices();
+	livector1D vertexIds(nVertices);
+	std::vector<std::size_t> rawDispl(nVertices);
+	{
+		long count = 0;
+		darray3E zero = {{0.0,0.0,0.0}};
+		for(const auto & vertex : container->getVertices()){
+			vertexIds[count] = vertex.getId();
+			rawDispl[count] = m_displ.insert(vertexIds[count], zero).getRawIndex();
+			++count;
+		}
+	}
+
+	bitpit::PiercedVector<bitpit::Vertex> & vertices = container->getVertices();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#endif
+	{
+		//candidate nodes buffer of the thread, reused by all its vertices.
+		ivector1D candidates;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp for schedule(static)
+#endif
+		for(long i=0; i<nVertices; ++i){
+			const darray3E & coords = vertices[vertexIds[i]].getCoords();
+			dvector1D displ;
+			if(localEval)       displ = evalRBFLocal(coords, candidates);
+			else if(treeEval)   displ = evalRBFTree(coords);
+			else                displ = bitpit::RBF::evalRBF(coords);
+			darray3E & adispl = m_displ.rawAt(rawDispl[i]);
+			for (int j=0; j<3; ++j)
+				adispl[j] = displ[j];
+		}
 	}
 
 	//if m_filter is active;
@@ -609,10 +779,12 @@ MRBF::execute(){
 
 		checkFilter();
 
-		long int ID;
-		for (const auto & vertex : m_geometry->getVertices()){
-			ID = vertex.getId();
-			m_displ[ID] = m_displ[ID] * m_filter[ID];
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for(long i=0; i<nVertices; ++i){
+			darray3E & adispl = m_displ.rawAt(rawDispl[i]);
+			adispl = adispl * m_filter[vertexIds[i]];
 		}
 	}
 
@@ -651,6 +823,567 @@ MRBF::checkFilter(){
 	}
 }
 
+/*!
+ * Check if the RBF kernel currently set in the class is compactly supported,
+ * i.e. it is identically zero for distances greater than the support radius.
+ * mimmo heaviside kernels and bitpit gaussian/custom kernels are considered global.
+ * \return true if the kernel has a compact support.
+ */
+bool
+MRBF::hasCompactSupport(){
+	if(m_functype >= 0)    return false;
+	switch(RBF::getFunctionType()){
+	case bitpit::RBFBasisFunction::WENDLANDC2:
+	case bitpit::RBFBasisFunction::LINEAR:
+	case bitpit::RBFBasisFunction::C1C0:
+	case bitpit::RBFBasisFunction::C2C0:
+	case bitpit::RBFBasisFunction::C0C1:
+	case bitpit::RBFBasisFunction::C1C1:
+	case bitpit::RBFBasisFunction::C2C1:
+	case bitpit::RBFBasisFunction::C0C2:
+	case bitpit::RBFBasisFunction::C1C2:
+	case bitpit::RBFBasisFunction::C2C2:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*!
+ * Check if the RBF kernel currently set in the class is global and monotonically decaying to zero
+ * with the distance (mimmo heaviside kernels and bitpit gaussian kernels). Custom kernels are
+ * not known and are considered not decaying.
+ * \return true if the kernel is decaying with the distance.
+ */
+bool
+MRBF::hasDecayingKernel(){
+	if(m_functype >= 0)    return true;
+	switch(RBF::getFunctionType()){
+	case bitpit::RBFBasisFunction::GAUSS90:
+	case bitpit::RBFBasisFunction::GAUSS95:
+	case bitpit::RBFBasisFunction::GAUSS99:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*!
+ * Build a uniform grid over the active RBF nodes. The cell size is at least equal to the
+ * current support radius, so that all the nodes influencing a point are found in the
+ * 27 cells surrounding it. The cell size is enlarged if the grid would have too many
+ * (empty) cells with respect to the number of nodes.
+ * Nodes are stored per cell in ascending order of their RBF id.
+ */
+void
+MRBF::buildNodeGrid(){
+
+	m_gridOffsets.clear();
+	m_gridNodes.clear();
+	m_gridDim = {{0,0,0}};
+	m_gridSpacing = RBF::getSupportRadius();
+
+	int nnodes = getTotalNodesCount();
+	darray3E pmax;
+	m_gridOrigin.fill(std::numeric_limits<double>::max());
+	pmax.fill(-1.0*std::numeric_limits<double>::max());
+	long nactive = 0;
+	for(int i=0; i<nnodes; ++i){
+		if(!m_activeNodes[i])    continue;
+		for(int d=0; d<3; ++d){
+			m_gridOrigin[d] = std::min(m_gridOrigin[d], m_node[i][d]);
+			pmax[d] = std::max(pmax[d], m_node[i][d]);
+		}
+		++nactive;
+	}
+	if(nactive == 0 || m_gridSpacing <= 0.0)    return;
+
+	//limit the number of cells to a multiple of the active nodes.
+	double maxCells = double(std::max(8*nactive, long(27)));
+	double nCells;
+	darray3E dims;
+	do{
+		nCells = 1.0;
+		for(int d=0; d<3; ++d){
+			dims[d] = std::floor((pmax[d] - m_gridOrigin[d]) / m_gridSpacing) + 1.0;
+			nCells *= dims[d];
+		}
+		if(nCells > maxCells)    m_gridSpacing *= 2.0;
+	}while(nCells > maxCells);
+
+	for(int d=0; d<3; ++d){
+		m_gridDim[d] = static_cast<int>(dims[d]);
+	}
+
+	//counting sort of active nodes on grid cells.
+	long ncells = long(m_gridDim[0])*long(m_gridDim[1])*long(m_gridDim[2]);
+	m_gridOffsets.assign(ncells+1, 0);
+	livector1D nodeCell(nnodes, -1);
+	for(int i=0; i<nnodes; ++i){
+		if(!m_activeNodes[i])    continue;
+		iarray3E ijk;
+		for(int d=0; d<3; ++d){
+			ijk[d] = std::min(static_cast<int>((m_node[i][d] - m_gridOrigin[d]) / m_gridSpacing), m_gridDim[d]-1);
+		}
+		nodeCell[i] = ijk[0] + long(m_gridDim[0])*(ijk[1] + long(m_gridDim[1])*ijk[2]);
+		++m_gridOffsets[nodeCell[i]+1];
+	}
+	for(long c=0; c<ncells; ++c){
+		m_gridOffsets[c+1] += m_gridOffsets[c];
+	}
+
+	m_gridNodes.resize(nactive);
+	livector1D fill(m_gridOffsets.begin(), m_gridOffsets.end()-1);
+	for(int i=0; i<nnodes; ++i){
+		if(nodeCell[i] < 0)    continue;
+		m_gridNodes[fill[nodeCell[i]]] = i;
+		++fill[nodeCell[i]];
+	}
+}
+
+/*!
+ * Collect the active RBF nodes within the support radius from a target point, visiting
+ * the cells of the RBF nodes grid surrounding it (see MRBF::buildNodeGrid).
+ * Candidates are sorted by RBF id, to accumulate their contributions in the same order of
+ * bitpit::RBF::evalRBF. The list is meant to be reused by the caller across points,
+ * so that no allocation occurs once its capacity is large enough.
+ * \param[in] point target point coordinates
+ * \param[out] candidates RBF ids of the candidate nodes, in ascending order
+ * \return false if the point is too far from the grid to be influenced by any node.
+ */
+bool
+MRBF::findGridCandidates(const darray3E & point, ivector1D & candidates){
+
+	candidates.clear();
+	if(m_gridOffsets.empty())    return false;
+
+	iarray3E lo, hi;
+	for(int d=0; d<3; ++d){
+		double c = std::floor((point[d] - m_gridOrigin[d]) / m_gridSpacing);
+		if(c < -1.0 || c > double(m_gridDim[d]))    return false;
+		lo[d] = std::max(0, static_cast<int>(c) - 1);
+		hi[d] = std::min(m_gridDim[d] - 1, static_cast<int>(c) + 1);
+	}
+
+	double radius2 = RBF::getSupportRadius()*RBF::getSupportRadius();
+	for(int k=lo[2]; k<=hi[2]; ++k){
+		for(int j=lo[1]; j<=hi[1]; ++j){
+			for(int i=lo[0]; i<=hi[0]; ++i){
+				long cell = i + long(m_gridDim[0])*(j + long(m_gridDim[1])*k);
+				for(long pos=m_gridOffsets[cell]; pos<m_gridOffsets[cell+1]; ++pos){
+					const darray3E & node = m_node[m_gridNodes[pos]];
+					double dx = point[0] - node[0];
+					double dy = point[1] - node[1];
+					double dz = point[2] - node[2];
+					if(dx*dx + dy*dy + dz*dz <= radius2)    candidates.push_back(m_gridNodes[pos]);
+				}
+			}
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+	return true;
+}
+
+/*!
+ * Evaluate RBF fields in a target point, using only the active nodes indexed in the
+ * neighbouring cells of the RBF nodes grid (see MRBF::buildNodeGrid).
+ * Contributions are accumulated in ascending order of RBF node id, as in bitpit::RBF::evalRBF,
+ * so the result matches the full evaluation for compactly supported kernels.
+ * \param[in] point target point coordinates
+ * \param[in,out] candidates buffer of candidate nodes, reused across calls
+ * \return RBF fields values in the target point
+ */
+dvector1D
+MRBF::evalRBFLocal(const darray3E & point, ivector1D & candidates){
+
+	int nfields = getDataCount();
+	dvector1D values(nfields, 0.0);
+	if(!findGridCandidates(point, candidates))    return values;
+
+	double radius = RBF::getSupportRadius();
+	for(int idx : candidates){
+		double basis = evalBasis(norm2(point - m_node[idx]) / radius);
+		for(int j=0; j<nfields; ++j){
+			values[j] += basis * m_weight[j][idx];
+		}
+	}
+	return values;
+}
+
+/*!
+ * Incremental greedy selection of RBF nodes (MRBFSol::GREEDYINCR mode).
+ * Starting from no active nodes, at each iteration the candidate node with the maximum norm of the
+ * interpolation residual is activated, until the maximum residual is below the tolerance.
+ * The interpolant is built on the Newton basis of the active nodes: the basis function of the
+ * new node is its kernel minus its projection on the previous basis functions, so it vanishes on
+ * the already active nodes and the residual is updated with this single new function.
+ * Each iteration costs N kernel evaluations and O(N k) operations for N nodes and k active nodes,
+ * and the Newton basis values on all the nodes are stored (O(N k) memory).
+ * The pivots of the Newton basis are the ones of the LDL^T factorization of the interpolation matrix
+ * of the active nodes: candidates leading to a (numerically) singular factorization are discarded.
+ * Final weights are recovered by backward substitution on the factor L (O(k^2)).
+ * Resulting weights are stored in the m_weight member, the selected nodes are left active.
+ * Wall time of each iteration is stored and available through MRBF::getGreedyIterationTimes.
+ * \param[in] tolerance target maximum norm of the residual on RBF nodes.
+ * \return number of selected nodes.
+ */
+int
+MRBF::greedyIncremental(double tolerance){
+
+	int nnodes = getTotalNodesCount();
+	int nfields = getDataCount();
+
+	m_greedyTimes.clear();
+	m_weight.assign(nfields, dvector1D(nnodes, 0.0));
+	for(int i=0; i<nnodes; ++i){
+		m_activeNodes[i] = false;
+	}
+	if(nnodes == 0 || nfields == 0)    return 0;
+
+	double radius = RBF::getSupportRadius();
+	double diag = evalBasis(0.0);
+
+	dvector2D residual(m_value.begin(), m_value.begin() + nfields);
+	bvector1D rejected(nnodes, false);
+	ivector1D selected;
+	dvector2D newton;               // Newton basis functions of selected nodes, evaluated on all the nodes
+	dvector2D lower;                // strictly lower rows of the unit lower triangular factor L
+	dvector1D pivot;                // diagonal factor D
+	dvector2D forward(nfields);     // solution z of L z = values on selected nodes
+	double maxResidual = 0.0;
+
+	std::chrono::time_point<std::chrono::system_clock> start, end;
+	while(true){
+
+		start = std::chrono::system_clock::now();
+
+		//candidate with the maximum residual
+		int best = -1;
+		maxResidual = 0.0;
+		for(int i=0; i<nnodes; ++i){
+			if(m_activeNodes[i] || rejected[i])    continue;
+			double res = 0.0;
+			for(int j=0; j<nfields; ++j){
+				res += residual[j][i]*residual[j][i];
+			}
+			res = std::sqrt(res);
+			if(res > maxResidual){
+				maxResidual = res;
+				best = i;
+			}
+		}
+		if(best < 0 || maxResidual <= tolerance)    break;
+
+		//new row of the factorization from the Newton basis in the candidate: l = D^-1 N(x_best), d = diag - l.N(x_best)
+		int k = selected.size();
+		dvector1D l(k);
+		double d = diag;
+		for(int j=0; j<k; ++j){
+			l[j] = newton[j][best] / pivot[j];
+			d -= l[j]*newton[j][best];
+		}
+		if(std::abs(d) <= 1.0E-12*std::abs(diag)){
+			rejected[best] = true;
+			continue;
+		}
+		selected.push_back(best);
+		lower.push_back(l);
+		pivot.push_back(d);
+		m_activeNodes[best] = true;
+
+		//the residual in the new node is its forward substitution value
+		dvector1D coeff(nfields);
+		for(int f=0; f<nfields; ++f){
+			forward[f].push_back(residual[f][best]);
+			coeff[f] = residual[f][best] / d;
+		}
+
+		//Newton basis function of the new node and residual update on remaining candidates
+		dvector1D basis(nnodes, 0.0);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for(int i=0; i<nnodes; ++i){
+			if(m_activeNodes[i] || rejected[i])    continue;
+			double value = evalBasis(norm2(m_node[i] - m_node[best]) / radius);
+			for(int j=0; j<k; ++j){
+				value -= l[j]*newton[j][i];
+			}
+			basis[i] = value;
+			for(int f=0; f<nfields; ++f){
+				residual[f][i] -= coeff[f]*value;
+			}
+		}
+		basis[best] = d;
+		newton.push_back(std::move(basis));
+
+		end = std::chrono::system_clock::now();
+		m_greedyTimes.push_back(std::chrono::duration<double>(end - start).count());
+
+		m_log->setPriority(bitpit::log::Verbosity::DEBUG);
+		(*m_log)<<m_name<<" greedy iteration "<<m_greedyTimes.size()<<" : active nodes "<<selected.size()
+				<<", max residual "<<maxResidual<<", time "<<m_greedyTimes.back()<<" s"<<std::endl;
+		m_log->setPriority(bitpit::log::Verbosity::NORMAL);
+	}
+
+	//weights of selected nodes by backward substitution: L^T w = D^-1 z
+	int nselected = selected.size();
+	for(int f=0; f<nfields; ++f){
+		dvector1D w(nselected);
+		for(int j=nselected-1; j>=0; --j){
+			w[j] = forward[f][j] / pivot[j];
+			for(int m=j+1; m<nselected; ++m){
+				w[j] -= lower[m][j]*w[m];
+			}
+			m_weight[f][selected[j]] = w[j];
+		}
+	}
+
+	double totalTime = 0.0;
+	for(double val : m_greedyTimes){
+		totalTime += val;
+	}
+	(*m_log)<<m_name<<" incremental greedy selected "<<selected.size()<<" of "<<nnodes<<" nodes in "
+			<<m_greedyTimes.size()<<" iterations ("<<totalTime<<" s), max residual "<<maxResidual<<std::endl;
+
+	return int(selected.size());
+}
+
+/*!
+ * Build the binary hierarchy of clusters of active RBF nodes used for far-field evaluation.
+ * Each cluster is split at the median of the longest side of its bounding box, until
+ * clusters hold a few nodes. For each cluster the sum of the nodes weights is stored.
+ */
+void
+MRBF::buildNodeTree(){
+
+	const int leafSize = 16;
+
+	m_tree.clear();
+	m_treeNodes.clear();
+
+	int nnodes = getTotalNodesCount();
+	int nfields = getDataCount();
+	for(int i=0; i<nnodes; ++i){
+		if(m_activeNodes[i])    m_treeNodes.push_back(i);
+	}
+	if(m_treeNodes.empty())    return;
+
+	m_tree.reserve(4*(m_treeNodes.size()/leafSize + 1));
+	RBFCluster root;
+	root.begin = 0;
+	root.end = int(m_treeNodes.size());
+	m_tree.push_back(root);
+
+	ivector1D stack(1, 0);
+	while(!stack.empty()){
+		int icl = stack.back();
+		stack.pop_back();
+		int begin = m_tree[icl].begin;
+		int end = m_tree[icl].end;
+
+		darray3E pmin, pmax;
+		pmin.fill(std::numeric_limits<double>::max());
+		pmax.fill(-1.0*std::numeric_limits<double>::max());
+		dvector1D weight(nfields, 0.0);
+		for(int k=begin; k<end; ++k){
+			int idx = m_treeNodes[k];
+			for(int d=0; d<3; ++d){
+				pmin[d] = std::min(pmin[d], m_node[idx][d]);
+				pmax[d] = std::max(pmax[d], m_node[idx][d]);
+			}
+			for(int j=0; j<nfields; ++j){
+				weight[j] += m_weight[j][idx];
+			}
+		}
+		darray3E center = 0.5*(pmin + pmax);
+		double radius = 0.0;
+		for(int k=begin; k<end; ++k){
+			radius = std::max(radius, norm2(m_node[m_treeNodes[k]] - center));
+		}
+
+		m_tree[icl].center = center;
+		m_tree[icl].radius = radius;
+		m_tree[icl].weight.swap(weight);
+		m_tree[icl].child = {{-1,-1}};
+		if(end - begin <= leafSize)    continue;
+
+		//split on the median of the longest bounding box side.
+		int axis = 0;
+		for(int d=1; d<3; ++d){
+			if((pmax[d] - pmin[d]) > (pmax[axis] - pmin[axis]))    axis = d;
+		}
+		int mid = begin + (end - begin)/2;
+		std::nth_element(m_treeNodes.begin() + begin, m_treeNodes.begin() + mid, m_treeNodes.begin() + end,
+				[&](int a, int b){ return m_node[a][axis] < m_node[b][axis]; });
+
+		RBFCluster left, right;
+		left.begin = begin;
+		left.end = mid;
+		right.begin = mid;
+		right.end = end;
+		m_tree[icl].child[0] = int(m_tree.size());
+		m_tree.push_back(left);
+		m_tree[icl].child[1] = int(m_tree.size());
+		m_tree.push_back(right);
+		stack.push_back(m_tree[icl].child[0]);
+		stack.push_back(m_tree[icl].child[1]);
+	}
+}
+
+/*!
+ * Evaluate RBF fields in a target point with the far-field approximation (see MRBF::setFarFieldTolerance).
+ * The hierarchy of clusters is visited from the root: clusters whose kernel variation seen from the
+ * point is below the tolerance contribute with the kernel evaluated in their center times the sum of
+ * their weights; otherwise their children are visited, and the nodes of leaf clusters are evaluated exactly.
+ * Since the kernel is monotone with the distance, each approximated node differs from the cluster center
+ * value at most by the variation, so the error on each field is bounded by tolerance * sum(|w_i|).
+ * \param[in] point target point coordinates
+ * \return approximated RBF fields values in the target point
+ */
+dvector1D
+MRBF::evalRBFTree(const darray3E & point){
+
+	int nfields = getDataCount();
+	dvector1D values(nfields, 0.0);
+	if(m_tree.empty())    return values;
+
+	double radius = RBF::getSupportRadius();
+	ivector1D stack(1, 0);
+	while(!stack.empty()){
+		const RBFCluster & cluster = m_tree[stack.back()];
+		stack.pop_back();
+
+		double dist = norm2(point - cluster.center);
+		if(dist > cluster.radius){
+			double basis = evalBasis(dist / radius);
+			double variation = std::max(std::abs(evalBasis((dist - cluster.radius) / radius) - basis),
+										std::abs(evalBasis((dist + cluster.radius) / radius) - basis));
+			if(variation <= m_farFieldTol){
+				for(int j=0; j<nfields; ++j){
+					values[j] += basis * cluster.weight[j];
+				}
+				continue;
+			}
+		}
+
+		if(cluster.child[0] < 0){
+			for(int k=cluster.begin; k<cluster.end; ++k){
+				int idx = m_treeNodes[k];
+				double basis = evalBasis(norm2(point - m_node[idx]) / radius);
+				for(int j=0; j<nfields; ++j){
+					values[j] += basis * m_weight[j][idx];
+				}
+			}
+		}else{
+			stack.push_back(cluster.child[0]);
+			stack.push_back(cluster.child[1]);
+		}
+	}
+	return values;
+}
+
+/*!
+ * Solve the RBF interpolation problem on the active nodes for all the data fields, assembling
+ * the interpolation matrix as a sparse matrix (compactly supported kernels only) and solving it
+ * with the preconditioned iterative solver bitpit::SystemSolver.
+ * The matrix is factorized/preconditioned once and reused for all the data fields.
+ * Resulting weights are stored in the m_weight member, as bitpit::RBF::solve does.
+ * \return 0 if the sparse solve was performed, -1 if it is not available for the current kernel/build
+ * or if the iterative solver did not converge for some field.
+ */
+int
+MRBF::solveSparse(){
+
+#if MIMMO_ENABLE_BITPIT_LA
+	if(!hasCompactSupport()){
+		(*m_log)<<"warning: "<<m_name<<" sparse solver is available only for compactly supported RBF kernels. Using dense solver."<<std::endl;
+		return -1;
+	}
+
+	buildNodeGrid();
+
+	int nnodes = getTotalNodesCount();
+	int nfields = getDataCount();
+	ivector1D rows(nnodes, -1);
+	ivector1D activeSet;
+	activeSet.reserve(nnodes);
+	for(int i=0; i<nnodes; ++i){
+		if(!m_activeNodes[i])    continue;
+		rows[i] = int(activeSet.size());
+		activeSet.push_back(i);
+	}
+	long nDOFs = activeSet.size();
+
+	//evaluate each row of the interpolation matrix on the grid neighbourhood of the node.
+	std::vector<livector1D> patterns(nDOFs);
+	dvector2D values(nDOFs);
+	double radius = RBF::getSupportRadius();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel
+#endif
+	{
+		ivector1D candidates;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+		for(long r=0; r<nDOFs; ++r){
+			const darray3E & node = m_node[activeSet[r]];
+			findGridCandidates(node, candidates);
+			for(int idx : candidates){
+				double basis = evalBasis(norm2(node - m_node[idx]) / radius);
+				if(basis == 0.0 && idx != activeSet[r])    continue;
+				patterns[r].push_back(rows[idx]);
+				values[r].push_back(basis);
+			}
+		}
+	}
+
+	long nNZ(0);
+	for(const auto & pattern : patterns){
+		nNZ += pattern.size();
+	}
+
+	bitpit::SparseMatrix matrix(nDOFs, nDOFs, nNZ);
+	for(long r=0; r<nDOFs; ++r){
+		matrix.addRow(patterns[r].size(), patterns[r].data(), values[r].data());
+	}
+	matrix.assembly();
+	std::vector<livector1D>().swap(patterns);
+	dvector2D().swap(values);
+
+	bitpit::SystemSolver solver;
+	solver.getKSPOptions().rtol = m_sparseTol;
+	solver.getKSPOptions().subrtol = m_sparseTol;
+	solver.getKSPOptions().restart = m_sparseRestart;
+	solver.assembly(matrix);
+
+	m_weight.resize(nfields);
+	dvector1D rhs(nDOFs), result(nDOFs);
+	for(int j=0; j<nfields; ++j){
+		for(long r=0; r<nDOFs; ++r){
+			rhs[r] = m_value[j][activeSet[r]];
+		}
+		std::fill(result.begin(), result.end(), 0.0);
+		solver.solve(rhs, &result);
+		const bitpit::KSPStatus & status = solver.getKSPStatus();
+		if(status.error != 0 || status.convergence < 0){
+			(*m_log)<<"warning: "<<m_name<<" sparse solver did not converge (reason "<<int(status.convergence)<<", "<<int(status.its)<<" iterations). Using dense solver."<<std::endl;
+			return -1;
+		}
+
+		m_weight[j].assign(nnodes, 0.0);
+		for(long r=0; r<nDOFs; ++r){
+			m_weight[j][activeSet[r]] = result[r];
+		}
+	}
+	return 0;
+#else
+	(*m_log)<<"warning: "<<m_name<<" sparse solver not available: bitpit LA module missing. Using dense solver."<<std::endl;
+	return -1;
+#endif
+}
+
 /*!
  * Plot Optional results of the class. It plots the RBF control nodes as a point cloud
  * in *.vtu format, for both original/moved control nodes.
@@ -765,11 +1498,51 @@ MRBF::absorbSectionXML(const bitpit::Config::Section & slotXML, std::string name
 			std::stringstream ss(bitpit::utils::string::trim(input));
 			ss >> value;
 			value = std::max(value, 0);
-			if(value > 2) value = 0;
+			if(value > 3) value = 0;
 		}
 		setMode(value);
 	};
 
+	if(slotXML.hasOption("SparseSolver")){
+		input = slotXML.get("SparseSolver");
+		bool value = false;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss >> value;
+		}
+		setSparseSolver(value);
+	};
+
+	if(slotXML.hasOption("SparseSolverTolerance")){
+		input = slotXML.get("SparseSolverTolerance");
+		double value = 1.0e-8;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss >> value;
+		}
+		setSparseSolverTolerance(value);
+	};
+
+	if(slotXML.hasOption("SparseSolverRestart")){
+		input = slotXML.get("SparseSolverRestart");
+		int value = 30;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss >> value;
+		}
+		setSparseSolverRestart(value);
+	};
+
+	if(slotXML.hasOption("FarFieldTolerance")){
+		input = slotXML.get("FarFieldTolerance");
+		double value = 0.0;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss >> value;
+		}
+		setFarFieldTolerance(value);
+	};
+
 	if(slotXML.hasOption("SupportRadius")){
 		input = slotXML.get("SupportRadius");
 		double value = -1.0;
@@ -830,6 +1603,20 @@ MRBF::flushSectionXML(bitpit::Config::Section & slotXML, std::string name){
 		slotXML.set("SupportRadiusReal", ss.str());
 	}
 
+	if(m_sparseSolve){
+		slotXML.set("SparseSolver", std::to_string(int(m_sparseSolve)));
+		std::stringstream ss;
+		ss<<std::scientific<<m_sparseTol;
+		slotXML.set("SparseSolverTolerance", ss.str());
+		slotXML.set("SparseSolverRestart", std::to_string(m_sparseRestart));
+	}
+
+	if(m_farFieldTol > 0.0){
+		std::stringstream ss;
+		ss<<std::scientific<<m_farFieldTol;
+		slotXML.set("FarFieldTolerance", ss.str());
+	}
+
 	int type = getFunctionType();
 	if(type != static_cast<int>(bitpit::RBFBasisFunction::CUSTOM)){
 		slotXML.set("RBFShape", std::to_string(type));
@@ -49,7 +49,9 @@ enum class MRBFBasisFunction {
 enum class MRBFSol{
     NONE = 0,     /**< activate class as pure parameterizator. Set freely your RBF coefficients/weights */
     WHOLE = 1,    /**< activate class as pure interpolator, with RBF coefficients evaluated solving a full linear system for all active nodes.*/
-    GREEDY= 2   /**< activate class as pure interpolator, with RBF coefficients evaluated using a greedy algorithm on active nodes.*/
+    GREEDY= 2,   /**< activate class as pure interpolator, with RBF coefficients evaluated using a greedy algorithm on active nodes.*/
+    GREEDYINCR= 3   /**< activate class as pure interpolator, with RBF coefficients evaluated using a greedy algorithm on active nodes,
+                         with incremental update of the interpolant on the Newton basis of active nodes.*/
 };
 
 /*!
@@ -63,7 +65,10 @@ enum class MRBFSol{
    given externally or stored in a PointCloud MimmoObject container.
    Displacements (DOFs) for RBF nodes are provided externally.
    Default solver in execution is MRBFSol::NONE for direct parameterization.
-   Use MRBFSol::GREEDY or MRBFSol::WHOLE to activate interpolation features.
+   Use MRBFSol::GREEDY, MRBFSol::GREEDYINCR or MRBFSol::WHOLE to activate interpolation features.
+   MRBFSol::GREEDYINCR selects the same kind of greedy nodes subset of MRBFSol::GREEDY, but appends
+   each new node to the Newton basis of the interpolation space instead of solving the whole
+   system again, and updates the residual with the new basis function only (see MRBF::greedyIncremental).
  * See bitpit::RBF docs for further information.
  *
  * \n
@@ -102,10 +107,26 @@ enum class MRBFSol{
  * - <B>SupportRadius</B>: local radius of RBF function for each nodes, expressed as ratio of local geometry bounding box;
  * - <B>SupportRadiusReal</B>: local effective radius of RBF function common to each RBF node;
  * - <B>RBFShape</B>: shape of RBF function see MRBFBasisFunction and bitpit::RBFBasisFunction enums;
- * - <B>Tolerance</B>: greedy engine tolerance (meaningful for Mode 2 only);
+ * - <B>Tolerance</B>: greedy engine tolerance (Mode 2 and 3);
+ * - <B>SparseSolver</B>: boolean 0/1 solve Mode 1 interpolation with a sparse matrix and a preconditioned iterative solver.
+ *                        Meaningful only with compactly supported kernels and bitpit LA module available;
+ * - <B>SparseSolverTolerance</B>: relative residual tolerance of the sparse iterative solver (default 1.0e-8);
+ * - <B>SparseSolverRestart</B>: GMRES restart of the sparse iterative solver (default 30);
+ * - <B>FarFieldTolerance</B>: kernel tolerance of the far-field approximated evaluation for global decaying kernels (<= 0 exact evaluation);
  *
  * Geometry, filter field, RBF nodes and displacements have to be mandatorily passed through port.
  *
+ * When a compactly supported kernel is in use (bitpit WENDLANDC2, LINEAR and the CxCy polynomial family),
+ * active RBF nodes are indexed on a uniform grid and each vertex is evaluated only against the nodes
+ * lying within the support radius. Results are the same as the full evaluation.
+ * For the same kernels, MRBFSol::WHOLE interpolation can be solved assembling a sparse matrix
+ * and using the PETSc-backed bitpit::SystemSolver (see MRBF::setSparseSolver), instead of the dense
+ * direct solver of bitpit::RBF::solve. If the iterative solver does not converge the dense one is used.
+ * For global decaying kernels an optional far-field approximation is available (see MRBF::setFarFieldTolerance):
+ * active nodes are organized in a binary hierarchy of clusters and the contribution of a cluster
+ * far enough from the target point is evaluated as a single kernel evaluation in its center.
+ * The exact evaluation remains the default.
+ *
  */
 //TODO study how to manipulate supportRadius of RBF to define a local/global smoothing of RBF
 class MRBF: public BaseManipulation, public bitpit::RBF {
@@ -119,6 +140,32 @@ private:
     dmpvecarr3E  m_displ;        /**<Resulting displacements of geometry vertex.*/
     bool         m_supRIsValue;  /**<True if support radius is defined as absolute value, false if is ratio of bounding box diagonal.*/
     int          m_functype;     /**< Function type handler. If -1 refer to RBF getFunctionType method */
+    bool         m_sparseSolve;  /**< True to solve MRBFSol::WHOLE interpolation with a sparse iterative solver (compact kernels only).*/
+    double       m_sparseTol;    /**< Relative residual tolerance of the sparse iterative solver.*/
+    int          m_sparseRestart; /**< GMRES restart of the sparse iterative solver.*/
+    double       m_farFieldTol;  /**< Kernel tolerance of far-field (treecode) evaluation for global kernels. If <= 0 exact evaluation is performed.*/
+    dvector1D    m_greedyTimes;  /**< Wall time in seconds of each iteration of the last incremental greedy selection.*/
+
+    darray3E     m_gridOrigin;   /**< Origin of the uniform grid indexing active RBF nodes (compact kernels only).*/
+    double       m_gridSpacing;  /**< Cell size of the RBF nodes grid, never smaller than the support radius.*/
+    iarray3E     m_gridDim;      /**< Number of cells of the RBF nodes grid in each direction.*/
+    livector1D   m_gridOffsets;  /**< Offsets of each grid cell in the m_gridNodes list.*/
+    ivector1D    m_gridNodes;    /**< Active RBF nodes ordered by grid cell (ascending node index within each cell).*/
+
+    /*!
+        \struct RBFCluster
+        Cluster of active RBF nodes in the hierarchy used for far-field evaluation of global kernels.
+    */
+    struct RBFCluster{
+        darray3E    center;     /**< Center of the cluster bounding box.*/
+        double      radius;     /**< Maximum distance of the cluster nodes from the center.*/
+        int         begin;      /**< First position of the cluster nodes in m_treeNodes.*/
+        int         end;        /**< Past-the-end position of the cluster nodes in m_treeNodes.*/
+        iarray2E    child;      /**< Children clusters position in m_tree, -1 for leaf clusters.*/
+        dvector1D   weight;     /**< Sum of the nodes weights of the cluster, for each field.*/
+    };
+    std::vector<RBFCluster>  m_tree;       /**< Binary hierarchy of active RBF nodes clusters (root in position 0).*/
+    ivector1D                m_treeNodes;  /**< Active RBF nodes ordered by cluster.*/
 
 public:
     MRBF();
@@ -143,6 +190,11 @@ public:
     bool            getIsSupportRadiusValue();
 
     int             getFunctionType();
+    bool            isSparseSolver();
+    double          getSparseSolverTolerance();
+    int             getSparseSolverRestart();
+    double          getFarFieldTolerance();
+    dvector1D       getGreedyIterationTimes();
 
     dmpvecarr3E*     getDisplacements();
 
@@ -161,6 +213,10 @@ public:
     void            setSupportRadius(double suppR_);
     void            setSupportRadiusValue(double suppR_);
     void            setTol(double tol);
+    void            setSparseSolver(bool sparse);
+    void            setSparseSolverTolerance(double tol);
+    void            setSparseSolverRestart(int restart);
+    void            setFarFieldTolerance(double tol);
     void            setDisplacements(dvecarr3E displ);
 
     void            setFunction(const MRBFBasisFunction & funct);
@@ -181,6 +237,15 @@ protected:
     virtual void    plotOptionalResults();
     void            swap(MRBF & x) noexcept;
     void            checkFilter();
+    bool            hasCompactSupport();
+    bool            hasDecayingKernel();
+    void            buildNodeGrid();
+    bool            findGridCandidates(const darray3E & point, ivector1D & candidates);
+    dvector1D       evalRBFLocal(const darray3E & point, ivector1D & candidates);
+    int             solveSparse();
+    int             greedyIncremental(double tolerance);
+    void            buildNodeTree();
+    dvector1D       evalRBFTree(const darray3E & point);
 
 };
 
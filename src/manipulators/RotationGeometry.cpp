@@ -186,7 +186,6 @@ RotationGeometry::execute(){
 
     m_displ.clear();
     m_displ.setDataLocation(mimmo::MPVLocation::POINT);
-    m_displ.reserve(getGeometry()->getNVertices());
     m_displ.setGeometry(getGeometry());
 
 
@@ -195,26 +194,28 @@ RotationGeometry::execute(){
     darray3E b =  (1.0 - std::cos(m_alpha)) * m_direction;
     double c   = std::sin(m_alpha);
 
-    darray3E point, rotated;
-    long ID;
-    darray3E value;
-    for (const auto & vertex : m_geometry->getVertices()){
-        point = vertex.getCoords();
-        ID = vertex.getId();
+    //work on the dense coordinates snapshot and fill the displacements in the same order.
+    const VertexCoordinatesSoA & coords = getGeometry()->getVertexCoordinatesSoA();
+    long nV = long(coords.size());
+    dvecarr3E displ(nV);
 
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < nV; ++i){
+        darray3E point({{coords.x[i], coords.y[i], coords.z[i]}});
         point -= m_origin;
+
         //rodrigues formula
-        rotated = a * point +
+        darray3E rotated = a * point +
                 b * dotProduct(m_direction, point) +
                 c * crossProduct(m_direction, point);
-
         rotated += m_origin;
         point += m_origin;
 
-        value = (rotated-point)*m_filter[ID];
-        m_displ.insert(ID, value);
-
+        displ[i] = (rotated-point)*m_filter[coords.ids[i]];
     }
+    m_displ.setData(coords.ids, displ);
 };
 
 /*!
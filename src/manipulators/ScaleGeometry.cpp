@@ -170,29 +170,47 @@ ScaleGeometry::execute(){
     checkFilter();
     m_displ.clear();
     m_displ.setDataLocation(mimmo::MPVLocation::POINT);
-    m_displ.reserve(getGeometry()->getNVertices());
     m_displ.setGeometry(getGeometry());
 
+    //work on the dense coordinates snapshot and fill the displacements in the same order.
+    const VertexCoordinatesSoA & coords = getGeometry()->getVertexCoordinatesSoA();
+    long nV = long(coords.size());
 
-    long ID;
-    darray3E value;
     //computing centroid
-    int nV = m_geometry->getNVertices();
     darray3E center = m_origin;
-    if (m_meanP){
+    if (m_meanP && nV > 0){
+        //partial sums on chunks of fixed size, accumulated in chunk order:
+        //the result does not depend on the number of threads.
+        const long chunkSize = 4096;
+        long nChunks = (nV + chunkSize - 1) / chunkSize;
+        dvecarr3E partial(nChunks, darray3E({{0.0, 0.0, 0.0}}));
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long k = 0; k < nChunks; ++k){
+            long iend = std::min(nV, (k+1)*chunkSize);
+            for (long i = k*chunkSize; i < iend; ++i){
+                partial[k][0] += coords.x[i];
+                partial[k][1] += coords.y[i];
+                partial[k][2] += coords.z[i];
+            }
+        }
         center.fill(0.0);
-        for (const auto & vertex : m_geometry->getVertices()){
-            center += vertex.getCoords();
+        for (const darray3E & val : partial){
+            center += val;
         }
-        center /=double(nV);
+        center /= double(nV);
     }
-    for (const auto & vertex : m_geometry->getVertices()){
-        ID = vertex.getId();
 
-        darray3E coords = vertex.getCoords();
-        value = (( m_scaling*(coords - center) + center ) - coords) * m_filter[ID] ;
-        m_displ.insert(ID, value);
+    dvecarr3E displ(nV);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < nV; ++i){
+        darray3E point({{coords.x[i], coords.y[i], coords.z[i]}});
+        displ[i] = (( m_scaling*(point - center) + center ) - point) * m_filter[coords.ids[i]] ;
     }
+    m_displ.setData(coords.ids, displ);
 };
 
 /*!
@@ -206,20 +206,20 @@ TwistGeometry::execute(){
 
     m_displ.clear();
     m_displ.setDataLocation(mimmo::MPVLocation::POINT);
-    m_displ.reserve(getGeometry()->getNVertices());
     m_displ.setGeometry(getGeometry());
 
-    darray3E point, rotated;
-    long ID;
-    darray3E projected;
-    double distance;
-    //double sign;
-    double rot;
-    darray3E value;
+    //work on the dense coordinates snapshot and fill the displacements in the same order.
+    const VertexCoordinatesSoA & coords = getGeometry()->getVertexCoordinatesSoA();
+    long nV = long(coords.size());
+    dvecarr3E displ(nV);
 
-    for (const auto & vertex : m_geometry->getVertices()){
-        point = vertex.getCoords();
-        ID = vertex.getId();
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < nV; ++i){
+        darray3E point({{coords.x[i], coords.y[i], coords.z[i]}});
+        darray3E rotated, projected;
+        double distance, rot;
 
         //signed distance from origin
         distance = dotProduct((point-m_origin),m_direction);
@@ -244,10 +244,9 @@ TwistGeometry::execute(){
         rotated += projected;
         point += projected;
 
-        value = (rotated-point)*m_filter[ID];
-        m_displ.insert(ID, value);
-
+        displ[i] = (rotated-point)*m_filter[coords.ids[i]];
     }
+    m_displ.setData(coords.ids, displ);
 };
 
 /*!
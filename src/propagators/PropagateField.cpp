@@ -26,6 +26,108 @@
 #include "PropagateField.hpp"
 #include <CG.hpp>
 namespace mimmo {
+//--------------------------------------
+//--------------------------------------
+// SYSTEM SOLVER
+//--------------------------------------
+//--------------------------------------
+
+/*!
+ * Constructor. Default setup is GMRES with ASM/ILU preconditioner, rebuilt at each matrix update.
+ * \param[in] debug if true, print solver debug information.
+ */
+PropagatorSolver::PropagatorSolver(bool debug): bitpit::SystemSolver(debug){
+	m_krylov = PropagatorKrylov::GMRES;
+	m_preconditioner = PropagatorPreconditioner::ASM;
+	m_reusePreconditioner = false;
+}
+
+/*!
+ * Set the Krylov solver. It is applied at the next setup of the solver.
+ * \param[in] krylov Krylov solver.
+ */
+void
+PropagatorSolver::setKrylov(PropagatorKrylov krylov){
+	m_krylov = krylov;
+}
+
+/*!
+ * Set the preconditioner. It is applied at the next setup of the solver.
+ * \param[in] preconditioner preconditioner.
+ */
+void
+PropagatorSolver::setPreconditioner(PropagatorPreconditioner preconditioner){
+	m_preconditioner = preconditioner;
+}
+
+/*!
+ * Keep the preconditioner set up at the first solve across the following matrix updates.
+ * \param[in] reuse true to keep the preconditioner.
+ */
+void
+PropagatorSolver::setReusePreconditioner(bool reuse){
+	m_reusePreconditioner = reuse;
+}
+
+/*!
+ * Configure the KSP and PC objects before their setup. The bitpit setup (ASM) is kept
+ * for the default preconditioner, otherwise the PC type is replaced.
+ */
+void
+PropagatorSolver::preKSPSetupActions(){
+
+	bitpit::SystemSolver::preKSPSetupActions();
+
+	switch(m_krylov){
+	case PropagatorKrylov::FGMRES:
+		KSPSetType(m_KSP, KSPFGMRES);
+		KSPGMRESSetRestart(m_KSP, getKSPOptions().restart);
+		break;
+	case PropagatorKrylov::BICGSTAB:
+		KSPSetType(m_KSP, KSPBCGS);
+		break;
+	case PropagatorKrylov::CG:
+		KSPSetType(m_KSP, KSPCG);
+		break;
+	default: //GMRES
+		break;
+	}
+
+	PC preconditioner;
+	KSPGetPC(m_KSP, &preconditioner);
+	switch(m_preconditioner){
+	case PropagatorPreconditioner::ILU:
+		PCSetType(preconditioner, PCILU);
+		PCFactorSetLevels(preconditioner, getKSPOptions().sublevels);
+		break;
+	case PropagatorPreconditioner::GAMG:
+		PCSetType(preconditioner, PCGAMG);
+		break;
+	case PropagatorPreconditioner::HYPRE:
+		PCSetType(preconditioner, PCHYPRE);
+		PCHYPRESetType(preconditioner, "boomeramg");
+		break;
+	case PropagatorPreconditioner::JACOBI:
+		PCSetType(preconditioner, PCJACOBI);
+		break;
+	default: //ASM
+		break;
+	}
+
+	KSPSetReusePreconditioner(m_KSP, m_reusePreconditioner ? PETSC_TRUE : PETSC_FALSE);
+}
+
+/*!
+ * Complete the setup of KSP and PC objects. The bitpit setup of ASM subdomains is
+ * performed for the default preconditioner only, the other ones need no further setup.
+ */
+void
+PropagatorSolver::postKSPSetupActions(){
+	if(m_preconditioner == PropagatorPreconditioner::ASM){
+		bitpit::SystemSolver::postKSPSetupActions();
+	}
+}
+
 //--------------------------------------
 //--------------------------------------
 // SCALARFIELD (USUALLY FILTER DISPLACEMENTS)
@@ -258,16 +360,34 @@ PropagateScalarField::execute(){
 	(*m_log) << bitpit::log::priority(bitpit::log::NORMAL);
 	(*m_log) << bitpit::log::context("mimmo");
 
-	//allocate the solver;
-	m_solver = std::unique_ptr<bitpit::SystemSolver>(new bitpit::SystemSolver(m_print));
+	//check if the solver of the previous execution can be reused.
+	std::size_t signature = 0;
+	bool reuse = false;
+	if(m_persistentSolver){
+		signature = computeSolverSignature();
+		reuse = isSolverReusable(signature);
+	}
+
+	if(reuse){
+		(*m_log)<<m_name<<" : reusing the laplacian system assembled in the previous execution"<<std::endl;
+		m_solverIterations.clear();
+		m_solverTimes.clear();
+	}else{
+		//allocate the solver;
+		m_solver = std::unique_ptr<PropagatorSolver>(new PropagatorSolver(m_print));
+		m_persistentStencils = nullptr;
+		m_previousSolution.clear();
+	}
 
 	//get this inverse map -> you will need it to compact the stencils.
 	liimap dataInv;
 
 
 	//compute the dumping.
-    initializeDumpingSurface();
-    computeDumpingFunction();
+	if(!reuse){
+		initializeDumpingSurface();
+		computeDumpingFunction();
+	}
 
 	//Switch on solver method
 	// if (m_method == PropagatorMethod::FINITEVOLUMES){
@@ -346,12 +466,18 @@ PropagateScalarField::execute(){
 		//pass bc point information to bulk interfaces.
 		distributeBCOnBoundaryPoints();
 
-		// compute the laplacian stencils
-		GraphLaplStencil::MPVStencilUPtr laplaceStencils = GraphLaplStencil::computeLaplacianStencils(*geo, m_tol, &m_dumping);
+		GraphLaplStencil::MPVStencilUPtr laplaceStencils;
+		if(reuse){
+			laplaceStencils = std::move(m_persistentStencils);
+		}else{
+			// compute the laplacian rows directly in compressed sparse row format
+			GraphLaplStencil::LaplacianCSR laplaceRows;
+			GraphLaplStencil::computeLaplacianCSR(*geo, nullptr, laplaceRows, &m_dumping);
 
-		// initialize the laplacian Matrix in solver and squeeze out the laplace stencils and save border cells only.
-		initializeLaplaceSolver(laplaceStencils.get(), dataInv);
-		laplaceStencils->squeezeOutExcept(borderPointsID);
+			// initialize the laplacian Matrix in solver and extract the laplace stencils of border points only.
+			initializeLaplaceSolver(laplaceRows, dataInv);
+			laplaceStencils = GraphLaplStencil::extractStencils(*geo, laplaceRows, &borderPointsID);
+		}
 		borderPointsID.clear();
 
 		MimmoPiercedVector<std::array<double, 1> > stepBCdir(geo, MPVLocation::POINT);
@@ -360,8 +486,11 @@ PropagateScalarField::execute(){
 			stepBCdir.insert(it.getId(), *it/double(m_nstep));
 		}
 
-		//solve
+		//solve, starting from the previous solution if the solver is reused.
 		std::vector<std::vector<double>> result(1);
+		if(reuse && m_previousSolution.size() == 1){
+			result = m_previousSolution;
+		}
 		// multistep subiteration. Grid does not change, boundaries are forced each step with a constant increment, so:
 		for(int istep=0; istep < m_nstep; ++istep){
 
@@ -370,9 +499,14 @@ PropagateScalarField::execute(){
 			}
 			//update the solver matrix applying bc and evaluate the rhs;
 			dvector1D rhs(geo->getNInternalVertices(), 0.0);
-			//USELESS FOR EACH STEP?...
-			assignBCAndEvaluateRHS(0, false, laplaceStencils.get(), dataInv, rhs);
+			//matrix correction does not change between steps (same bc nodes): update it on first step only,
+			//so that the preconditioner is set up once.
+			//A reused solver has the bc already applied to its matrix.
+			assignBCAndEvaluateRHS(0, false, laplaceStencils.get(), dataInv, rhs, istep == 0 && !reuse);
 			solveLaplace(rhs, result[0]);
+			if(istep == 0 && m_persistentSolver){
+				m_previousSolution = result;
+			}
 			(*m_log)<<m_name<<" solved step "<<istep+1<<" out of total steps "<<m_nstep<<std::endl;
 		}
 
@@ -382,14 +516,21 @@ PropagateScalarField::execute(){
 		reconstructResults(result, mapdata);
 		// now data are direcly pushed in m_field.
 
+		//keep the border stencils together with the solver, if persistent.
+		if(m_persistentSolver){
+			m_persistentStencils = std::move(laplaceStencils);
+			m_solverSignature = signature;
+		}
 	}// end if solver method
 
 //#if MIMMO_ENABLE_MPI
 //	communicatePointGhostData(&m_field);
 //#endif
 
-	//clear the solver;
-	m_solver->clear();
+	//clear the solver, unless it is kept for the next execution.
+	if(!m_persistentSolver){
+		m_solver->clear();
+	}
 	(*m_log) << bitpit::log::priority(bitpit::log::DEBUG);
 }
 
@@ -409,6 +550,7 @@ PropagateVectorField::PropagateVectorField():PropagateField<3>(){
 	m_slipsurface = nullptr;
 	m_slipreferencesurface = nullptr;
     m_forcePlanarSlip = false;
+	m_reusePreconditioner = false;
 };
 
 /*!
@@ -420,6 +562,7 @@ void PropagateVectorField::setDefaults(){
 	m_slipsurface = nullptr;
 	m_slipreferencesurface = nullptr;
     m_forcePlanarSlip = false;
+	m_reusePreconditioner = false;
 	m_slip_bc_dir.clear();
 	m_surface_slip_bc_dir.clear();
 }
@@ -435,6 +578,7 @@ PropagateVectorField::PropagateVectorField(const bitpit::Config::Section & rootX
 	m_slipsurface = nullptr;
 	m_slipreferencesurface = nullptr;
     m_forcePlanarSlip = false;
+	m_reusePreconditioner = false;
 
 	std::string fallback_name = "ClassNONE";
 	std::string input = rootXML.get("ClassName", fallback_name);
@@ -627,6 +771,16 @@ void PropagateVectorField::absorbSectionXML(const bitpit::Config::Section & slot
 		}
 		forcePlanarSlip(value);
 	}
+	if(slotXML.hasOption("ReusePreconditioner")){
+		std::string input = slotXML.get("ReusePreconditioner");
+		input = bitpit::utils::string::trim(input);
+		bool value = false;
+		if(!input.empty()){
+			std::stringstream ss(input);
+			ss >> value;
+		}
+		setReusePreconditioner(value);
+	}
 };
 
 /*!
@@ -640,6 +794,7 @@ void PropagateVectorField::flushSectionXML(bitpit::Config::Section & slotXML, st
 	PropagateField<3>::flushSectionXML(slotXML, name);
 	slotXML.set("MultiStep", std::to_string(int(m_nstep)));
     slotXML.set("ForcePlanarSlip", std::to_string(int(m_forcePlanarSlip)));
+    slotXML.set("ReusePreconditioner", std::to_string(int(m_reusePreconditioner)));
 };
 
 /*!
@@ -1002,10 +1157,7 @@ std::unique_ptr<MimmoPiercedVector<std::array<double,3> > >
 #endif
 
     // you can deform
-    bitpit::PiercedVector<bitpit::Vertex> & verts = m_originalDumpingSurface->getVertices();
-	for (auto it= verts.begin(); it != verts.end(); ++it){
-		m_originalDumpingSurface->modifyVertex(it->getCoords() + mpvres->at(it.getId()), it.getId());
-	}
+    m_originalDumpingSurface->displaceVertices(*(mpvres.get()));
 
 }
 
@@ -1068,18 +1220,10 @@ PropagateVectorField::apply(){
 	MimmoObject * target = getGeometry();
 	if (!target) return;
 
-	bitpit::PiercedVector<bitpit::Vertex> & verts = target->getVertices();
-
-	for (auto it= verts.begin(); it != verts.end(); ++it){
-		target->modifyVertex(it->getCoords()+m_field.at(it.getId()), it.getId());
-	}
+	target->displaceVertices(m_field);
 
 	//Modify m boundary surface
-	MimmoObject * bsurf = m_bsurface;
-	bitpit::PiercedVector<bitpit::Vertex> & vertbound = bsurf->getVertices();
-	for (auto it= vertbound.begin(); it != vertbound.end(); ++it){
-		bsurf->modifyVertex(it->getCoords()+m_field.at(it.getId()), it.getId());
-	}
+	m_bsurface->displaceVertices(m_field);
 
 	//if the dumping is active morph the internal member m_originaDumpingSurface. It is enough.
 	if(m_dumpingActive && m_originalDumpingSurface.get() != nullptr){
@@ -1088,10 +1232,7 @@ PropagateVectorField::apply(){
 
 	//if the slipsurface is active apply this deformation also to the slipsurface(re-evaluation of normals)
 	if(m_slipsurface){
-		bitpit::PiercedVector<bitpit::Vertex> & vertslip = m_slipsurface->getVertices();
-		for (auto it= vertslip.begin(); it != vertslip.end(); ++it){
-			m_slipsurface->modifyVertex(it->getCoords()+m_field.at(it.getId()), it.getId());
-		}
+		m_slipsurface->displaceVertices(m_field);
 	}
 
 }
@@ -1106,6 +1247,21 @@ PropagateVectorField::setSolverMultiStep(unsigned int sstep){
 	m_nstep = std::max(loc,sstep);
 }
 
+/*!
+ * In multistep solving, the laplacian rows of the moving region are passed step by step to the
+ * system solver update, which writes their values on the sparsity pattern assembled at the first step.
+ * If preconditioner reuse is active, the preconditioner set up at the first solve is kept for all the
+ * following steps instead of being rebuilt after each matrix update: the Krylov solver still converges
+ * on the updated operator, at the price of some more iterations on large deformations.
+ * Default is false (the preconditioner is rebuilt at each step); preconditioner reuse is opt-in,
+ * through this method or the ReusePreconditioner XML key.
+ * \param[in] reuse true to keep the first step preconditioner.
+ */
+void
+PropagateVectorField::setReusePreconditioner(bool reuse){
+	m_reusePreconditioner = reuse;
+}
+
 /*!
  * subdivide dirichlet boundary conditions  for multi step purposes
  */
@@ -1136,12 +1292,18 @@ PropagateVectorField::restoreGeometry(bitpit::PiercedVector<bitpit::Vertex> & ve
 	MimmoObject * target = getGeometry();
 	bitpit::PiercedVector<bitpit::Vertex> &currentmesh = target->getVertices();
 	long ID;
+	dvecarr3E restoredCoords;
+	livector1D restoredIds;
+	restoredCoords.reserve(vertices.size());
+	restoredIds.reserve(vertices.size());
 	for (auto it= vertices.begin(); it!=vertices.end(); ++it){
 		ID = it.getId();
 		const std::array<double,3> &coords = it->getCoords();
 		m_field.at(ID) = currentmesh.at(ID).getCoords() - coords;
-		target->modifyVertex(coords, ID);
+		restoredCoords.push_back(coords);
+		restoredIds.push_back(ID);
 	}
+	target->modifyVertices(restoredCoords, restoredIds);
 
 	//Restore m boundary surface
 	MimmoObject * bsurf = m_bsurface;
@@ -1206,9 +1368,8 @@ void PropagateVectorField::propagateMaskMovingPoints(livector1D & vertexList) {
     if (!getGeometry()->isPointConnectivitySync()){
         getGeometry()->buildPointConnectivity();
     }
-	std::unordered_set<long> tempV1;
 	for(long id: vertexList){
-		tempV1 = getGeometry()->getPointConnectivity(id);
+		bitpit::ConstProxyVector<long> tempV1 = getGeometry()->getPointConnectivity(id);
 
 		//run the list element by element. Any new element, evaluate its face neighs in F2Ring and push it in core.
 		for(long candidate : tempV1){
@@ -1355,12 +1516,15 @@ PropagateVectorField::assignBCAndEvaluateRHS(std::size_t comp, bool slipCorrect,
  * \param[in] borderLaplacianStencil list of laplacian Stencil on border nodes, where the bc is temporarely imposed as homogeneous Neumann
  * \param[in] maplocals map from global id numbering to local system solver numbering.
  * \param[in,out] rhs vector of right-hand-side's to append constant data from bc corrections.
+ * \param[in] updateMatrix if false the system matrix is not updated and only the rhs is evaluated.
+ * Corrected rows (Dirichlet, periodic, slip) do not depend on the component, so the update can be
+ * skipped for the components following the first one of the same predictor/corrector stage.
  */
 void
 PropagateVectorField::assignBCAndEvaluateRHS(std::size_t comp, bool slipCorrect,
 		GraphLaplStencil::MPVStencil * borderLaplacianStencil,
 		const liimap & maplocals,
-		dvector1D & rhs)
+		dvector1D & rhs, bool updateMatrix)
 {
 	MimmoObject * geo = getGeometry();
 
@@ -1433,7 +1597,9 @@ PropagateVectorField::assignBCAndEvaluateRHS(std::size_t comp, bool slipCorrect,
 
 	// now its time to update the solver matrix and to extract the rhs contributes.
 	//NOTE: USE THE FINITE VOLUMES METHOD, THE STRUCTURES ARE THE SAME!
-	updateLaplaceSolver(lapwork.get(), maplocals);
+	if(updateMatrix){
+		updateLaplaceSolver(lapwork.get(), maplocals);
+	}
 
 	// now get the rhs
 	for(auto it = lapwork->begin(); it != lapwork->end();++it){
@@ -1510,14 +1676,23 @@ PropagateVectorField::computeSlipBCCorrector(const MimmoPiercedVector<std::array
     		m_originalslipsurface->buildSkdTree();
 
     	bitpit::PatchSkdTree *tree = m_originalslipsurface->getSkdTree();
-    	//loop on surface points.
+    	//collect the displaced surface points and project them in batch.
+    	livector1D idVs;
+    	dvecarr3E points;
+    	idVs.reserve(m_surface_slip_bc_dir.size());
+    	points.reserve(m_surface_slip_bc_dir.size());
+    	double r = 1.0e-02;
     	for(auto it=m_surface_slip_bc_dir.begin(); it!=m_surface_slip_bc_dir.end(); ++it){
     		long idV = it.getId();
     		bitpit::Vertex &vertex = m_slipsurface->getPatch()->getVertex(idV);
-    		std::array<double,3> point = vertex.getCoords() + m_surface_slip_bc_dir[idV];
-    		 double r = std::max(1.0e-02, norm2(m_surface_slip_bc_dir[idV])*1.25);
-    		std::array<double,3> projpoint = skdTreeUtils::projectPoint(&point, tree, r);
-    		projectionVector[idV] = projpoint - point;
+    		idVs.push_back(idV);
+    		points.push_back(vertex.getCoords() + *it);
+    		r = std::max(r, norm2(*it)*1.25);
+    	}
+    	dvecarr3E projpoints(points.size());
+    	skdTreeUtils::projectPoint(int(points.size()), points.data(), tree, projpoints.data(), r);
+    	for(std::size_t i=0; i<idVs.size(); ++i){
+    		projectionVector[idVs[i]] = projpoints[i] - points[i];
     	}
     }
 
@@ -1582,16 +1757,36 @@ PropagateVectorField::execute(){
 	(*m_log) << bitpit::log::priority(bitpit::log::NORMAL);
 	(*m_log) << bitpit::log::context("mimmo");
 	//INITIALIZATION --->////////////////////////////////////////////////////////////////////////////////////
-	//allocate the solver;
-	m_solver = std::unique_ptr<bitpit::SystemSolver>(new bitpit::SystemSolver(m_print));
+	//the solver can be kept between executions only if its matrix is not changed during the solution,
+	//i.e. single step solution without slip or periodic corrections.
+	bool persistent = m_persistentSolver && m_nstep == 1 && !m_slipsurface && m_periodicsurfaces.empty();
+	std::size_t signature = 0;
+	bool reuse = false;
+	if(persistent){
+		signature = computeSolverSignature();
+		reuse = isSolverReusable(signature);
+	}
+
+	if(reuse){
+		(*m_log)<<m_name<<" : reusing the laplacian system assembled in the previous execution"<<std::endl;
+		m_solverIterations.clear();
+		m_solverTimes.clear();
+	}else{
+		//allocate the solver;
+		m_solver = std::unique_ptr<PropagatorSolver>(new PropagatorSolver(m_print));
+		m_persistentStencils = nullptr;
+		m_previousSolution.clear();
+	}
 
 	//get the inverse and the direct map -> you will need it to compact the stencil/ and recover the results respectively.
 	liimap dataInv;
 	liimap data;
 
 	//compute the dumping.
-    initializeDumpingSurface();
-    computeDumpingFunction();
+	if(!reuse){
+		initializeDumpingSurface();
+		computeDumpingFunction();
+	}
 
 	//PREPARE THE MULTISTEP;
 	bitpit::PiercedVector<bitpit::Vertex> undeformedTargetVertices;
@@ -1746,16 +1941,26 @@ PropagateVectorField::execute(){
 		dataInv = geo->getMapDataInv(true);
 		data = geo->getMapData(true);
 
-		// compute the laplacian stencils
-		GraphLaplStencil::MPVStencilUPtr laplaceStencils = GraphLaplStencil::computeLaplacianStencils(*geo, m_tol, &m_dumping);
+		GraphLaplStencil::LaplacianCSR laplaceRows;
+		GraphLaplStencil::MPVStencilUPtr laplaceStencils;
+		if(reuse){
+			laplaceStencils = std::move(m_persistentStencils);
+		}else{
+			// compute the laplacian rows directly in compressed sparse row format
+			GraphLaplStencil::computeLaplacianCSR(*geo, nullptr, laplaceRows, &m_dumping);
 
-		// initialize the laplacian Matrix in solver and squeeze out the laplace stencils and save border cells only.
-		initializeLaplaceSolver(laplaceStencils.get(), dataInv);
-		laplaceStencils->squeezeOutExcept(borderPointsID);
-		borderPointsID.clear();
+			// initialize the laplacian Matrix in solver and extract the laplace stencils of border points only.
+			initializeLaplaceSolver(laplaceRows, dataInv);
+			laplaceStencils = GraphLaplStencil::extractStencils(*geo, laplaceRows, &borderPointsID);
+		}
+		//border points list is kept to restrict the stencil updates of the multistep loop.
 
 		//declare results here and keep it during the loop to re-use the older steps.
+		//A reused solver starts from the previous solution.
 		std::vector<std::vector<double>> results(3);
+		if(reuse && m_previousSolution.size() == 3){
+			results = m_previousSolution;
+		}
 
 		//loop on multistep
 		for(int istep=0; istep < m_nstep; ++istep){
@@ -1766,17 +1971,21 @@ PropagateVectorField::execute(){
 			// multistep, and the interpolation weights from point to interfaces changes accordingly.
 
 			//3-COMPONENT SYSTEM SOLVING ---> ///////////////////////////////////////////////////////////////////////
-			// solve the field component by component
-			//first loop -> if slip is enforced in some walls, this is the predictor stage of guess solution with 0-Neumann on slip walls
-			for(int comp = 0; comp<3; ++comp){
-				//prepare the right hand side ;
-				dvector1D rhs(geo->getNInternalVertices(), 0.0);
-				assignBCAndEvaluateRHS(comp, false, laplaceStencils.get(), dataInv, rhs);
-
+			// the matrix correction due to bc is the same for all components: update the matrix once,
+			// collect the three right hand sides and solve them on the same operator/preconditioner.
+			//first stage -> if slip is enforced in some walls, this is the predictor stage of guess solution with 0-Neumann on slip walls
+			{
+				dvector2D rhs(3, dvector1D(geo->getNInternalVertices(), 0.0));
+				//A reused solver has the bc already applied to its matrix.
+				for(int comp = 0; comp<3; ++comp){
+					assignBCAndEvaluateRHS(comp, false, laplaceStencils.get(), dataInv, rhs[comp], comp == 0 && !reuse);
+					results[comp].resize(rhs[comp].size(), 0.0);
+				}
 				//solve
-				results[comp].resize(rhs.size(), 0.0);
-				solveLaplace(rhs, results[comp]);
-
+				solveLaplace(rhs, results);
+				if(persistent){
+					m_previousSolution = results;
+				}
 			}
 
 			//if I have a slip wall active, it needs a corrector stage for slip boundaries;
@@ -1790,13 +1999,12 @@ PropagateVectorField::execute(){
 
 				// so loop again on the components, reusing the previous result as starting guess, and setting
 				// the boolean of assignBC as true (corrector stage of slip, read Dirichlet from m_slip_bc_dir)
+				dvector2D rhs(3, dvector1D(geo->getNInternalVertices(), 0.0));
 				for(int comp = 0; comp<3; ++comp){
-					//prepare the right hand side ;
-					dvector1D rhs(geo->getNInternalVertices(), 0.0);
-					assignBCAndEvaluateRHS(comp, true, laplaceStencils.get(), dataInv, rhs);
-					//solve
-					solveLaplace(rhs, results[comp]);
+					assignBCAndEvaluateRHS(comp, true, laplaceStencils.get(), dataInv, rhs[comp], comp == 0);
 				}
+				//solve
+				solveLaplace(rhs, results);
 			}
 			//RECONSTRUCT STAGE --> /////////////////////////////////////////////////////////////////////////////////
 			reconstructResults(results, data, movingElementList.get());
@@ -1835,15 +2043,35 @@ PropagateVectorField::execute(){
 				//enlarge the moving cell list taking its first vertex neighs and its second face neighs.
 				propagateMaskMovingPoints(*(movingElementList.get()));
 
-				// update the laplacian stencils
-				GraphLaplStencil::MPVStencilUPtr updateLaplaceStencils = GraphLaplStencil::computeLaplacianStencils(*geo, movingElementList.get(), m_tol, &m_dumping);
+				// update the laplacian rows
+				GraphLaplStencil::computeLaplacianCSR(*geo, movingElementList.get(), laplaceRows, &m_dumping);
 				movingElementList->clear();
 
-				laplaceStencils->getDataFrom(*(updateLaplaceStencils.get()), true); //only common elements are updated.
+				//only common elements are updated.
+				laplaceStencils->getDataFrom(*(GraphLaplStencil::extractStencils(*geo, laplaceRows, &borderPointsID).get()), true);
+
+				// compact in place the rows of bulk nodes only: border rows are rewritten anyway by the
+				// bc assignment of the next step, so they are not pushed twice into the solver matrix.
+				std::size_t nrows = 0, nnz = 0;
+				for(std::size_t row = 0; row < laplaceRows.ids.size(); ++row){
+					if(laplaceStencils->exists(laplaceRows.ids[row]))	continue;
+					laplaceRows.ids[nrows] = laplaceRows.ids[row];
+					for(std::size_t k = laplaceRows.offsets[row]; k < laplaceRows.offsets[row+1]; ++k){
+						laplaceRows.columns[nnz] = laplaceRows.columns[k];
+						laplaceRows.weights[nnz] = laplaceRows.weights[k];
+						++nnz;
+					}
+					++nrows;
+					laplaceRows.offsets[nrows] = nnz;
+				}
+				laplaceRows.ids.resize(nrows);
+				laplaceRows.offsets.resize(nrows + 1);
+				laplaceRows.columns.resize(nnz);
+				laplaceRows.weights.resize(nnz);
 
-				// update the laplacian Matrix in solver free the updateLaplaceStencils
-				updateLaplaceSolver(updateLaplaceStencils.get(), dataInv);
-				updateLaplaceStencils = nullptr;
+				// pass the moving rows to the solver update, that writes their values on the
+				// assembled sparsity pattern; the preconditioner is kept if reuse is active.
+				updateLaplaceSolver(laplaceRows, dataInv);
 
 			}
 
@@ -1851,6 +2079,11 @@ PropagateVectorField::execute(){
 
 		} //end of multistep loop;
 
+		//keep the border stencils together with the solver, if persistent.
+		if(persistent){
+			m_persistentStencils = std::move(laplaceStencils);
+			m_solverSignature = signature;
+		}
 
 	} //end if on method
 
@@ -1862,8 +2095,10 @@ PropagateVectorField::execute(){
 		restoreBC();
 	}
 
-	//clear the solver;
-	m_solver->clear();
+	//clear the solver, unless it is kept for the next execution.
+	if(!persistent){
+		m_solver->clear();
+	}
 	(*m_log) << bitpit::log::priority(bitpit::log::DEBUG);
 }
 
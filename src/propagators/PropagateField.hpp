@@ -26,6 +26,7 @@
 
 #include "BaseManipulation.hpp"
 #include "StencilFunctions.hpp"
+#include <chrono>
 
 #if MIMMO_ENABLE_MPI
 #include "mimmo_parallel.hpp"
@@ -42,6 +43,59 @@ enum class PropagatorMethod: long {
 //    FINITEVOLUMES=1 /**<Finite Volume discretization on cell centers*/
 };
 
+/*!
+   \ingroup propagators
+ * \brief Krylov solver employed on the propagator linear system
+ */
+enum class PropagatorKrylov: long {
+    GMRES=0,    /**<0-restarted GMRES (default)*/
+    FGMRES=1,   /**<1-flexible GMRES*/
+    BICGSTAB=2, /**<2-stabilized biconjugate gradient*/
+    CG=3        /**<3-conjugate gradient, for symmetric systems only*/
+};
+
+/*!
+   \ingroup propagators
+ * \brief Preconditioner employed on the propagator linear system
+ */
+enum class PropagatorPreconditioner: long {
+    ASM=0,      /**<0-additive Schwarz with ILU on subdomains (default)*/
+    ILU=1,      /**<1-incomplete LU factorization (serial runs only)*/
+    GAMG=2,     /**<2-PETSc native algebraic multigrid*/
+    HYPRE=3,    /**<3-BoomerAMG algebraic multigrid, PETSc must be built with hypre*/
+    JACOBI=4    /**<4-diagonal scaling*/
+};
+
+/*!
+ * \class PropagatorSolver
+ * \ingroup propagators
+ * \brief Linear system solver of the propagators.
+ *
+ * bitpit::SystemSolver setting up its Krylov solver and preconditioner with the choices
+ * of the owning propagator (see PropagatorKrylov and PropagatorPreconditioner).
+ * KSP and PC are configured directly on the PETSc objects of the solver, without touching
+ * the PETSc options database, so that the choices never affect other solvers.
+ * The default choice (ASM with ILU on subdomains) keeps the bitpit setup, while the other
+ * preconditioners replace it.
+ */
+class PropagatorSolver: public bitpit::SystemSolver {
+
+public:
+    PropagatorSolver(bool debug = false);
+
+    void setKrylov(PropagatorKrylov krylov);
+    void setPreconditioner(PropagatorPreconditioner preconditioner);
+    void setReusePreconditioner(bool reuse);
+
+protected:
+    PropagatorKrylov            m_krylov;               /**<Krylov solver.*/
+    PropagatorPreconditioner    m_preconditioner;       /**<Preconditioner.*/
+    bool                        m_reusePreconditioner;  /**<Keep the preconditioner across the matrix updates.*/
+
+    void preKSPSetupActions() override;
+    void postKSPSetupActions() override;
+};
+
 /*!
  * \class PropagateField
  * \ingroup propagators
@@ -87,6 +141,15 @@ enum class PropagatorMethod: long {
  * - <B>ForceDirichlet</B> : 1 -reforce Dirichlet on Boundaries, 0-do nothing. Meaningful in Method 1- Finite Volume
  * - <B>Method</B> : 0 - GraphLaplacian(on mesh nodes)
  * - <B>Print</B> : print solver debug information, Active only in if MIMMO_ENABLE_MPI is enabled in compilation.
+ * - <B>SolverType</B> : Krylov solver, see PropagatorKrylov (0-GMRES, 1-FGMRES, 2-BiCGStab, 3-CG);
+ * - <B>Preconditioner</B> : preconditioner, see PropagatorPreconditioner (0-ASM/ILU, 1-ILU, 2-GAMG, 3-HYPRE, 4-Jacobi);
+ * - <B>ILULevels</B> : fill levels of ILU factorization (ASM subdomains or global ILU);
+ * - <B>ASMOverlap</B> : overlap of ASM subdomains;
+ * - <B>Restart</B> : restart of GMRES/FGMRES solvers;
+ * - <B>PersistentSolver</B> : 1- keep the assembled solver between executions on unchanged mesh and settings, warm starting from the last solution, 0- rebuild it each execution;
+ *
+ * Iterations and wall time of each linear solve of the last execution are available
+ * through getSolverIterations and getSolverTimes (ports M_VECTORLI, M_DATAFIELD).
  *
  * Geometry, boundary surfaces, boundary condition values
  * for the target geometry have to be mandatorily passed through ports.
@@ -119,10 +182,22 @@ protected:
 
     bool m_forceDirichletConditions; /**<If true the dirichlet boundaries values are forced during reconstruction on points phase in finite volume solver. */
 
-    std::unique_ptr<bitpit::SystemSolver> m_solver; /**< linear system solver for laplace */
+    std::unique_ptr<PropagatorSolver> m_solver; /**< linear system solver for laplace */
     bool	m_print;				/**<If true residuals and other info are print during system solving.*/
 
     PropagatorMethod	m_method;	/**<Solver method enum.*/
+    PropagatorKrylov	m_krylov;	/**<Krylov solver of the linear system.*/
+    PropagatorPreconditioner	m_preconditioner;	/**<Preconditioner of the linear system.*/
+    int           m_iluLevels;      /**<Fill levels of ILU factorization.*/
+    int           m_asmOverlap;     /**<Overlap of ASM subdomains.*/
+    int           m_restart;        /**<Restart of GMRES-like solvers.*/
+    bool          m_reusePreconditioner; /**<Keep the preconditioner of the first solve across the matrix value updates.*/
+    bool          m_persistentSolver; /**<Keep the assembled solver alive between executions on unchanged mesh and settings.*/
+    std::size_t   m_solverSignature;  /**<Signature of mesh, boundaries and settings the persistent solver is assembled on.*/
+    GraphLaplStencil::MPVStencilUPtr m_persistentStencils; /**<Border laplacian stencils of the persistent solver.*/
+    dvector2D     m_previousSolution; /**<Solution of the last execution, initial guess of the persistent solver.*/
+    livector1D    m_solverIterations; /**<Iterations of each linear solve of the last execution.*/
+    dvector1D     m_solverTimes;    /**<Wall time [s] of each linear solve of the last execution.*/
     std::unique_ptr<MimmoObject> m_originalDumpingSurface; /**< recollect of the whole dumping surface*/
 
 #if MIMMO_ENABLE_MPI
@@ -159,6 +234,15 @@ public:
     void	setForceDirichletConditions(bool force = true);
     void	setMethod(PropagatorMethod method);
     void	setPrint(bool print = true);
+    void	setSolverType(PropagatorKrylov type);
+    void	setPreconditioner(PropagatorPreconditioner type);
+    void	setILULevels(int levels);
+    void	setASMOverlap(int overlap);
+    void	setRestart(int restart);
+    void	setPersistentSolver(bool persistent = true);
+
+    livector1D  getSolverIterations();
+    dvector1D   getSolverTimes();
 
     //XML utilities from reading writing settings to file
     virtual void absorbSectionXML(const bitpit::Config::Section & slotXML, std::string name="");
@@ -176,10 +260,15 @@ protected:
             void initializeDumpingSurface();
     virtual void computeDumpingFunction();
     virtual void updateDumpingFunction();
+            std::size_t computeSolverSignature();
+            bool isSolverReusable(std::size_t signature);
     virtual void initializeLaplaceSolver(FVolStencil::MPVDivergence * laplacianStencils, const liimap & maplocals);
 //    virtual void initializeFVLaplaceSolver(FVolStencil::MPVDivergence * laplacianStencils, const liimap & maplocals);
 //    virtual void initializeGLLaplaceSolver(FVolStencil::MPVDivergence * laplacianStencils, const liimap & maplocals);
     virtual void updateLaplaceSolver(FVolStencil::MPVDivergence * laplacianStencils, const liimap & maplocals);
+    virtual void initializeLaplaceSolver(const GraphLaplStencil::LaplacianCSR & laplacian, const liimap & maplocals);
+    virtual void updateLaplaceSolver(const GraphLaplStencil::LaplacianCSR & laplacian, const liimap & maplocals);
+            void assemblyLaplaceSolver(bitpit::SparseMatrix & matrix);
     virtual void assignBCAndEvaluateRHS(std::size_t comp, bool unused,
                                         FVolStencil::MPVDivergence * borderLaplacianStencil,
                                         FVolStencil::MPVGradient * borderCCGradientStencil,
@@ -188,9 +277,11 @@ protected:
     virtual void assignBCAndEvaluateRHS(std::size_t comp, bool unused,
     		GraphLaplStencil::MPVStencil * borderLaplacianStencil,
     		const liimap & maplocals,
-    		dvector1D & rhs);
+    		dvector1D & rhs, bool updateMatrix = true);
 
     virtual void solveLaplace(const dvector1D &rhs, dvector1D & result);
+    virtual void solveLaplace(const dvector2D &rhs, dvector2D & results);
+    void setSolverOptions();
 
     virtual void initializeBoundaryInfo();
     virtual void reconstructResults(const dvector2D & results, const liimap & mapglobals,  livector1D * markedcells = nullptr);
@@ -238,6 +329,8 @@ protected:
     ||||
     | <B>PortType</B>   | <B>variable/function</B>  |<B>DataType</B> |
     | M_FILTER         | getPropagatedField                  | (MC_SCALAR, MD_MPVECFLOAT_) |
+    | M_VECTORLI       | getSolverIterations                 | (MC_VECTOR, MD_LONG)        |
+    | M_DATAFIELD      | getSolverTimes                      | (MC_VECTOR, MD_FLOAT)       |
 
  *    =========================================================
  *
@@ -259,6 +352,12 @@ protected:
  * - <B>ForceDirichlet</B> : 1 -reforce Dirichlet on Boundaries, 0-do nothing. Meaningful in Method 1- Finite Volume
  * - <B>Method</B> : 0 - GraphLaplacian(on mesh nodes)
  * - <B>Print</B> : print solver debug information, Active only in if MIMMO_ENABLE_MPI is enabled in compilation.
+ * - <B>SolverType</B> : Krylov solver (0-GMRES, 1-FGMRES, 2-BiCGStab, 3-CG);
+ * - <B>Preconditioner</B> : preconditioner (0-ASM/ILU, 1-ILU, 2-GAMG, 3-HYPRE, 4-Jacobi);
+ * - <B>ILULevels</B> : fill levels of ILU factorization;
+ * - <B>ASMOverlap</B> : overlap of ASM subdomains;
+ * - <B>Restart</B> : restart of GMRES/FGMRES solvers;
+ * - <B>PersistentSolver</B> : 1- keep the assembled solver between executions on unchanged mesh and settings, warm starting from the last solution, 0- rebuild it each execution;
  *
  * Proper fo the class:
  * - <B>MultiStep</B> : get field solution in a finite number of substeps;
@@ -349,6 +448,8 @@ private:
     ||||
     | <B>PortType</B>   | <B>variable/function</B>  |<B>DataType</B> |
     | M_GDISPLS         | getPropagatedField   | (MC_SCALAR, MD_MPVECARR3FLOAT_) |
+    | M_VECTORLI        | getSolverIterations  | (MC_VECTOR, MD_LONG)            |
+    | M_DATAFIELD       | getSolverTimes       | (MC_VECTOR, MD_FLOAT)           |
 
  *    =========================================================
  *
@@ -373,10 +474,17 @@ private:
  * - <B>ForceDirichlet</B> : 1 -reforce Dirichlet on Boundaries, 0-do nothing. Meaningful in Method 1- Finite Volume
  * - <B>Method</B> : 0 - GraphLaplacian(on mesh nodes), 1- FiniteVolume (on mesh cells)
  * - <B>Print</B> : print solver debug information, Active only in if MIMMO_ENABLE_MPI is enabled in compilation.
+ * - <B>SolverType</B> : Krylov solver (0-GMRES, 1-FGMRES, 2-BiCGStab, 3-CG);
+ * - <B>Preconditioner</B> : preconditioner (0-ASM/ILU, 1-ILU, 2-GAMG, 3-HYPRE, 4-Jacobi);
+ * - <B>ILULevels</B> : fill levels of ILU factorization;
+ * - <B>ASMOverlap</B> : overlap of ASM subdomains;
+ * - <B>Restart</B> : restart of GMRES/FGMRES solvers;
+ * - <B>PersistentSolver</B> : 1- keep the assembled solver between executions on unchanged mesh and settings, warm starting from the last solution, 0- rebuild it each execution;
  *
  * Proper fo the class:
  * - <B>MultiStep</B> : got deformation in a finite number of substep of solution;
  * - <B>ForcePlanarSlip</B> : (for Quasi-Planar Slip Surface Only)  1- force the class to treat slip surface as plane (without holes), 0-use slip surface as it is;
+ * - <B>ReusePreconditioner</B> : (for MultiStep only) 1- keep the preconditioner of the first step while the matrix values are updated, 0- rebuild it each step (default);
 
  *
  * Geometry, boundary surfaces, boundary condition values
@@ -423,6 +531,7 @@ public:
     void    setDirichletConditions(dmpvecarr3E * bc);
 
     void    setSolverMultiStep(unsigned int sstep);
+    void    setReusePreconditioner(bool reuse = true);
 
     //execute
     void        execute();
@@ -452,7 +561,7 @@ protected:
     virtual void assignBCAndEvaluateRHS(std::size_t comp, bool slipCorrect,
                                 GraphLaplStencil::MPVStencil * borderLaplacianStencil,
                                 const liimap & maplocals,
-                                dvector1D & rhs);
+                                dvector1D & rhs, bool updateMatrix = true);
 
     virtual void propagateMaskMovingCells(livector1D & celllist);
     virtual void propagateMaskMovingPoints(livector1D & vertexlist);
@@ -473,6 +582,8 @@ REGISTER_PORT(M_GEOM5, MC_SCALAR, MD_MIMMO_,__PROPAGATEFIELD_HPP__)
 REGISTER_PORT(M_GEOM6, MC_SCALAR, MD_MIMMO_,__PROPAGATEFIELD_HPP__)
 REGISTER_PORT(M_FILTER, MC_SCALAR, MD_MPVECFLOAT_,__PROPAGATEFIELD_HPP__)
 REGISTER_PORT(M_GDISPLS, MC_SCALAR, MD_MPVECARR3FLOAT_,__PROPAGATEFIELD_HPP__)
+REGISTER_PORT(M_VECTORLI, MC_VECTOR, MD_LONG,__PROPAGATEFIELD_HPP__)
+REGISTER_PORT(M_DATAFIELD, MC_VECTOR, MD_FLOAT,__PROPAGATEFIELD_HPP__)
 
 REGISTER(BaseManipulation, PropagateScalarField, "mimmo.PropagateScalarField")
 REGISTER(BaseManipulation, PropagateVectorField, "mimmo.PropagateVectorField")
@@ -60,6 +60,18 @@ void PropagateField<NCOMP>::setDefaults(){
 	this->m_method = PropagatorMethod::GRAPHLAPLACE;
 	this->m_print = false;
     this->m_originalDumpingSurface = nullptr;
+	this->m_krylov = PropagatorKrylov::GMRES;
+	this->m_preconditioner = PropagatorPreconditioner::ASM;
+	this->m_iluLevels = 1;
+	this->m_asmOverlap = 1;
+	this->m_restart = 30;
+	this->m_reusePreconditioner = false;
+	this->m_persistentSolver = false;
+	this->m_solverSignature = 0;
+	this->m_persistentStencils = nullptr;
+	this->m_previousSolution.clear();
+	this->m_solverIterations.clear();
+	this->m_solverTimes.clear();
 }
 
 /*!
@@ -92,6 +104,13 @@ PropagateField<NCOMP>::PropagateField(const PropagateField<NCOMP> & other):BaseM
 	this->m_forceDirichletConditions = other.m_forceDirichletConditions;
 	this->m_method 		 = other.m_method;
 	this->m_print 		 = other.m_print;
+	this->m_krylov       = other.m_krylov;
+	this->m_preconditioner = other.m_preconditioner;
+	this->m_iluLevels    = other.m_iluLevels;
+	this->m_asmOverlap   = other.m_asmOverlap;
+	this->m_restart      = other.m_restart;
+	this->m_reusePreconditioner = other.m_reusePreconditioner;
+	this->m_persistentSolver = other.m_persistentSolver;
 };
 
 /*!
@@ -118,6 +137,19 @@ void PropagateField<NCOMP>::swap(PropagateField<NCOMP> & x) noexcept {
 	std::swap(m_forceDirichletConditions,x.m_forceDirichletConditions);
 	std::swap(this->m_method, x.m_method);
 	std::swap(this->m_print, x.m_print);
+	std::swap(this->m_krylov, x.m_krylov);
+	std::swap(this->m_preconditioner, x.m_preconditioner);
+	std::swap(this->m_iluLevels, x.m_iluLevels);
+	std::swap(this->m_asmOverlap, x.m_asmOverlap);
+	std::swap(this->m_restart, x.m_restart);
+	std::swap(this->m_reusePreconditioner, x.m_reusePreconditioner);
+	std::swap(this->m_persistentSolver, x.m_persistentSolver);
+	std::swap(this->m_solver, x.m_solver);
+	std::swap(this->m_solverSignature, x.m_solverSignature);
+	std::swap(this->m_persistentStencils, x.m_persistentStencils);
+	std::swap(this->m_previousSolution, x.m_previousSolution);
+	std::swap(this->m_solverIterations, x.m_solverIterations);
+	std::swap(this->m_solverTimes, x.m_solverTimes);
 }
 
 /*!
@@ -130,6 +162,8 @@ PropagateField<NCOMP>::buildPorts(){
 	built = (built && createPortIn<MimmoObject*, PropagateField<NCOMP> >(this, &PropagateField<NCOMP>::setGeometry, M_GEOM, true));
 	built = (built && createPortIn<MimmoObject*, PropagateField<NCOMP> >(this, &PropagateField<NCOMP>::setDirichletBoundarySurface, M_GEOM2));
 	built = (built && createPortIn<MimmoObject*, PropagateField<NCOMP> >(this, &PropagateField<NCOMP>::setDumpingBoundarySurface, M_GEOM3));
+	built = (built && createPortOut<livector1D, PropagateField<NCOMP> >(this, &PropagateField<NCOMP>::getSolverIterations, M_VECTORLI));
+	built = (built && createPortOut<dvector1D, PropagateField<NCOMP> >(this, &PropagateField<NCOMP>::getSolverTimes, M_DATAFIELD));
 	m_arePortsBuilt = built;
 };
 
@@ -289,6 +323,88 @@ void PropagateField<NCOMP>::setPrint(bool print){
 
 }
 
+/*!
+ * It sets the Krylov solver of the laplacian linear system. Default is GMRES.
+ * Note that CG requires a symmetric system matrix.
+ * \param[in] type Krylov solver type
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setSolverType(PropagatorKrylov type){
+	m_krylov = type;
+}
+
+/*!
+ * It sets the preconditioner of the laplacian linear system. Default is ASM, with ILU on
+ * each subdomain. Algebraic multigrid (GAMG, HYPRE) is recommended on stretched meshes,
+ * where ILU-preconditioned solvers may stall. HYPRE requires a PETSc installation built with hypre.
+ * \param[in] type preconditioner type
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setPreconditioner(PropagatorPreconditioner type){
+	m_preconditioner = type;
+}
+
+/*!
+ * It sets the fill levels of ILU factorizations (ASM subdomains or global ILU). Default is 1.
+ * \param[in] levels non-negative fill levels
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setILULevels(int levels){
+	m_iluLevels = std::max(0, levels);
+}
+
+/*!
+ * It sets the overlap of ASM subdomains. Default is 1.
+ * \param[in] overlap non-negative overlap
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setASMOverlap(int overlap){
+	m_asmOverlap = std::max(0, overlap);
+}
+
+/*!
+ * It sets the restart of GMRES-like Krylov solvers. Default is 30.
+ * \param[in] restart positive restart value
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setRestart(int restart){
+	m_restart = std::max(1, restart);
+}
+
+/*!
+ * If active, the assembled linear system, its preconditioner and the border laplacian stencils
+ * are kept alive at the end of the execution. The next execution reuses them as long as the target mesh,
+ * the boundary patches and nodes, the dumping settings and the solver settings are unchanged,
+ * and starts the Krylov iterations from the previous solution. This is meant for repeated
+ * executions with different Dirichlet values on the same mesh, as in design sweeps. Default is false.
+ * \param[in] persistent true to keep the solver between executions.
+ */
+template <std::size_t NCOMP>
+void PropagateField<NCOMP>::setPersistentSolver(bool persistent){
+	m_persistentSolver = persistent;
+	if(!persistent){
+		m_persistentStencils = nullptr;
+		m_previousSolution.clear();
+		m_solverSignature = 0;
+	}
+}
+
+/*!
+ * \return number of iterations of each linear solve performed during the last execution.
+ */
+template <std::size_t NCOMP>
+livector1D PropagateField<NCOMP>::getSolverIterations(){
+	return m_solverIterations;
+}
+
+/*!
+ * \return wall time in seconds of each linear solve performed during the last execution.
+ */
+template <std::size_t NCOMP>
+dvector1D PropagateField<NCOMP>::getSolverTimes(){
+	return m_solverTimes;
+}
+
 /*!
  * It sets infos reading from a XML bitpit::Config::section.
  * \param[in] slotXML bitpit::Config::Section of XML file
@@ -422,6 +538,69 @@ void PropagateField<NCOMP>::absorbSectionXML(const bitpit::Config::Section & slo
         setPrint(value);
     }
 
+	if(slotXML.hasOption("SolverType")){
+		std::string input  = slotXML.get("SolverType");
+		int value =0;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss>>value;
+		}
+		value = std::max(0, std::min(3, value));
+		setSolverType(static_cast<PropagatorKrylov>(value));
+	};
+
+	if(slotXML.hasOption("Preconditioner")){
+		std::string input  = slotXML.get("Preconditioner");
+		int value =0;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss>>value;
+		}
+		value = std::max(0, std::min(4, value));
+		setPreconditioner(static_cast<PropagatorPreconditioner>(value));
+	};
+
+	if(slotXML.hasOption("ILULevels")){
+		std::string input  = slotXML.get("ILULevels");
+		int value = 1;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss>>value;
+		}
+		setILULevels(value);
+	};
+
+	if(slotXML.hasOption("ASMOverlap")){
+		std::string input  = slotXML.get("ASMOverlap");
+		int value = 1;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss>>value;
+		}
+		setASMOverlap(value);
+	};
+
+	if(slotXML.hasOption("Restart")){
+		std::string input  = slotXML.get("Restart");
+		int value = 30;
+		if(!input.empty()){
+			std::stringstream ss(bitpit::utils::string::trim(input));
+			ss>>value;
+		}
+		setRestart(value);
+	};
+
+	if(slotXML.hasOption("PersistentSolver")){
+		std::string input = slotXML.get("PersistentSolver");
+		input = bitpit::utils::string::trim(input);
+		bool value = false;
+		if(!input.empty()){
+			std::stringstream ss(input);
+			ss >> value;
+		}
+		setPersistentSolver(value);
+	}
+
 };
 
 /*!
@@ -448,6 +627,12 @@ void PropagateField<NCOMP>::flushSectionXML(bitpit::Config::Section & slotXML, s
 	slotXML.set("Method",std::to_string(static_cast<long>(m_method)));
     slotXML.set("ForceDirichlet",std::to_string(int(m_forceDirichletConditions)));
     slotXML.set("Print",std::to_string(int(m_print)));
+	slotXML.set("SolverType",std::to_string(static_cast<long>(m_krylov)));
+	slotXML.set("Preconditioner",std::to_string(static_cast<long>(m_preconditioner)));
+	slotXML.set("ILULevels",std::to_string(m_iluLevels));
+	slotXML.set("ASMOverlap",std::to_string(m_asmOverlap));
+	slotXML.set("Restart",std::to_string(m_restart));
+	slotXML.set("PersistentSolver",std::to_string(int(m_persistentSolver)));
 };
 
 /*!
@@ -997,6 +1182,83 @@ PropagateField<NCOMP>::updateDumpingFunction(){
 //}
 
 
+/*!
+ * Evaluate a signature of everything the assembled laplacian system depends on: target mesh
+ * (vertex ids and coordinates), Dirichlet boundary patch and nodes, dumping settings and surface,
+ * solver settings. Used to check if a persistent solver can be reused in a new execution.
+ * \return signature value.
+ */
+template<std::size_t NCOMP>
+std::size_t
+PropagateField<NCOMP>::computeSolverSignature(){
+
+	std::size_t signature = 0;
+	auto combine = [&signature](std::size_t value){
+		signature ^= value + 0x9e3779b97f4a7c15ULL + (signature << 6) + (signature >> 2);
+	};
+	std::hash<double> hashd;
+	std::hash<long> hashl;
+	std::hash<const void*> hashp;
+
+	auto combineVertices = [&](MimmoObject * target){
+		combine(hashp(target));
+		if(!target) return;
+		combine(hashl(target->getNVertices()));
+		combine(hashl(target->getNCells()));
+		for(const bitpit::Vertex & vertex : target->getVertices()){
+			combine(hashl(vertex.getId()));
+			const std::array<double,3> & coords = vertex.getCoords();
+			for(int i=0; i<3; ++i)	combine(hashd(coords[i]));
+		}
+	};
+
+	combineVertices(getGeometry());
+
+	combine(hashp(m_bsurface));
+	for(auto it = m_surface_bc_dir.begin(); it != m_surface_bc_dir.end(); ++it){
+		combine(hashl(it.getId()));
+	}
+
+	combine(hashl(m_dumpingActive));
+	if(m_dumpingActive){
+		combine(hashl(m_dumpingType));
+		combine(hashd(m_radius));
+		combine(hashd(m_plateau));
+		combine(hashd(m_decayFactor));
+		combineVertices(m_dsurface);
+	}
+
+	combine(hashd(m_tol));
+	combine(hashl(static_cast<long>(m_method)));
+	combine(hashl(static_cast<long>(m_krylov)));
+	combine(hashl(static_cast<long>(m_preconditioner)));
+	combine(hashl(m_iluLevels));
+	combine(hashl(m_asmOverlap));
+	combine(hashl(m_restart));
+	combine(hashl(m_reusePreconditioner));
+
+	return signature;
+}
+
+/*!
+ * Check if the solver kept from the previous execution can be reused, i.e. persistence is active,
+ * the solver is still assembled and it was assembled with the same signature.
+ * In MPI runs the check is shared by all the processes.
+ * \param[in] signature current signature, as returned by computeSolverSignature.
+ * \return true if the persistent solver can be reused.
+ */
+template<std::size_t NCOMP>
+bool
+PropagateField<NCOMP>::isSolverReusable(std::size_t signature){
+
+	bool reusable = m_persistentSolver && m_solver && m_solver->isAssembled()
+					&& m_persistentStencils && (signature == m_solverSignature);
+#if MIMMO_ENABLE_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &reusable, 1, MPI_C_BOOL, MPI_LAND, m_communicator);
+#endif
+	return reusable;
+}
+
 /*!
  * Prepare your system solver, feeding the laplacian stencils you previosly calculated
  * with GraphLaplStencil::computeLaplacianStencil method.
@@ -1053,12 +1315,87 @@ PropagateField<NCOMP>::initializeLaplaceSolver(GraphLaplStencil::MPVStencil * la
 	//assembly the matrix;
 	matrix.assembly();
 
+	assemblyLaplaceSolver(matrix);
+}
+
+/*!
+ * Prepare your system solver, feeding the graph laplacian rows you previously calculated
+ * in compressed sparse row format with GraphLaplStencil::computeLaplacianCSR method.
+ * Provide the map that get consecutive Index from Global Pierced vector Index system for POINTS
+ * The rows will be renumerated with the consecutiveIdIndexing provided, without building
+ * any intermediate stencil.
+ *
+ * param[in] laplacian graph laplacian rows in CSR format.
+ * param[in] map of consecutive points ID from Global PV indexing (typically get from MimmoObject::getMapDataInv)
+ */
+template<std::size_t NCOMP>
+void
+PropagateField<NCOMP>::initializeLaplaceSolver(const GraphLaplStencil::LaplacianCSR & laplacian, const liimap & maplocals){
+
+	bitpit::KSPOptions &solverOptions = m_solver->getKSPOptions();
+
+	solverOptions.rtol      = m_tol;
+	solverOptions.subrtol   = m_tol;
+	// total number of local DOFS, determines size of matrix
+	long nDOFs = laplacian.ids.size();
+
+	// total number of non-zero elements in the rows.
+	long nNZ = laplacian.columns.size();
+
+#if MIMMO_ENABLE_MPI==1
+	//instantiate the SparseMatrix
+	bitpit::SparseMatrix matrix(m_communicator, getGeometry()->getPatch()->isPartitioned(), nDOFs, nDOFs, nNZ);
+#else
+	//instantiate the SparseMatrix
+	bitpit::SparseMatrix matrix(nDOFs, nDOFs, nNZ);
+#endif
+
+	// order the rows by local index, renumbering the columns.
+	std::vector<std::size_t> mapsort(nDOFs);
+	std::vector<long> columns(nNZ);
+	long ind;
+	for(std::size_t row = 0; row < laplacian.ids.size(); ++row){
+		ind = maplocals.at(laplacian.ids[row]);
+#if MIMMO_ENABLE_MPI
+		ind -= getGlobalCountOffset(m_method);
+#endif
+		mapsort[ind] = row;
+		for(std::size_t k = laplacian.offsets[row]; k < laplacian.offsets[row+1]; ++k){
+			columns[k] = maplocals.at(laplacian.columns[k]);
+		}
+	}
+
+	//Add ordered rows
+	for(std::size_t row : mapsort){
+		std::size_t begin = laplacian.offsets[row];
+		matrix.addRow(laplacian.offsets[row+1] - begin, columns.data() + begin, laplacian.weights.data() + begin);
+	}
+
+	//assembly the matrix;
+	matrix.assembly();
+
+	assemblyLaplaceSolver(matrix);
+}
+
+/*!
+ * Initialize the system solver with an assembled laplacian matrix, cleaning up
+ * the previous solver contents and statistics, and applying the current solver options.
+ *
+ * param[in] matrix assembled laplacian matrix.
+ */
+template<std::size_t NCOMP>
+void
+PropagateField<NCOMP>::assemblyLaplaceSolver(bitpit::SparseMatrix & matrix){
+
 	//clean up the previous stuff in the solver.
 	m_solver->clear();
+	m_solverIterations.clear();
+	m_solverTimes.clear();
 	// now you can initialize the m_solver with this matrix.
-	m_solver->getKSPOptions().restart = 30;
-	m_solver->getKSPOptions().overlap = 1;
-	m_solver->getKSPOptions().sublevels = 1;
+	m_solver->getKSPOptions().restart = m_restart;
+	m_solver->getKSPOptions().overlap = m_asmOverlap;
+	m_solver->getKSPOptions().sublevels = m_iluLevels;
+	setSolverOptions();
 	m_solver->assembly(matrix);
 }
 
@@ -1119,6 +1456,60 @@ PropagateField<NCOMP>::updateLaplaceSolver(FVolStencil::MPVDivergence * laplacia
 
 }
 
+/*!
+ * Update your system solver, feeding the graph laplacian rows in compressed sparse row format
+ * you want to update in the matrix (see GraphLaplStencil::computeLaplacianCSR).
+ * This method works with any valid subset of rows in the mesh, but require the solver matrix to be initialized
+ * and to have the new rows with the same id pattern as they had at the time of the matrix initialization.
+ * Provide the map that get consecutive Index from Global Pierced vector Index system for POINTS
+ * The rows will be renumerated with the consecutiveIdIndexing provided.
+ *
+ * param[in] laplacian graph laplacian rows subset in CSR format to feed as update.
+ * param[in] map of consecutive points ID from Global PV indexing (typically get from MimmoObject::getMapDataInv)
+ */
+template<std::size_t NCOMP>
+void
+PropagateField<NCOMP>::updateLaplaceSolver(const GraphLaplStencil::LaplacianCSR & laplacian, const liimap & maplocals){
+
+	// total number of local DOFS, determines size of matrix
+	long nDOFs = m_solver->getColCount();
+	long nupdate = laplacian.ids.size();
+
+	// total number of non-zero elements in the rows.
+	long nNZ = laplacian.columns.size();
+
+#if MIMMO_ENABLE_MPI==1
+	//instantiate the SparseMatrix
+	bitpit::SparseMatrix upelements(m_communicator, getGeometry()->getPatch()->isPartitioned(), nupdate, nDOFs, nNZ);
+#else
+	//instantiate the SparseMatrix
+	bitpit::SparseMatrix upelements(nupdate, nDOFs, nNZ);
+#endif
+
+	// store the local ind of the rows involved, while filling the matrix of update values.
+	std::vector<long> rows_involved(nupdate);
+	std::vector<long> columns(nNZ);
+	long ind;
+	for(std::size_t row = 0; row < laplacian.ids.size(); ++row){
+		ind = maplocals.at(laplacian.ids[row]);
+#if MIMMO_ENABLE_MPI
+		ind -= getGlobalCountOffset(m_method);
+#endif
+		rows_involved[row] = ind;
+		std::size_t begin = laplacian.offsets[row];
+		for(std::size_t k = begin; k < laplacian.offsets[row+1]; ++k){
+			columns[k] = maplocals.at(laplacian.columns[k]);
+		}
+		upelements.addRow(laplacian.offsets[row+1] - begin, columns.data() + begin, laplacian.weights.data() + begin);
+	}
+	//assembly the update matrix;
+	upelements.assembly();
+
+	//call the solver update;
+	m_solver->update(rows_involved, upelements);
+
+}
+
 /*!
  * This method evaluate the bc corrections for a singular run of the system solver,
  * update the system matrix in m_solver and evaluate the rhs part due to bc.
@@ -1234,13 +1625,17 @@ PropagateField<NCOMP>::assignBCAndEvaluateRHS(std::size_t comp, bool unused,
  * \param[in] borderLaplacianStencil list of laplacian Stencil on border nodes, where the bc is temporarely imposed as homogeneous Neumann
  * \param[in] maplocals map from global id numbering to local system solver numbering.
  * \param[in,out] rhs vector of right-hand-side's to append constant data from bc corrections.
+ * \param[in] updateMatrix if false the system matrix is not updated and only the rhs is evaluated.
+ * Dirichlet rows of the matrix do not depend on the component, so the update can be skipped
+ * when the matrix was already corrected for another component with the same bc nodes; this
+ * preserves the preconditioner already set up by the solver.
  */
 template<std::size_t NCOMP>
 void
 PropagateField<NCOMP>::assignBCAndEvaluateRHS(std::size_t comp, bool unused,
 		GraphLaplStencil::MPVStencil * borderLaplacianStencil,
 		const liimap & maplocals,
-		dvector1D & rhs)
+		dvector1D & rhs, bool updateMatrix)
 {
 	BITPIT_UNUSED(unused);
 	//resize rhs to the number of internal cells
@@ -1281,7 +1676,9 @@ PropagateField<NCOMP>::assignBCAndEvaluateRHS(std::size_t comp, bool unused,
 
 	// now its time to update the solver matrix and to extract the rhs contributes.
 	//NOTE: USE THE FINITE VOLUMES METHOD, THE STRUCTURES ARE THE SAME!
-	updateLaplaceSolver(lapwork.get(), maplocals);
+	if(updateMatrix){
+		updateLaplaceSolver(lapwork.get(), maplocals);
+	}
 
 	// now get the rhs
 	for(auto it = lapwork->begin(); it != lapwork->end();++it){
@@ -1324,11 +1721,53 @@ PropagateField<NCOMP>::solveLaplace(const dvector1D &rhs, dvector1D &result){
 	}
 
 	// Solve the system
+	std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
 	m_solver->solve(rhs, &result);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	long its = m_solver->getKSPStatus().its;
+	m_solverIterations.push_back(its);
+	m_solverTimes.push_back(elapsed.count());
+	(*m_log)<<m_name<<" : linear system solved in "<<its<<" iterations, "<<elapsed.count()<<" s"<<std::endl;
 
 	//think I've done my job.
 }
 
+/*!
+ * It solves the laplacian problem for multiple right-hand-sides sharing the same system matrix
+ * (e.g. the components of a vector field). All the systems are solved in a row on the
+ * current assembled solver, so that the preconditioner is set up only once, on the first
+ * solve, and reused by the following ones.
+ * Before calling this method be sure to have initialized the Laplacian linear system and
+ * to have applied all the matrix updates required.
+ *
+ * \param[in] rhs list of right-hand-sides on internal nodes;
+ * \param[in,out] results list of results on internal nodes. In input are initial solutions, in output are the results of computation.
+ */
+template<std::size_t NCOMP>
+void
+PropagateField<NCOMP>::solveLaplace(const dvector2D &rhs, dvector2D &results){
+
+	results.resize(rhs.size());
+	for(std::size_t i=0; i<rhs.size(); ++i){
+		solveLaplace(rhs[i], results[i]);
+	}
+}
+
+/*!
+ * Pass Krylov solver and preconditioner choices to the system solver, that applies them
+ * directly on its KSP and PC objects during setup (see PropagatorSolver).
+ * If preconditioner reuse is active, the preconditioner is set up on the first solve only and
+ * kept across the following matrix value updates.
+ */
+template<std::size_t NCOMP>
+void
+PropagateField<NCOMP>::setSolverOptions(){
+	m_solver->setKrylov(m_krylov);
+	m_solver->setPreconditioner(m_preconditioner);
+	m_solver->setReusePreconditioner(m_reusePreconditioner);
+}
+
 /*!
  * Utility to put laplacian solution into a Cell/Node based MPV and (after point interpolation if needed)
  * directly in m_field (cleared and refreshed).
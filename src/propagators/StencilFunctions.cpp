@@ -26,6 +26,10 @@
 #include "StencilFunctions.hpp"
 #include "bitpit_LA.hpp"
 #include "bitpit_CG.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
 
 namespace mimmo {
 
@@ -583,175 +587,248 @@ MPVDivergenceUPtr computeFVLaplacianStencil (MPVGradient & faceGradientStencil,
 namespace GraphLaplStencil{
 
 /*!
- * The method computes the Laplacian stencils on points as graph laplacian approximation.
- * The resulting laplacian stencils will be available on mesh interior points of the mesh as saved in m_isInterior member.
- * Providing the right set of points you can use this method both to compute laplacian stencils on
- * the whole mesh or as updater of its subportions.
+ * Internal method function -> used by computeLaplacianCSR.
+ * Interpolate a diffusivity field defined on cells to the mesh points, with the same inverse
+ * distance weighting of MimmoPiercedVector::cellDataToPointData (p = 1.5). Cell contributions are
+ * evaluated concurrently and accumulated following the cell order, so that the result does not
+ * depend on the number of threads. Points not reached by the field get a NaN value, so that
+ * their use can be detected by the caller.
  *
- * Diffusivity (if any) needs to be referred to the input mesh.
- * In case of subportions updater usage, be sure diffusivity includes info on all the points involved.
-
  * \param[in] geo target mesh
- * \param[in] tolerance threshold value used to filter out stencil items
- * \param[in] diffusivity (optional) impose a diffusivity field on POINT (provided also on ghost points)
+ * \param[in] diffusivity diffusivity field on cells
+ * \param[in] nraw size of the vertex raw index space
+ * \param[out] pdiffusivity point diffusivity indexed by vertex raw index
  */
-MPVStencilUPtr computeLaplacianStencils(MimmoObject & geo, double tolerance,
-                                             MimmoPiercedVector<double> * diffusivity)
+static void interpolateDiffusivity(MimmoObject & geo, MimmoPiercedVector<double> & diffusivity, std::size_t nraw, std::vector<double> & pdiffusivity)
 {
+    bitpit::PiercedVector<bitpit::Vertex> & vertices = geo.getVertices();
+
+    std::vector<const bitpit::Cell*> cells;
+    std::vector<std::size_t> offsets(1, 0);
+    cells.reserve(geo.getNCells());
+    offsets.reserve(geo.getNCells() + 1);
+    for (bitpit::Cell & cell : geo.getCells()){
+        if (diffusivity.exists(cell.getId())){
+            cells.push_back(&cell);
+            offsets.push_back(offsets.back() + cell.getVertexCount());
+        }
+    }
+    long ncells = long(cells.size());
+
+    std::vector<std::size_t> raws(offsets.back());
+    std::vector<double> weights(offsets.back());
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long icell = 0; icell < ncells; ++icell){
+        const bitpit::Cell & cell = *cells[icell];
+        std::array<double,3> center = geo.getPatch()->evalCellCentroid(cell.getId());
+        std::size_t pos = offsets[icell];
+        for (long idvertex : cell.getVertexIds()){
+            raws[pos] = vertices.getRawIndex(idvertex);
+            weights[pos] = 1. / std::pow(norm2(center - vertices.rawAt(raws[pos]).getCoords()), 1.5);
+            ++pos;
+        }
+    }
 
-	BITPIT_UNUSED(tolerance);
-
-    // prepare and allocate the result list for laplacian stencils.
-	MPVStencilUPtr result = MPVStencilUPtr(new MPVStencil(&geo, MPVLocation::POINT));
-
-    result->reserve(geo.getNInternalVertices());
-    for(auto id : geo.getVertices().getIds()){
-    	if (geo.isPointInterior(id))
-    		result->insert(id, bitpit::StencilScalar());
+    pdiffusivity.assign(nraw, 0.);
+    std::vector<double> sumWeights(nraw, 0.);
+    for (long icell = 0; icell < ncells; ++icell){
+        double value = diffusivity.at(cells[icell]->getId());
+        for (std::size_t pos = offsets[icell]; pos < offsets[icell + 1]; ++pos){
+            pdiffusivity[raws[pos]] += value*weights[pos];
+            sumWeights[raws[pos]] += weights[pos];
+        }
     }
+    for (std::size_t raw = 0; raw < nraw; ++raw){
+        pdiffusivity[raw] = (sumWeights[raw] > 0.) ? pdiffusivity[raw] / sumWeights[raw] : std::numeric_limits<double>::quiet_NaN();
+    }
+}
 
+/*!
+ * The method computes the graph Laplacian rows on points directly in compressed sparse row format.
+ * Rows are computed for the mesh interior points only, in the order they are provided.
+ * The weight of each edge is the averaged diffusivity of its nodes divided by the squared edge length,
+ * normalized on the sum of the row weights. The central node is the last item of each row,
+ * with a weight equal to minus the sum of the other weights.
+ * Rows are evaluated concurrently on vertex ranges if OpenMP is enabled, writing directly on
+ * the preallocated CSR storage, without any per-row allocation.
+ *
+ * Diffusivity (if any) needs to be referred to the input mesh, and it has to be defined on at least
+ * one cell around each point involved in the rows, otherwise an std::out_of_range exception is thrown.
+ *
+ * \param[in] geo target mesh
+ * \param[in] nodesList target nodes (if nullptr all the mesh points are considered)
+ * \param[out] csr laplacian rows in compressed sparse row format
+ * \param[in] diffusivity (optional) impose a diffusivity field on CELLS
+ */
+void computeLaplacianCSR(MimmoObject & geo, const std::vector<long> * nodesList, LaplacianCSR & csr,
+                         MimmoPiercedVector<double> * diffusivity)
+{
     //fill edges
     if (!geo.isPointConnectivitySync())
-    	geo.buildPointConnectivity();
+        geo.buildPointConnectivity();
+
+    bitpit::PiercedVector<bitpit::Vertex> & vertices = geo.getVertices();
+    std::size_t nraw = 0;
+    for (auto it = vertices.begin(); it != vertices.end(); ++it){
+        nraw = std::max(nraw, std::size_t(it.getRawIndex()) + 1);
+    }
 
     //interpolate diffusivity
-    MimmoPiercedVector<double> pdiffusivity;
+    std::vector<double> pdiffusivity;
     if (diffusivity)
-    	pdiffusivity = diffusivity->cellDataToPointData(1.5);
+        interpolateDiffusivity(geo, *diffusivity, nraw, pdiffusivity);
     else
-    	pdiffusivity.initialize(&geo, MPVLocation::POINT, 1.);
-
-    //loop on point connectivity
-   MimmoPiercedVector<double> sums;
-   sums.initialize(&geo, MPVLocation::POINT, 0.);
-    double d_1;
-    double p = 2.0;
-    double localdiff, avgdiff;
-    for (long id1 : geo.getVertices().getIds()){
-        localdiff = pdiffusivity.at(id1);
-        auto pconn = geo.getPointConnectivity(id1);
-        for (long id2 : pconn){
-            avgdiff = 0.5*(localdiff + pdiffusivity.at(id2));
-            d_1 =1.0/std::pow(norm2(geo.getVertexCoords(id1)-geo.getVertexCoords(id2)),p);
-            d_1 *= avgdiff;
-            sums[id1] += d_1;
-
-    		if (geo.isPointInterior(id1))
-    		{
-    			result->at(id1).appendItem(id2, d_1);
-    		}
-    	}
+        pdiffusivity.assign(nraw, 1.);
+
+    //rows and their sizes
+    csr.ids.clear();
+    csr.offsets.assign(1, 0);
+    if (nodesList){
+        csr.ids.reserve(nodesList->size());
+        csr.offsets.reserve(nodesList->size() + 1);
+        for (long id : *nodesList){
+            if (geo.isPointInterior(id)){
+                csr.ids.push_back(id);
+                csr.offsets.push_back(csr.offsets.back() + geo.getPointConnectivity(id).size() + 1);
+            }
+        }
+    }else{
+        csr.ids.reserve(geo.getNInternalVertices());
+        csr.offsets.reserve(geo.getNInternalVertices() + 1);
+        for (long id : vertices.getIds()){
+            if (geo.isPointInterior(id)){
+                csr.ids.push_back(id);
+                csr.offsets.push_back(csr.offsets.back() + geo.getPointConnectivity(id).size() + 1);
+            }
+        }
     }
+    long nrows = long(csr.ids.size());
+    csr.columns.resize(csr.offsets.back());
+    csr.weights.resize(csr.offsets.back());
+
+    bool missing = false;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(static) reduction(||:missing)
+#endif
+    for (long row = 0; row < nrows; ++row){
+        long id1 = csr.ids[row];
+        std::size_t raw1 = vertices.getRawIndex(id1);
+        const std::array<double,3> & coords1 = vertices.rawAt(raw1).getCoords();
+        double localdiff = pdiffusivity[raw1];
+        missing = missing || std::isnan(localdiff);
+
+        std::size_t begin = csr.offsets[row];
+        std::size_t pos = begin;
+        double sum = 0.;
+        for (long id2 : geo.getPointConnectivity(id1)){
+            std::size_t raw2 = vertices.getRawIndex(id2);
+            const std::array<double,3> & coords2 = vertices.rawAt(raw2).getCoords();
+            double dx = coords2[0] - coords1[0];
+            double dy = coords2[1] - coords1[1];
+            double dz = coords2[2] - coords1[2];
+            missing = missing || std::isnan(pdiffusivity[raw2]);
+            double d_1 = 0.5*(localdiff + pdiffusivity[raw2]) / (dx*dx + dy*dy + dz*dz);
+            csr.columns[pos] = id2;
+            csr.weights[pos] = d_1;
+            sum += d_1;
+            ++pos;
+        }
 
-    //Weighted average
-    double denom;
-    for(MPVStencil::iterator it = result->begin(); it !=result->end(); ++it){
-        denom =  sums[it.getId()];
-        *it /= denom;
+        //Weighted average and diagonal value (-1)
+        double complement = 0.;
+        for (std::size_t k = begin; k < pos; ++k){
+            csr.weights[k] /= sum;
+            complement -= csr.weights[k];
+        }
+        csr.columns[pos] = id1;
+        csr.weights[pos] = complement;
     }
 
-    //Insert diagonal values (-1)
-    for (long id : geo.getPatch()->getVertices().getIds()){
-    	if (geo.isPointInterior(id))
-    	{
-    		result->at(id).addComplementToZero(id); // adding the central node weight as minus sum of other weights.
-    		result->at(id).flatten();
-    	}
+    if (missing){
+        throw std::out_of_range("GraphLaplStencil::computeLaplacianCSR : diffusivity field not available on some of the points involved");
     }
+}
+
+/*!
+ * Convert graph Laplacian rows in compressed sparse row format to laplacian stencils.
+ *
+ * \param[in] geo target mesh
+ * \param[in] csr laplacian rows in compressed sparse row format
+ * \param[in] selection (optional) convert only the rows of the points in the list.
+ * \return laplacian stencils on points
+ */
+MPVStencilUPtr extractStencils(MimmoObject & geo, const LaplacianCSR & csr, const std::vector<long> * selection)
+{
+    MPVStencilUPtr result = MPVStencilUPtr(new MPVStencil(&geo, MPVLocation::POINT));
 
-    //Stencils optimize
-//    for(MPVStencil::iterator it = result->begin(); it !=result->end(); ++it){
-//        //it->optimize(tolerance);
-//    }
+    std::unordered_set<long> selected;
+    if (selection){
+        selected.insert(selection->begin(), selection->end());
+        result->reserve(selected.size());
+    }else{
+        result->reserve(csr.ids.size());
+    }
 
+    for (std::size_t row = 0; row < csr.ids.size(); ++row){
+        if (selection && !selected.count(csr.ids[row])) continue;
+        bitpit::StencilScalar stencil;
+        for (std::size_t k = csr.offsets[row]; k < csr.offsets[row + 1]; ++k){
+            stencil.appendItem(csr.columns[k], csr.weights[k]);
+        }
+        result->insert(csr.ids[row], std::move(stencil));
+    }
     return result;
 }
 
 /*!
- * The method compute the Laplacian stencils only on a set of points as graph laplacian approximation.
+ * The method computes the Laplacian stencils on points as graph laplacian approximation.
  * The resulting laplacian stencils will be available on mesh interior points of the mesh as saved in m_isInterior member.
  * Providing the right set of points you can use this method both to compute laplacian stencils on
  * the whole mesh or as updater of its subportions.
+ * Stencils are evaluated through computeLaplacianCSR.
  *
  * Diffusivity (if any) needs to be referred to the input mesh.
  * In case of subportions updater usage, be sure diffusivity includes info on all the points involved.
 
  * \param[in] geo target mesh
- * \param[in] nodesList target nodes to be updated
  * \param[in] tolerance threshold value used to filter out stencil items
- * \param[in] diffusivity (optional) impose a diffusivity field on POINT (provided also on ghost points)
+ * \param[in] diffusivity (optional) impose a diffusivity field on CELLS
  */
-MPVStencilUPtr computeLaplacianStencils(MimmoObject & geo, std::vector<long>* nodesList, double tolerance,
+MPVStencilUPtr computeLaplacianStencils(MimmoObject & geo, double tolerance,
                                              MimmoPiercedVector<double> * diffusivity)
 {
-
 	BITPIT_UNUSED(tolerance);
 
-    // prepare and allocate the result list for laplacian stencils.
-	MPVStencilUPtr result = MPVStencilUPtr(new MPVStencil(&geo, MPVLocation::POINT));
-
-    result->reserve(nodesList->size());
-    for(auto id : *nodesList){
-    	if (geo.isPointInterior(id))
-    	{
-    		result->insert(id, bitpit::StencilScalar());
-    	}
-    }
-
-    //fill edges
-    if (!geo.isPointConnectivitySync())
-    	geo.buildPointConnectivity();
-
-    //interpolate diffusivity
-    MimmoPiercedVector<double> pdiffusivity;
-    if (diffusivity)
-    	pdiffusivity = diffusivity->cellDataToPointData(1.5);
-    else
-    	pdiffusivity.initialize(&geo, MPVLocation::POINT, 1.);
-
-    //loop on edges
-    MimmoPiercedVector<double> sums;
-    sums.initialize(&geo, MPVLocation::POINT, 0.);
-    double d_1;
-    double p = 2.0;
-    double localdiff, avgdiff;
-    for (long id1 : *nodesList){
-        localdiff = pdiffusivity.at(id1);
-        auto pconn = geo.getPointConnectivity(id1);
-        for (long id2 : pconn){
-            avgdiff = 0.5*(localdiff + pdiffusivity.at(id2));
-            d_1 =1.0/std::pow(norm2(geo.getVertexCoords(id1)-geo.getVertexCoords(id2)),p);
-            d_1 *= avgdiff;
-            sums[id1] += d_1;
-    		if (geo.isPointInterior(id1))
-    		{
-    			result->at(id1).appendItem(id2, d_1);
-    		}
-    	}
-    }
-
-    //Weighted average
-    double denom;
-    for(MPVStencil::iterator it = result->begin(); it !=result->end(); ++it){
-    	denom = sums[it.getId()];
-    	*it /= denom;
-    }
+	LaplacianCSR csr;
+	computeLaplacianCSR(geo, nullptr, csr, diffusivity);
+	return extractStencils(geo, csr);
+}
 
-    //Insert diagonal values (-1)
-    for (long id : *nodesList){
-    	if (geo.isPointInterior(id))
-    	{
-    		result->at(id).addComplementToZero(id); // adding the central node weight as minus sum of other weights.
-    		result->at(id).flatten();
-    	}
-    }
+/*!
+ * The method compute the Laplacian stencils only on a set of points as graph laplacian approximation.
+ * The resulting laplacian stencils will be available on mesh interior points of the mesh as saved in m_isInterior member.
+ * Providing the right set of points you can use this method both to compute laplacian stencils on
+ * the whole mesh or as updater of its subportions.
+ * Stencils are evaluated through computeLaplacianCSR.
+ *
+ * Diffusivity (if any) needs to be referred to the input mesh.
+ * In case of subportions updater usage, be sure diffusivity includes info on all the points involved.
 
-    //Stencils optimize
-//    for(MPVStencil::iterator it = result->begin(); it !=result->end(); ++it){
-//        //it->optimize(tolerance);
-//    }
+ * \param[in] geo target mesh
+ * \param[in] nodesList target nodes to be updated
+ * \param[in] tolerance threshold value used to filter out stencil items
+ * \param[in] diffusivity (optional) impose a diffusivity field on CELLS
+ */
+MPVStencilUPtr computeLaplacianStencils(MimmoObject & geo, std::vector<long>* nodesList, double tolerance,
+                                             MimmoPiercedVector<double> * diffusivity)
+{
+	BITPIT_UNUSED(tolerance);
 
-    return result;
+	LaplacianCSR csr;
+	computeLaplacianCSR(geo, nodesList, csr, diffusivity);
+	return extractStencils(geo, csr);
 }
 
 
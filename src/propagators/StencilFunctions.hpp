@@ -106,6 +106,22 @@ namespace GraphLaplStencil{
 //                                                            const double &distD,
 //                                                            const bitpit::StencilVector & CCellOwnerStencil);
 
+    /*!
+     * \brief Graph Laplacian rows on points stored in compressed sparse row format.
+     * Columns are expressed as vertex ids.
+     */
+    struct LaplacianCSR{
+        std::vector<long>           ids;        /**< vertex id of each row */
+        std::vector<std::size_t>    offsets;    /**< offsets of each row in columns/weights, size = number of rows + 1 */
+        std::vector<long>           columns;    /**< vertex id of each non-zero item */
+        std::vector<double>         weights;    /**< weight of each non-zero item */
+    };
+
+    void computeLaplacianCSR(MimmoObject & geo, const std::vector<long> * nodesList, LaplacianCSR & csr,
+                             MimmoPiercedVector<double> * diffusivity = nullptr);
+
+    MPVStencilUPtr extractStencils(MimmoObject & geo, const LaplacianCSR & csr, const std::vector<long> * selection = nullptr);
+
     MPVStencilUPtr computeLaplacianStencils(MimmoObject & geo, double tolerance = 1.0e-12,
                                                  MimmoPiercedVector<double> * diffusivity = nullptr);
 
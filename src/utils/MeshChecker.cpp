@@ -35,7 +35,7 @@ MeshChecker::MeshChecker(const bitpit::Config::Section & rootXML){
  */
 MeshChecker::~MeshChecker(){};
 
-/*! Copy Constructor. Result displacements are never copied.
+/*! Copy Constructor. Result displacements, deformation field and cached quantities are never copied.
  *\param[in] other MeshChecker where copy from
  */
 MeshChecker::MeshChecker(const MeshChecker & other):BaseManipulation(other){
@@ -55,6 +55,11 @@ MeshChecker::MeshChecker(const MeshChecker & other):BaseManipulation(other){
 	m_isGood = other.m_isGood;
     m_qualityStatus = other.m_qualityStatus;
     m_printResumeFile = other.m_printResumeFile;
+    m_failureThreshold = other.m_failureThreshold;
+    m_incremental = other.m_incremental;
+    m_sickCount = 0;
+    m_interrupted = false;
+    m_cacheSync = false;
 };
 
 /*!
@@ -88,6 +93,24 @@ MeshChecker::swap(MeshChecker & x) noexcept
 	std::swap(m_isGood, x.m_isGood);
     std::swap(m_qualityStatus, x.m_qualityStatus);
     std::swap(m_printResumeFile, x.m_printResumeFile);
+    std::swap(m_failureThreshold, x.m_failureThreshold);
+    std::swap(m_incremental, x.m_incremental);
+    m_deformation.swap(x.m_deformation);
+    std::swap(m_sickCount, x.m_sickCount);
+    std::swap(m_interrupted, x.m_interrupted);
+    std::swap(m_cacheSync, x.m_cacheSync);
+    std::swap(m_cellRaws, x.m_cellRaws);
+    std::swap(m_interfaceRaws, x.m_interfaceRaws);
+    std::swap(m_cellEval, x.m_cellEval);
+    std::swap(m_interfaceEval, x.m_interfaceEval);
+    std::swap(m_cellCentroids, x.m_cellCentroids);
+    std::swap(m_cellVolumes, x.m_cellVolumes);
+    std::swap(m_cellVolumeChange, x.m_cellVolumeChange);
+    std::swap(m_cellFaceValidity, x.m_cellFaceValidity);
+    std::swap(m_interfaceCentroids, x.m_interfaceCentroids);
+    std::swap(m_interfaceNormals, x.m_interfaceNormals);
+    std::swap(m_interfaceAreas, x.m_interfaceAreas);
+    std::swap(m_interfaceSkewness, x.m_interfaceSkewness);
 }
 
 /*!
@@ -112,7 +135,12 @@ MeshChecker::setDefault()
 	m_isGood = false;
     m_qualityStatus = CMeshOutput::NOTRUN;
     m_printResumeFile = false;
-	m_volumes.clear();
+    m_failureThreshold = 0;
+    m_incremental = false;
+    m_sickCount = 0;
+    m_interrupted = false;
+    m_deformation.clear();
+	clear();
 }
 
 /*!
@@ -139,8 +167,11 @@ MeshChecker::execute()
     if(m_printResumeFile){
         printResumeFile();
     }
-	//Clear auxiliary variables
-	clear();
+	//Clear auxiliary variables, cached quantities are kept in incremental mode
+	m_deformation.clear();
+	if(!m_incremental){
+		clear();
+	}
 
 }
 
@@ -150,20 +181,25 @@ void
 MeshChecker::buildPorts(){
 	bool built = true;
 	built = (built && createPortIn<MimmoObject*, MeshChecker>(this, &MeshChecker::setGeometry, M_GEOM, true));
+	built = (built && createPortIn<dmpvecarr3E*, MeshChecker>(this, &MeshChecker::setDeformation, M_GDISPLS));
     built = (built && createPortOut<bool, MeshChecker>(this, &mimmo::MeshChecker::isGood, M_VALUEB));
     built = (built && createPortOut<int, MeshChecker>(this, &mimmo::MeshChecker::getQualityStatusInt, M_VALUEI));
 	m_arePortsBuilt = built;
 };
 
 /*!
-    Overload BaseManipulation setGeometry
+    Overload BaseManipulation setGeometry. Cached quantities are cleared only if
+    the linked geometry changes, so that they survive in incremental mode when the
+    same geometry is passed again (e.g. by port at each chain execution).
     \param[in] geo target geometry
 */
 void MeshChecker::setGeometry(MimmoObject * geo){
     if(geo){
-        BaseManipulation::setGeometry(geo);
         //Clear auxiliary variables
-        clear();
+        if(geo != getGeometry()){
+            clear();
+        }
+        BaseManipulation::setGeometry(geo);
     }
 }
 
@@ -231,6 +267,44 @@ MeshChecker::setPrintResumeFile(bool flag)
 }
 
 
+/*!
+ * Set the number of sick elements (cells or interfaces failing any check) which stops the check.
+ * Once the threshold is reached the remaining elements are not checked, so that the found indicators
+ * are partial, but the quality status reports anyway a failure. With MPI the threshold is applied per process.
+ * \param[in] nsick number of sick elements, 0 (default) to never stop
+ */
+void
+MeshChecker::setFailureThreshold(long nsick)
+{
+	m_failureThreshold = std::max(long(0), nsick);
+}
+
+/*!
+ * Set the incremental mode. Cached geometric quantities and indicators are kept after execution,
+ * and on the following one only the cells with at least one vertex moved by the deformation field
+ * (see setDeformation), and their neighbours, are checked again. A full check is performed if no
+ * deformation field is provided or if the geometry changed its topology. Default is false.
+ * \param[in] flag true to activate incremental mode
+ */
+void
+MeshChecker::setIncremental(bool flag)
+{
+	m_incremental = flag;
+	if(!flag) clear();
+}
+
+/*!
+ * Set the deformation field applied to the linked geometry since the last check (incremental mode).
+ * The field is consumed by the following execution.
+ * \param[in] field deformation field defined on geometry vertices
+ */
+void
+MeshChecker::setDeformation(dmpvecarr3E * field)
+{
+	if(!field) return;
+	m_deformation = *field;
+}
+
 /*!
  * \return true is quality is good
  */
@@ -271,14 +345,26 @@ MeshChecker::checkMeshQuality()
     (*m_log) << bitpit::log::context("mimmo");
 
     try{
-        checkVolume();
+        resetIndicators();
+        updateGeometricCache();
+        checkCells();
         checkSkewness();
-    	checkFaceValidity();
     }catch(std::exception & e){
+        m_cacheSync = false;
         (*m_log)<<m_name<<" : FAILED to calculate quality indicators. Check NOT RUN"<< std::endl;
         return check;
     }
 
+    //indicators of not visited elements are stale, next check has to be complete.
+    if(m_interrupted) m_cacheSync = false;
+    bool interrupted = m_interrupted;
+#if MIMMO_ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &interrupted, 1, MPI_CXX_BOOL, MPI_LOR, m_communicator);
+#endif
+    if(interrupted){
+        (*m_log)<<m_name<<" : check STOPPED after "<<m_failureThreshold<<" sick elements, indicators are partial"<< std::endl;
+    }
+
     check = CMeshOutput::GOOD;
 #if MIMMO_ENABLE_MPI
     MPI_Barrier(m_communicator);
@@ -359,288 +445,475 @@ MeshChecker::checkMeshQuality()
 	return check;
 }
 
-/*! It check the quality of the volume cells of the mesh
- * \return false if one of the volumes tolerance is not satisfied
+/*!
+ * Reset the quality indicators before a new check.
  */
-bool
-MeshChecker::checkVolume()
+void
+MeshChecker::resetIndicators()
 {
+	m_minVolume = 1.e+18;
+	m_maxVolume = 0.;
+	m_maxSkewness = 0.;
+	m_maxSkewnessBoundary = 0.;
+	m_minFaceValidity = 1.;
+	m_maxFaceValidity = 0.;
+	m_minVolumeChange = 1.;
+	m_sickCount = 0;
+	m_interrupted = false;
+}
 
-	m_volumes.clear();
-    initializeVolumes();
-    if(!getGeometry()->areAdjacenciesBuilt())    getGeometry()->buildAdjacencies();
-
-    livector1D mvolcells;
-    livector1D mvolchangecells;
-
-	for (auto it = getGeometry()->getPatch()->internalBegin(); it!= getGeometry()->getPatch()->internalEnd(); ++it){
-		long id = it.getId();
-		double vol = m_volumes[id];
+/*!
+ * Update the cached geometric quantities: centroids and volumes of cells, centroids, normals and
+ * areas of interfaces (volume meshes only). Each quantity is evaluated once, concurrently if OpenMP is enabled.
+ * In incremental mode, if the cache is still synchronized with the geometry topology and a deformation
+ * field is available, only the cells with at least one displaced vertex and their interfaces are updated.
+ * The cells and interfaces whose indicators have to be evaluated again are marked in m_cellEval and m_interfaceEval.
+ */
+void
+MeshChecker::updateGeometricCache()
+{
+	MimmoObject * geo = getGeometry();
+	bool volumeMesh = (geo->getType() == 2);
+
+	if(!geo->areAdjacenciesBuilt())                     geo->buildAdjacencies();
+	if(volumeMesh && !geo->areInterfacesBuilt())    geo->buildInterfaces();
+
+	bitpit::PiercedVector<bitpit::Cell> & cells = geo->getCells();
+	std::vector<std::size_t> cellRaws;
+	std::vector<std::size_t> interfaceRaws;
+	std::size_t nCellRaw = 0, nInterfaceRaw = 0;
+	cellRaws.reserve(cells.size());
+	for(auto it = cells.begin(); it != cells.end(); ++it){
+		cellRaws.push_back(it.getRawIndex());
+		nCellRaw = std::max(nCellRaw, cellRaws.back() + 1);
+	}
+	if(volumeMesh){
+		bitpit::PiercedVector<bitpit::Interface> & interfaces = geo->getInterfaces();
+		interfaceRaws.reserve(interfaces.size());
+		for(auto it = interfaces.begin(); it != interfaces.end(); ++it){
+			interfaceRaws.push_back(it.getRawIndex());
+			nInterfaceRaw = std::max(nInterfaceRaw, interfaceRaws.back() + 1);
+		}
+	}
 
-		m_minVolume = std::min(m_minVolume, vol);
-		if (vol < m_minVolumeTol){
-			mvolcells.push_back(id);
+	bool incremental = m_incremental && m_cacheSync && !m_deformation.empty() && m_deformation.getGeometry() == geo;
+	incremental = incremental && (cellRaws == m_cellRaws) && (interfaceRaws == m_interfaceRaws);
+
+	//cells whose geometric quantities have changed.
+	std::vector<char> dirty;
+	if(!incremental){
+		m_cellRaws.swap(cellRaws);
+		m_interfaceRaws.swap(interfaceRaws);
+		m_cellCentroids.assign(nCellRaw, {{0.,0.,0.}});
+		m_cellVolumes.assign(nCellRaw, 0.);
+		m_cellVolumeChange.assign(nCellRaw, 1.);
+		m_cellFaceValidity.assign(nCellRaw, 1.);
+		m_interfaceCentroids.assign(nInterfaceRaw, {{0.,0.,0.}});
+		m_interfaceNormals.assign(nInterfaceRaw, {{0.,0.,0.}});
+		m_interfaceAreas.assign(nInterfaceRaw, 0.);
+		m_interfaceSkewness.assign(nInterfaceRaw, 0.);
+		dirty.assign(nCellRaw, 1);
+		m_cellEval.assign(nCellRaw, 1);
+		m_interfaceEval.assign(nInterfaceRaw, 1);
+	}else{
+		bitpit::PiercedVector<bitpit::Vertex> & vertices = geo->getVertices();
+		std::size_t nVertexRaw = 0;
+		for(auto it = vertices.begin(); it != vertices.end(); ++it){
+			nVertexRaw = std::max(nVertexRaw, std::size_t(it.getRawIndex()) + 1);
+		}
+		std::vector<char> moved(nVertexRaw, 0);
+		for(auto it = m_deformation.begin(); it != m_deformation.end(); ++it){
+			if(norm2(*it) > 0. && vertices.exists(it.getId())){
+				moved[vertices.getRawIndex(it.getId())] = 1;
+			}
 		}
 
-		m_maxVolume = std::max(m_maxVolume, vol);
-		if (vol > m_maxVolumeTol){
-			mvolcells.push_back(id);
+		long nCells = long(m_cellRaws.size());
+		dirty.assign(nCellRaw, 0);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+		for(long i=0; i<nCells; ++i){
+			std::size_t raw = m_cellRaws[i];
+			bitpit::ConstProxyVector<long> vIds = cells.rawAt(raw).getVertexIds();
+			for(long idV : vIds){
+				if(moved[vertices.getRawIndex(idV)]){
+					dirty[raw] = 1;
+					break;
+				}
+			}
 		}
 
-		double ratio = 1.;
-		int nneigh = it->getAdjacencyCount();
-		long* neighs = it->getAdjacencies();
-		for (int i=0; i<nneigh; i++){
-			long neigh = neighs[i];
-			if (neigh > -1)
-				ratio = std::min(ratio, vol/m_volumes[neigh]);
+		//volume change ratio depends also on neighbours volumes.
+		long countEval = 0;
+		m_cellEval.assign(nCellRaw, 0);
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for reduction(+:countEval)
+#endif
+		for(long i=0; i<nCells; ++i){
+			std::size_t raw = m_cellRaws[i];
+			const bitpit::Cell & cell = cells.rawAt(raw);
+			char eval = dirty[raw];
+			int nneigh = cell.getAdjacencyCount();
+			const long * neighs = cell.getAdjacencies();
+			for(int j=0; j<nneigh && !eval; ++j){
+				if(neighs[j] > -1)  eval = dirty[cells.getRawIndex(neighs[j])];
+			}
+			m_cellEval[raw] = eval;
+			countEval += long(eval);
 		}
-		m_minVolumeChange = std::min(m_minVolumeChange, ratio);
 
-        if (ratio < m_minVolumeChangeTol){
-			mvolchangecells.push_back(id);
+		m_interfaceEval.assign(nInterfaceRaw, 0);
+		if(volumeMesh){
+			bitpit::PiercedVector<bitpit::Interface> & interfaces = geo->getInterfaces();
+			long nInterfaces = long(m_interfaceRaws.size());
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+			for(long i=0; i<nInterfaces; ++i){
+				std::size_t raw = m_interfaceRaws[i];
+				const bitpit::Interface & interface = interfaces.rawAt(raw);
+				char eval = dirty[cells.getRawIndex(interface.getOwner())];
+				if(!eval && !interface.isBorder()){
+					eval = dirty[cells.getRawIndex(interface.getNeigh())];
+				}
+				m_interfaceEval[raw] = eval;
+			}
 		}
+		(*m_log)<<m_name<<" : incremental check on "<<countEval<<" cells"<<std::endl;
 	}
 
-    bool passed = ( mvolcells.empty() && mvolchangecells.empty() );
-	if (!passed){
-
-        bitpit::PiercedVector<bitpit::Vertex> &vertices = getGeometry()->getVertices();
-        bitpit::PiercedVector<bitpit::Cell> &cells    = getGeometry()->getCells();
-        bitpit::PiercedVector<bitpit::Vertex> &localVolumeVerts = m_volume->getVertices();
-        bitpit::PiercedVector<bitpit::Vertex> &localVolumeChangeVerts = m_volumechange->getVertices();
-
-        for(long idCell : mvolcells){
-            bitpit::Cell & cell = cells.at(idCell);
-            bitpit::ConstProxyVector<long> connIds = cell.getVertexIds();
-
-            for(long idV : connIds){
-                if(!localVolumeVerts.exists(idV)){
-                    m_volume->addVertex(vertices.at(idV), idV);
-                }
-            }
-            m_volume->addCell(cell, idCell);
-        }
-
-        for(long idCell : mvolchangecells){
-            bitpit::Cell & cell = cells.at(idCell);
-            bitpit::ConstProxyVector<long> connIds = cell.getVertexIds();
-
-            for(long idV : connIds){
-                if(!localVolumeChangeVerts.exists(idV)){
-                    m_volumechange->addVertex(vertices.at(idV), idV);
-                }
-            }
-            m_volumechange->addCell(cell, idCell);
-        }
+	long nCells = long(m_cellRaws.size());
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+	for(long i=0; i<nCells; ++i){
+		std::size_t raw = m_cellRaws[i];
+		if(!dirty[raw]) continue;
+		long id = cells.rawAt(raw).getId();
+		m_cellCentroids[raw] = geo->evalCellCentroid(id);
+		m_cellVolumes[raw] = geo->evalCellVolume(id);
 	}
 
-#if MIMMO_ENABLE_MPI
-    MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_CXX_BOOL, MPI_LAND, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_minVolumeChange, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_maxVolume, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_minVolume, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
-
+	if(volumeMesh){
+		bitpit::PiercedVector<bitpit::Interface> & interfaces = geo->getInterfaces();
+		bitpit::VolUnstructured * patch = static_cast<bitpit::VolUnstructured*>(geo->getPatch());
+		long nInterfaces = long(m_interfaceRaws.size());
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
 #endif
+		for(long i=0; i<nInterfaces; ++i){
+			std::size_t raw = m_interfaceRaws[i];
+			if(!m_interfaceEval[raw]) continue;
+			long id = interfaces.rawAt(raw).getId();
+			m_interfaceCentroids[raw] = patch->evalInterfaceCentroid(id);
+			m_interfaceNormals[raw] = patch->evalInterfaceNormal(id);
+			m_interfaceAreas[raw] = patch->evalInterfaceArea(id);
+		}
+	}
 
-	return passed;
+	m_cacheSync = true;
 }
 
-/*! It check the quality of the skewness of the cells of the mesh
- * \return false if skewness or boundary skewness tolerance is not satisfied
+/*!
+ * Store a sick element in a list and update the count of sick elements, in a thread-safe way.
+ * \param[in,out] list list of sick elements
+ * \param[in] id label of the sick element
+ * \return true if the failure threshold is reached
  */
 bool
-MeshChecker::checkSkewness()
+MeshChecker::registerSickElement(livector1D & list, long id)
 {
-	if (getGeometry()->getType() != 2){
-		(*m_log)<<m_name<<" : skewness check active only for volume mesh -> check disabled" << std::endl;
-		return true;
+	bool reached = false;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp critical (meshCheckerSick)
+#endif
+	{
+		list.push_back(id);
+		++m_sickCount;
+		reached = (m_failureThreshold > 0 && m_sickCount >= m_failureThreshold);
 	}
+	return reached;
+}
 
-	if (!getGeometry()->areInterfacesBuilt()){
-		getGeometry()->buildInterfaces();
+/*! It check the quality of the cells of the mesh, evaluating volume, volume change ratio
+ * and face validity (volume meshes only) in a single sweep on cells, concurrently if OpenMP is enabled.
+ * Indicators are evaluated only for cells marked in m_cellEval, the cached ones are used for the others.
+ * \return false if one of the volume, volume change or face validity tolerances is not satisfied
+ */
+bool
+MeshChecker::checkCells()
+{
+	MimmoObject * geo = getGeometry();
+	bool volumeMesh = (geo->getType() == 2);
+	if(!volumeMesh){
+		(*m_log)<<m_name<<" : face validity check active only for volume mesh -> check disabled" << std::endl;
 	}
 
-    livector1D listInterfaces;
-    livector1D listBoundInterfaces;
-	for (bitpit::Interface & interface : getGeometry()->getInterfaces()){
-		if (!interface.isBorder()){
-			std::array<double,3> centroidsVector = getGeometry()->evalCellCentroid(interface.getNeigh()) - getGeometry()->evalCellCentroid(interface.getOwner());
-			std::array<double,3> normal = static_cast<bitpit::VolUnstructured*>(getGeometry()->getPatch())->evalInterfaceNormal(interface.getId());
-			double angle = std::acos(dotProduct(centroidsVector,normal) / (norm2(centroidsVector)*norm2(normal)));
-			m_maxSkewness = std::max(m_maxSkewness, angle);
-			if (angle > m_maxSkewnessTol){
-                listInterfaces.push_back(interface.getId());
+	bitpit::PiercedVector<bitpit::Cell> & cells = geo->getCells();
+	bitpit::PiercedVector<bitpit::Interface> & interfaces = geo->getInterfaces();
+
+	livector1D mvolcells;
+	livector1D mvolchangecells;
+	livector1D listSickCell;
+
+	double minVolume = m_minVolume;
+	double maxVolume = m_maxVolume;
+	double minVolumeChange = m_minVolumeChange;
+	double minFaceValidity = m_minFaceValidity;
+	int stop = int(m_interrupted);
+	long nCells = long(m_cellRaws.size());
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256) reduction(min:minVolume,minVolumeChange,minFaceValidity) reduction(max:maxVolume)
+#endif
+	for(long i=0; i<nCells; ++i){
+		int stopped;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic read
+#endif
+		stopped = stop;
+		if(stopped) continue;
+
+		std::size_t raw = m_cellRaws[i];
+		const bitpit::Cell & cell = cells.rawAt(raw);
+		if(!cell.isInterior()) continue;
+		long id = cell.getId();
+		double vol = m_cellVolumes[raw];
+
+		if(m_cellEval[raw]){
+			double ratio = 1.;
+			int nneigh = cell.getAdjacencyCount();
+			const long * neighs = cell.getAdjacencies();
+			for(int j=0; j<nneigh; ++j){
+				if(neighs[j] > -1)
+					ratio = std::min(ratio, vol/m_cellVolumes[cells.getRawIndex(neighs[j])]);
 			}
-		}else{
-			std::array<double,3> centroidsVector = getGeometry()->evalInterfaceCentroid(interface.getId()) -getGeometry()->evalCellCentroid(interface.getOwner());
-			std::array<double,3> normal = static_cast<bitpit::VolUnstructured*>(getGeometry()->getPatch())->evalInterfaceNormal(interface.getId());
-			double angle = std::acos(dotProduct(centroidsVector,normal) / (norm2(centroidsVector)*norm2(normal)));
-			m_maxSkewnessBoundary = std::max(m_maxSkewnessBoundary, angle);
-			if (angle > m_maxSkewnessBoundaryTol){
-                listBoundInterfaces.push_back(interface.getId());
+			m_cellVolumeChange[raw] = ratio;
+
+			if(volumeMesh){
+				double areaGood = 0.0;
+				double sumArea = 0.0;
+				int ninterf = cell.getInterfaceCount();
+				const long * interfs = cell.getInterfaces();
+				for(int j=0; j<ninterf; ++j){
+					if(interfs[j] < 0) continue;
+					std::size_t iraw = interfaces.getRawIndex(interfs[j]);
+					std::array<double,3> normal = m_interfaceNormals[iraw];
+					if(interfaces.rawAt(iraw).getOwner() != id){
+						normal = -1.*normal;
+					}
+					double area = m_interfaceAreas[iraw];
+					if(dotProduct((m_interfaceCentroids[iraw] - m_cellCentroids[raw]), normal) > 0.0){
+						areaGood += area;
+					}
+					sumArea += area;
+				}
+				m_cellFaceValidity[raw] = areaGood / sumArea;
+			}
+		}
+
+		bool reached = false;
+		minVolume = std::min(minVolume, vol);
+		maxVolume = std::max(maxVolume, vol);
+		if(vol < m_minVolumeTol || vol > m_maxVolumeTol){
+			reached = registerSickElement(mvolcells, id) || reached;
+		}
+
+		minVolumeChange = std::min(minVolumeChange, m_cellVolumeChange[raw]);
+		if(m_cellVolumeChange[raw] < m_minVolumeChangeTol){
+			reached = registerSickElement(mvolchangecells, id) || reached;
+		}
+
+		if(volumeMesh){
+			minFaceValidity = std::min(minFaceValidity, m_cellFaceValidity[raw]);
+			if(m_cellFaceValidity[raw] < m_minFaceValidityTol){
+				reached = registerSickElement(listSickCell, id) || reached;
 			}
 		}
+
+		if(reached){
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic write
+#endif
+			stop = 1;
+		}
 	}
 
-    bool passed = ( listInterfaces.empty() && listBoundInterfaces.empty() );
-
-    if (!passed){
-
-        bitpit::PiercedVector<bitpit::Interface> & interfaces = getGeometry()->getInterfaces();
-        bitpit::PiercedVector<bitpit::Cell> & cells = getGeometry()->getCells();
-        bitpit::PiercedVector<bitpit::Vertex> & vertices = getGeometry()->getVertices();
-
-        bitpit::PiercedVector<bitpit::Vertex> & skewVerts = m_skewness->getVertices();
-        bitpit::PiercedVector<bitpit::Cell> & skewCells = m_skewness->getCells();
-
-        for( long idI : listInterfaces){
-                long idOwner = interfaces.at(idI).getOwner();
-                long idNeigh = interfaces.at(idI).getNeigh();
-                bitpit::Cell & cellOwner = cells.at(idOwner);
-                bitpit::Cell & cellNeigh = cells.at(idNeigh);
-
-                //push the cell if it is not ghost and if it's not already inside m_skewness
-                if(cellOwner.isInterior() && !skewCells.exists(idOwner)){
-                    bitpit::ConstProxyVector<long> vIds = cellOwner.getVertexIds();
-                    for(long idV: vIds){
-                        if(!skewVerts.exists(idV)){
-                            m_skewness->addVertex(vertices.at(idV), idV);
-                        }
-                    }
-                    m_skewness->addCell(cellOwner, idOwner);
-                }
-
-                //push the cell if it is not ghost and if it's not already inside m_skewness
-                if(cellNeigh.isInterior() && !skewCells.exists(idNeigh)){
-                    bitpit::ConstProxyVector<long> vIds = cellNeigh.getVertexIds();
-                    for(long idV: vIds){
-                        if(!skewVerts.exists(idV)){
-                            m_skewness->addVertex(vertices.at(idV), idV);
-                        }
-                    }
-                    m_skewness->addCell(cellNeigh, idNeigh);
-                }
-        }
-	} // end of if passed.
+	m_minVolume = minVolume;
+	m_maxVolume = maxVolume;
+	m_minVolumeChange = minVolumeChange;
+	m_minFaceValidity = minFaceValidity;
+	m_interrupted = bool(stop);
+
+	bool passed = ( mvolcells.empty() && mvolchangecells.empty() && listSickCell.empty() );
+	if (!passed){
+		std::sort(mvolcells.begin(), mvolcells.end());
+		std::sort(mvolchangecells.begin(), mvolchangecells.end());
+		std::sort(listSickCell.begin(), listSickCell.end());
+		fillSickGeometry(m_volume.get(), mvolcells, false);
+		fillSickGeometry(m_volumechange.get(), mvolchangecells, false);
+		fillSickGeometry(m_facevalidity.get(), listSickCell, false);
+	}
 
 #if MIMMO_ENABLE_MPI
     MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_CXX_BOOL, MPI_LAND, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_maxSkewness, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_maxSkewnessBoundary, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_minVolumeChange, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_maxVolume, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_minVolume, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_minFaceValidity, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
 #endif
 
 	return passed;
 }
 
-/*! It check the face validity of the cells of the mesh
- * \return false if face validity tolerance is not satisfied
+/*! It check the quality of the skewness of the cells of the mesh, in a single sweep on interfaces,
+ * concurrently if OpenMP is enabled. Skewness is evaluated only for interfaces marked in m_interfaceEval,
+ * the cached one is used for the others.
+ * \return false if skewness or boundary skewness tolerance is not satisfied
  */
 bool
-MeshChecker::checkFaceValidity()
+MeshChecker::checkSkewness()
 {
-
 	if (getGeometry()->getType() != 2){
-		(*m_log)<<m_name<<" : face validity check active only for volume mesh -> check disabled" << std::endl;
+		(*m_log)<<m_name<<" : skewness check active only for volume mesh -> check disabled" << std::endl;
 		return true;
 	}
 
+	bitpit::PiercedVector<bitpit::Cell> & cells = getGeometry()->getCells();
+	bitpit::PiercedVector<bitpit::Interface> & interfaces = getGeometry()->getInterfaces();
 
-	if (!getGeometry()->areInterfacesBuilt()){
-		getGeometry()->buildInterfaces();
-	}
+	livector1D listInterfaces;
+	livector1D listBoundInterfaces;
 
-	//Prepare two structure areaGood and sumArea
-	std::unordered_map<long, double> sumArea;
-	std::unordered_map<long, double> areaGood;
-	for (bitpit::Cell & cell : getGeometry()->getCells()){
-		sumArea[cell.getId()] =  0.0;
-		areaGood[cell.getId()] =  0.0;
-	}
-	for (bitpit::Interface & interface : getGeometry()->getInterfaces()){
-		int n=1;
-		if (!interface.isBorder())
-			n=2;
-		for (int i=0; i<n; i++){
-			long idcell = interface.getOwnerNeigh()[i];
-			long idinter = interface.getId();
-			std::array<double,3> centroid = getGeometry()->getPatch()->evalCellCentroid(idcell);
-			std::array<double,3> centerinterface = getGeometry()->getPatch()->evalInterfaceCentroid(idinter);
-			std::array<double,3> normal = static_cast<bitpit::VolUnstructured*>(getGeometry()->getPatch())->evalInterfaceNormal(idinter);
-			if (i==1){
-				normal = -1.*normal;
+	double maxSkewness = m_maxSkewness;
+	double maxSkewnessBoundary = m_maxSkewnessBoundary;
+	int stop = int(m_interrupted);
+	long nInterfaces = long(m_interfaceRaws.size());
+
+#if MIMMO_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256) reduction(max:maxSkewness,maxSkewnessBoundary)
+#endif
+	for(long i=0; i<nInterfaces; ++i){
+		int stopped;
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic read
+#endif
+		stopped = stop;
+		if(stopped) continue;
+
+		std::size_t raw = m_interfaceRaws[i];
+		const bitpit::Interface & interface = interfaces.rawAt(raw);
+		bool border = interface.isBorder();
+
+		if(m_interfaceEval[raw]){
+			std::array<double,3> ownerCentroid = m_cellCentroids[cells.getRawIndex(interface.getOwner())];
+			std::array<double,3> centroidsVector;
+			if(!border){
+				centroidsVector = m_cellCentroids[cells.getRawIndex(interface.getNeigh())] - ownerCentroid;
+			}else{
+				centroidsVector = m_interfaceCentroids[raw] - ownerCentroid;
+			}
+			const std::array<double,3> & normal = m_interfaceNormals[raw];
+			m_interfaceSkewness[raw] = std::acos(dotProduct(centroidsVector,normal) / (norm2(centroidsVector)*norm2(normal)));
+		}
+
+		double angle = m_interfaceSkewness[raw];
+		bool reached = false;
+		if(!border){
+			maxSkewness = std::max(maxSkewness, angle);
+			if (angle > m_maxSkewnessTol){
+				reached = registerSickElement(listInterfaces, interface.getId());
 			}
-			double product = dotProduct((centerinterface-centroid),normal);
-			double area = static_cast<bitpit::VolUnstructured*>(getGeometry()->getPatch())->evalInterfaceArea(idinter);
-			if (product > 0.0){
-				areaGood[idcell] = areaGood[idcell] + area;
+		}else{
+			maxSkewnessBoundary = std::max(maxSkewnessBoundary, angle);
+			if (angle > m_maxSkewnessBoundaryTol){
+				reached = registerSickElement(listBoundInterfaces, interface.getId());
 			}
-			sumArea[idcell] = sumArea[idcell] + area;
+		}
+
+		if(reached){
+#if MIMMO_ENABLE_OPENMP
+#pragma omp atomic write
+#endif
+			stop = 1;
 		}
 	}
 
-    // save the sick elements in a list.
-    livector1D listSickCell;
+	m_maxSkewness = maxSkewness;
+	m_maxSkewnessBoundary = maxSkewnessBoundary;
+	m_interrupted = bool(stop);
 
-	for (auto it = getGeometry()->getPatch()->internalBegin(); it!=getGeometry()->getPatch()->internalEnd(); ++it){
-        long idcell = it.getId();
-		double area = areaGood[idcell] / sumArea[idcell];
-		m_minFaceValidity = std::min(m_minFaceValidity, area);
-		if (area < m_minFaceValidityTol){
-			listSickCell.push_back(idcell);
+	bool passed = ( listInterfaces.empty() && listBoundInterfaces.empty() );
+
+	if (!passed){
+		std::sort(listInterfaces.begin(), listInterfaces.end());
+		livector1D listCells;
+		listCells.reserve(2*listInterfaces.size());
+		for(long idI : listInterfaces){
+			listCells.push_back(interfaces.at(idI).getOwner());
+			listCells.push_back(interfaces.at(idI).getNeigh());
 		}
-	}
-    //create the boolean
-    bool passed = listSickCell.empty();
-
-    // fill the structure.
-    if (!passed){
-        bitpit::PiercedVector<bitpit::Vertex> & vertices = getGeometry()->getVertices();
-        bitpit::PiercedVector<bitpit::Cell> & cells = getGeometry()->getCells();
-
-        bitpit::PiercedVector<bitpit::Vertex> & fvalVerts = m_facevalidity->getVertices();
-
-        for(long idCell : listSickCell){
-            bitpit::Cell & cell = cells.at(idCell);
-            bitpit::ConstProxyVector<long> connIds = cell.getVertexIds();
-
-            for(long idV : connIds){
-                if(!fvalVerts.exists(idV)){
-                    m_facevalidity->addVertex(vertices.at(idV), idV);
-                }
-            }
-            m_facevalidity->addCell(cell, idCell);
-        }
+		//push only not ghost cells
+		fillSickGeometry(m_skewness.get(), listCells, true);
 	}
 
 #if MIMMO_ENABLE_MPI
     MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_CXX_BOOL, MPI_LAND, m_communicator);
-    MPI_Allreduce(MPI_IN_PLACE, &m_minFaceValidity, 1, MPI_DOUBLE, MPI_MIN, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_maxSkewness, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
+    MPI_Allreduce(MPI_IN_PLACE, &m_maxSkewnessBoundary, 1, MPI_DOUBLE, MPI_MAX, m_communicator);
 #endif
 
 	return passed;
 }
 
-
 /*!
- * Initialize cells volumes
+ * Copy a list of sick cells of the linked geometry, with their vertices, into a sick elements geometry.
+ * Cells already inside the sick geometry are skipped.
+ * \param[in] sick geometry collecting sick elements
+ * \param[in] cellList labels of the sick cells
+ * \param[in] interiorOnly if true, ghost cells are skipped
  */
 void
-MeshChecker::initializeVolumes()
+MeshChecker::fillSickGeometry(MimmoObject * sick, const livector1D & cellList, bool interiorOnly)
 {
-	m_volumes.initialize(getGeometry(), MPVLocation::CELL, 0.);
-	for (bitpit::Cell & cell : getGeometry()->getCells()){
-		long id = cell.getId();
-		m_volumes[id] = getGeometry()->evalCellVolume(id);
+	bitpit::PiercedVector<bitpit::Vertex> & vertices = getGeometry()->getVertices();
+	bitpit::PiercedVector<bitpit::Cell> & cells = getGeometry()->getCells();
+	bitpit::PiercedVector<bitpit::Vertex> & sickVerts = sick->getVertices();
+	bitpit::PiercedVector<bitpit::Cell> & sickCells = sick->getCells();
+
+	for(long idCell : cellList){
+		bitpit::Cell & cell = cells.at(idCell);
+		if((interiorOnly && !cell.isInterior()) || sickCells.exists(idCell)) continue;
+
+		bitpit::ConstProxyVector<long> connIds = cell.getVertexIds();
+		for(long idV : connIds){
+			if(!sickVerts.exists(idV)){
+				sick->addVertex(vertices.at(idV), idV);
+			}
+		}
+		sick->addCell(cell, idCell);
 	}
 }
 
-/*! Clear auxiliary variables
+/*! Clear auxiliary variables and cached quantities
  *
  */
 void
 MeshChecker::clear(){
-	m_volumes.clear();
+	m_cacheSync = false;
+	m_cellRaws.clear();
+	m_interfaceRaws.clear();
+	m_cellEval.clear();
+	m_interfaceEval.clear();
+	m_cellCentroids.clear();
+	m_cellVolumes.clear();
+	m_cellVolumeChange.clear();
+	m_cellFaceValidity.clear();
+	m_interfaceCentroids.clear();
+	m_interfaceNormals.clear();
+	m_interfaceAreas.clear();
+	m_interfaceSkewness.clear();
 }
 
 /*!
@@ -774,6 +1047,26 @@ MeshChecker::absorbSectionXML(const bitpit::Config::Section & slotXML, std::stri
        }
        setMinimumVolumeChangeTolerance(val);
    }
+   if(slotXML.hasOption("FailureThreshold")){
+       std::string input = slotXML.get("FailureThreshold");
+       input = bitpit::utils::string::trim(input);
+       long val = 0;
+       if(!input.empty()){
+           std::stringstream ss(input);
+           ss>>val;
+       }
+       setFailureThreshold(val);
+   }
+   if(slotXML.hasOption("Incremental")){
+       std::string input = slotXML.get("Incremental");
+       input = bitpit::utils::string::trim(input);
+       bool val = false;
+       if(!input.empty()){
+           std::stringstream ss(input);
+           ss>>val;
+       }
+       setIncremental(val);
+   }
    if(slotXML.hasOption("ResumeFile")){
        std::string input = slotXML.get("ResumeFile");
        input = bitpit::utils::string::trim(input);
@@ -833,6 +1126,8 @@ MeshChecker::flushSectionXML(bitpit::Config::Section & slotXML, std::string name
         slotXML.set("MinVolChangeTOL", ss.str());
     }
 
+    slotXML.set("FailureThreshold", std::to_string(m_failureThreshold));
+    slotXML.set("Incremental", std::to_string(int(m_incremental)));
     slotXML.set("ResumeFile", std::to_string(int(m_printResumeFile)));
 };
 
@@ -19,6 +19,14 @@ namespace mimmo{
  *
  * It writes a resume of the quality mesh check directly on the mimmo::Logger.
  * Optional results writes sick elements on file vtu.
+ *
+ * Cell centroids and volumes, interface centroids, normals and areas are evaluated once
+ * and cached in dense arrays; all the cell indicators are then computed in a single sweep on cells,
+ * and skewness in a single sweep on interfaces (both threaded if OpenMP is enabled).
+ * The check can be stopped as soon as a given number of sick elements is found (see setFailureThreshold).
+ * In incremental mode (see setIncremental), the cache survives between executions and,
+ * given the deformation field applied to the geometry since the last check, only the cells touched
+ * by a nonzero displacement (and their neighbours) are checked again.
 
  * \n
  *
@@ -30,6 +38,7 @@ namespace mimmo{
    |------------------|---------------------|----------------------|
    | <B>PortType</B>   | <B>variable/function</B>  |<B>DataType</B> |
    | M_GEOM           | setGeometry         | (MC_SCALAR, MD_MIMMO_)     |
+   | M_GDISPLS        | setDeformation      | (MC_SCALAR, MD_MPVECARR3FLOAT_)     |
 
 
    |               Port Output    ||                                         |
@@ -56,6 +65,8 @@ namespace mimmo{
  * - <B>MinFaceValidityTOL</B>: tolerance for maximum skewness on boundary allowable.
  * - <B>MinVolChangeTOL</B>: tolerance for maximum skewness on boundary allowable.
  * - <B>ResumeFile</B>: boolean 1-print Resume on file, 0-do nothing.
+ * - <B>FailureThreshold</B>: number of sick elements stopping the check, 0-never stop (default).
+ * - <B>Incremental</B>: boolean 1-check again only cells touched by the deformation field, 0-full check (default).
 
  * Geometry has to be mandatorily passed by port.
  *
@@ -95,6 +106,9 @@ public:
 	void setMinimumFaceValidityTolerance(double tol);
 	void setMinimumVolumeChangeTolerance(double tol);
     void setPrintResumeFile(bool flag);
+    void setFailureThreshold(long nsick);
+    void setIncremental(bool flag);
+    void setDeformation(dmpvecarr3E * field);
 
     bool isGood();
     CMeshOutput getQualityStatus();
@@ -112,10 +126,12 @@ protected:
     void swap(MeshChecker & x) noexcept;
 	void setDefault();
     CMeshOutput  checkMeshQuality();
-    bool checkVolume();
+    void resetIndicators();
+    void updateGeometricCache();
+    bool checkCells();
 	bool checkSkewness();
-	bool checkFaceValidity();
-	void initializeVolumes();
+	void fillSickGeometry(MimmoObject * sick, const livector1D & cellList, bool interiorOnly);
+	bool registerSickElement(livector1D & list, long id);
 	void clear();
     void printResumeFile();
 
@@ -143,8 +159,26 @@ protected:
                                     1, minimum face validity too low; 2, volume change error; 3, skewness on boundary error; 4, skewness error;
                                     5, minimum volume error; 6, max volume error.*/
 
-	//Temporary aux variables
-	MimmoPiercedVector<double>	m_volumes; /**<Cell volumes.*/
+	long            m_failureThreshold; /**< number of sick elements stopping the check, 0 never stops*/
+	bool            m_incremental;      /**< true, check again only cells touched by the deformation field*/
+	dmpvecarr3E     m_deformation;      /**< deformation field applied to geometry since the last check*/
+	long            m_sickCount;        /**< number of sick elements found in the current check*/
+	bool            m_interrupted;      /**< true if the current check is stopped by the failure threshold*/
+
+	//Cached geometric quantities and indicators, referred to raw indices of geometry cells/interfaces
+	bool            m_cacheSync;            /**< true if cached quantities are synchronized with the geometry*/
+	std::vector<std::size_t>    m_cellRaws;        /**< raw indices of geometry cells*/
+	std::vector<std::size_t>    m_interfaceRaws;   /**< raw indices of geometry interfaces*/
+	std::vector<char>           m_cellEval;        /**< cells whose indicators have to be evaluated, per raw index*/
+	std::vector<char>           m_interfaceEval;   /**< interfaces whose indicators have to be evaluated, per raw index*/
+	dvecarr3E       m_cellCentroids;        /**< cell centroids*/
+	dvector1D       m_cellVolumes;          /**< cell volumes*/
+	dvector1D       m_cellVolumeChange;     /**< cell volume change ratio*/
+	dvector1D       m_cellFaceValidity;     /**< cell face validity*/
+	dvecarr3E       m_interfaceCentroids;   /**< interface centroids*/
+	dvecarr3E       m_interfaceNormals;     /**< interface normals*/
+	dvector1D       m_interfaceAreas;       /**< interface areas*/
+	dvector1D       m_interfaceSkewness;    /**< interface skewness angle*/
 
 	std::unique_ptr<MimmoObject>	m_volume; /**<Cells with poor volume.*/
 	std::unique_ptr<MimmoObject>	m_skewness; /**<Cells with poor skewness.*/
@@ -156,6 +190,7 @@ protected:
 };
 
 REGISTER_PORT(M_GEOM, MC_SCALAR, MD_MIMMO_,__MESH_CHECKER_HPP__)
+REGISTER_PORT(M_GDISPLS, MC_SCALAR, MD_MPVECARR3FLOAT_,__MESH_CHECKER_HPP__)
 REGISTER_PORT(M_VALUEB, MC_SCALAR, MD_BOOL,__MESH_CHECKER_HPP__)
 REGISTER_PORT(M_VALUEI, MC_SCALAR, MD_INT,__MESH_CHECKER_HPP__)
 
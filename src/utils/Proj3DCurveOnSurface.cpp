@@ -307,12 +307,8 @@ Proj3DCurveOnSurface::projection(){
 
     //...and projecting them onto target surface
     if(!getGeometry()->isSkdTreeSync())    getGeometry()->buildSkdTree();
-    int counter=0;
     dvecarr3E projs(points.size());
-    for(auto &val : points){
-        projs[counter]= skdTreeUtils::projectPoint(&val, getGeometry()->getSkdTree());
-        ++counter;
-    }
+    skdTreeUtils::projectPoint(int(points.size()), points.data(), getGeometry()->getSkdTree(), projs.data());
 
     dum->getPatch()->reserveVertices(points.size());
     dum->getPatch()->reserveCells(connectivity.size());
@@ -273,12 +273,8 @@ ProjSegmentOnSurface::projection(){
 
     //...and projecting them onto target surface
     if(!getGeometry()->isSkdTreeSync())    getGeometry()->buildSkdTree();
-    counter = 0;
     projs.resize(verts.size());
-    for(auto &val : verts){
-        projs[counter]= skdTreeUtils::projectPoint(&val, getGeometry()->getSkdTree());
-        ++counter;
-    }
+    skdTreeUtils::projectPoint(int(verts.size()), verts.data(), getGeometry()->getSkdTree(), projs.data());
 
     //storing the projected points in the MImmoObject:
     long idS = 0;
@@ -242,12 +242,8 @@ ProjectCloud::execute(){
     if(!getGeometry()->isSkdTreeSync())    getGeometry()->buildSkdTree();
 
     //project points on surface.
-    int counter = 0;
     m_proj.resize(m_points.size(), {{0.0,0.0,0.0}});
-    for(darray3E &val : m_points){
-        m_proj[counter]= skdTreeUtils::projectPoint(&val, getGeometry()->getSkdTree());
-        ++counter;
-    }
+    skdTreeUtils::projectPoint(int(m_points.size()), m_points.data(), getGeometry()->getSkdTree(), m_proj.data());
     return;
 };
 
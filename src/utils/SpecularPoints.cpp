@@ -414,11 +414,8 @@ SpecularPoints::execute(){
         if(!getGeometry()->isSkdTreeSync())    getGeometry()->buildSkdTree();
 
         //project points on surface.
-        int counter = 0;
-        for(auto &val : m_proj){
-            m_proj[counter]= skdTreeUtils::projectPoint(&val, getGeometry()->getSkdTree());
-            ++counter;
-        }
+        dvecarr3E mirrored(m_proj);
+        skdTreeUtils::projectPoint(int(mirrored.size()), mirrored.data(), getGeometry()->getSkdTree(), m_proj.data());
     }
 };
 
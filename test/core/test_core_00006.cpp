@@ -0,0 +1,183 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+#include <algorithm>
+#include <random>
+
+/*
+ * Test 00006
+ * Testing the balanced vertex kdTree and the batched kdTreeUtils::kNearest and
+ * kdTreeUtils::radiusSearch queries against a brute force search, on a random
+ * point cloud and on a structured grid (coordinate ties on every splitting direction).
+ */
+
+// =================================================================================== //
+
+/*
+ * Build the kdTree of a point cloud, check its ordering and depth, and check the
+ * batched queries on random points against a brute force search.
+ */
+int checkTree(mimmo::MimmoObject * cloud, int maxDepth, double r, std::mt19937 & gen) {
+
+    cloud->buildKdTree();
+    bitpit::KdTree<3, bitpit::Vertex, long> * tree = cloud->getKdTree();
+
+    if(!mimmo::kdTreeUtils::checkOrdering(tree)){
+        std::cout<<"Balanced vertex kdTree is not correctly ordered"<<std::endl;
+        return 1;
+    }
+
+    //depth of the tree
+    int depth = 0;
+    std::vector<std::pair<int,int>> stack(1, std::make_pair(0, 1));
+    while(!stack.empty()){
+        std::pair<int,int> entry = stack.back();
+        stack.pop_back();
+        depth = std::max(depth, entry.second);
+        if(tree->nodes[entry.first].lchild_ >= 0) stack.push_back(std::make_pair(tree->nodes[entry.first].lchild_, entry.second+1));
+        if(tree->nodes[entry.first].rchild_ >= 0) stack.push_back(std::make_pair(tree->nodes[entry.first].rchild_, entry.second+1));
+    }
+    if(depth > maxDepth){
+        std::cout<<"Balanced vertex kdTree is too deep: "<<depth<<" levels, expected at most "<<maxDepth<<std::endl;
+        return 1;
+    }
+
+    std::uniform_real_distribution<double> coord(-1.2, 1.2);
+    int nP = 200;
+    std::vector<std::array<double,3>> points(nP);
+    for(auto & point : points){
+        point = {{coord(gen), coord(gen), coord(gen)}};
+    }
+
+    //brute force distances of each point from all the vertices
+    std::vector<std::vector<std::pair<double,long>>> brute(nP);
+    for(int i=0; i<nP; ++i){
+        brute[i].reserve(cloud->getNVertices());
+        for(const bitpit::Vertex & vertex : cloud->getVertices()){
+            brute[i].push_back(std::make_pair(norm2(points[i] - vertex.getCoords()), vertex.getId()));
+        }
+        std::sort(brute[i].begin(), brute[i].end());
+    }
+
+    //k nearest vertices
+    int k = 8;
+    std::vector<long> labels(nP*k);
+    std::vector<double> distances(nP*k);
+    mimmo::kdTreeUtils::kNearest(nP, points.data(), tree, k, labels.data(), distances.data());
+
+    bool check = true;
+    for(int i=0; i<nP && check; ++i){
+        for(int j=0; j<k && check; ++j){
+            check = std::abs(distances[i*k+j] - brute[i][j].first) < 1.0e-12;
+            check = check && std::abs(norm2(points[i] - cloud->getVertexCoords(labels[i*k+j])) - distances[i*k+j]) < 1.0e-12;
+        }
+    }
+    if(!check){
+        std::cout<<"kdTreeUtils::kNearest differs from brute force search"<<std::endl;
+        return 1;
+    }
+
+    //vertices within a radius
+    livector2D found;
+    mimmo::kdTreeUtils::radiusSearch(nP, points.data(), tree, r, found);
+
+    check = (int(found.size()) == nP);
+    for(int i=0; i<nP && check; ++i){
+        livector1D expected;
+        for(const auto & entry : brute[i]){
+            if(entry.first > r) break;
+            expected.push_back(entry.second);
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(found[i].begin(), found[i].end());
+        check = (found[i] == expected);
+    }
+    if(!check){
+        std::cout<<"kdTreeUtils::radiusSearch differs from brute force search"<<std::endl;
+        return 1;
+    }
+    std::cout<<"kdTree of "<<cloud->getNVertices()<<" vertices with "<<depth<<" levels, queries match brute force search"<<std::endl;
+
+    return 0;
+}
+
+int test6() {
+
+    std::mt19937 gen(17);
+
+    //random point cloud: distinct coordinates, minimum depth.
+    std::uniform_real_distribution<double> coord(-1.0, 1.0);
+    std::unique_ptr<mimmo::MimmoObject> cloud(new mimmo::MimmoObject(3));
+    int nV = 5000;
+    for(int i=0; i<nV; ++i){
+        cloud->addVertex(darray3E({{coord(gen), coord(gen), coord(gen)}}), long(3*i+1));
+    }
+    int minDepth = int(std::ceil(std::log2(double(nV+1))));
+    if(checkTree(cloud.get(), minDepth, 0.15, gen) != 0) return 1;
+
+    //structured grid: ties on every splitting direction, depth close to the minimum.
+    std::unique_ptr<mimmo::MimmoObject> grid(new mimmo::MimmoObject(3));
+    int n = 20;
+    for(int k=0; k<n; ++k){
+        for(int j=0; j<n; ++j){
+            for(int i=0; i<n; ++i){
+                grid->addVertex(darray3E({{-1.0 + 0.1*i, -1.0 + 0.1*j, -1.0 + 0.1*k}}), long(n*n*k + n*j + i));
+            }
+        }
+    }
+    minDepth = int(std::ceil(std::log2(double(n*n*n+1))));
+    if(checkTree(grid.get(), minDepth + 3, 0.15, gen) != 0) return 1;
+
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test6() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00006 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+#include <random>
+
+/*
+ * Test 00007
+ * Testing the batched coordinate transforms and inclusion check of the basic shapes
+ * (Cube, Cylinder, Sphere, Wedge) against the single point ones, on random points around
+ * the shape and on points lying on the periodic/angular seams and on the degenerate axes.
+ */
+
+// =================================================================================== //
+
+/*
+ * Compare batched toLocalCoords/toWorldCoords/arePointsIncluded (the latter going through
+ * localToBasicCoords) with toLocalCoord/toWorldCoord/isPointIncluded on each point.
+ * Seam points are given in local coordinates and mapped to world before testing.
+ */
+int checkShape(mimmo::BasicShape * shape, const std::string & name, const dvecarr3E & localSeams, std::mt19937 & rgen){
+
+    std::uniform_real_distribution<double> unif(-2.5, 2.5);
+    dvecarr3E points(2000);
+    for(auto & point : points){
+        point = {{unif(rgen), unif(rgen), unif(rgen)}};
+    }
+    for(const auto & seam : localSeams){
+        points.push_back(shape->toWorldCoord(seam));
+    }
+
+    dvecarr3E local = shape->toLocalCoords(points);
+    dvecarr3E world = shape->toWorldCoords(local);
+    bvector1D included = shape->arePointsIncluded(points);
+
+    bool check = (local.size() == points.size()) && (world.size() == points.size()) && (included.size() == points.size());
+    double maxLocal = 0.0, maxWorld = 0.0;
+    long nIncluded = 0;
+    for(std::size_t i=0; i<points.size() && check; ++i){
+        darray3E singleLocal = shape->toLocalCoord(points[i]);
+        maxLocal = std::max(maxLocal, norm2(local[i] - singleLocal));
+        maxWorld = std::max(maxWorld, norm2(world[i] - shape->toWorldCoord(local[i])));
+        check = (included[i] == shape->isPointIncluded(points[i]));
+        nIncluded += long(included[i]);
+    }
+    check = check && (maxLocal <= 1.0e-12) && (maxWorld <= 1.0e-12);
+
+    std::cout<<name<<" batched transforms differ by "<<maxLocal<<" (local) "<<maxWorld<<" (world), "
+             <<nIncluded<<" of "<<points.size()<<" points included, matching single point check: "<<check<<std::endl;
+    return int(!check);
+}
+
+int test7() {
+
+    std::mt19937 rgen(7);
+    darray3E axis0 = {{std::cos(0.3), std::sin(0.3), 0.0}};
+    darray3E axis1 = {{-std::sin(0.3), std::cos(0.3), 0.0}};
+    darray3E axis2 = {{0.0, 0.0, 1.0}};
+
+    int err = 0;
+    {
+        mimmo::Cube shape({{0.1, -0.2, 0.3}}, {{2.0, 1.5, 1.0}});
+        shape.setRefSystem(axis0, axis1, axis2);
+        dvecarr3E seams = {{{0.0, 0.0, 0.0}}, {{0.5, 0.5, 0.5}}, {{-0.5, 0.5, -0.5}}, {{0.5, -0.5, 0.0}}};
+        err += checkShape(&shape, "Cube", seams, rgen);
+    }
+    {
+        //partial cylinder, with the angular seam crossing the positive local x axis.
+        mimmo::Cylinder shape({{0.1, -0.2, 0.3}}, {{1.5, 1.5*M_PI, 2.0}});
+        shape.setRefSystem(axis0, axis1, axis2);
+        shape.setInfLimits(1.5*M_PI, 1);
+        dvecarr3E seams = {{{0.5, 0.0, 0.2}}, {{0.5, 1.5*M_PI, 0.2}}, {{1.0, 0.5*M_PI, -0.5}},
+                           {{0.0, 0.7, 0.0}}, {{0.6, 0.5*M_PI, 0.1}}, {{1.0, 1.5*M_PI, 0.5}}};
+        err += checkShape(&shape, "Cylinder", seams, rgen);
+    }
+    {
+        //full sphere: longitude seam and poles.
+        mimmo::Sphere shape({{0.1, -0.2, 0.3}}, {{2.0, 2.0*M_PI, M_PI}});
+        shape.setRefSystem(axis0, axis1, axis2);
+        dvecarr3E seams = {{{0.5, 0.0, 0.5*M_PI}}, {{0.5, 2.0*M_PI, 0.5*M_PI}}, {{0.5, 1.0, 0.0}}, {{0.5, 1.0, M_PI}},
+                           {{0.0, 0.0, 0.0}}, {{1.0, M_PI, 0.5*M_PI}}, {{1.0, 0.0, 0.25*M_PI}}};
+        err += checkShape(&shape, "Sphere", seams, rgen);
+    }
+    {
+        mimmo::Wedge shape({{0.1, -0.2, 0.3}}, {{2.0, 1.5, 1.0}});
+        shape.setRefSystem(axis0, axis1, axis2);
+        dvecarr3E seams = {{{0.0, 0.0, 0.0}}, {{1.0, 0.0, 0.0}}, {{0.0, 1.0, 0.0}}, {{0.5, 0.5, 0.5}},
+                           {{0.0, 1.0, -0.5}}, {{1.0, 0.0, 0.5}}};
+        err += checkShape(&shape, "Wedge", seams, rgen);
+    }
+
+    return int(err > 0);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test7() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00007 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
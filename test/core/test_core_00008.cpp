@@ -0,0 +1,184 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+
+/*
+ * Test 00008
+ * Testing port data transfer of vector and MimmoPiercedVector payloads, in direct
+ * (unserialized) and buffered mode, towards multiple receivers served in link order.
+ */
+
+#define M_TESTFIELD "M_TESTFIELD"
+REGISTER_PORT(M_TESTFIELD, MC_SCALAR, MD_MPVECARR3FLOAT, __TEST_CORE_00008__)
+
+// =================================================================================== //
+
+/*
+ * Block sending a list of points and a field of vectors.
+ */
+class Sender: public mimmo::BaseManipulation{
+public:
+    dvecarr3E   m_points;
+    dmpvecarr3E m_field;
+
+    Sender(){};
+    virtual ~Sender(){};
+    dvecarr3E getPoints(){ return m_points; };
+    dmpvecarr3E getField(){ return m_field; };
+    void buildPorts(){
+        bool built = true;
+        built = built && createPortOut<dvecarr3E, Sender>(this, &Sender::getPoints, M_GLOBAL);
+        built = built && createPortOut<dmpvecarr3E, Sender>(this, &Sender::getField, M_TESTFIELD);
+        m_arePortsBuilt = built;
+    };
+    void execute(){};
+};
+
+/*
+ * Block receiving a list of points and a field of vectors. Receivers record the
+ * order in which their points are set.
+ */
+std::vector<int> receivedOrder;
+
+class Receiver: public mimmo::BaseManipulation{
+public:
+    int         m_label;
+    dvecarr3E   m_points;
+    dmpvecarr3E m_field;
+
+    Receiver(int label){ m_label = label; };
+    virtual ~Receiver(){};
+    void setPoints(dvecarr3E points){ m_points = points; receivedOrder.push_back(m_label); };
+    void setField(dmpvecarr3E field){ m_field = field; };
+    void buildPorts(){
+        bool built = true;
+        built = built && createPortIn<dvecarr3E, Receiver>(this, &Receiver::setPoints, M_GLOBAL);
+        built = built && createPortIn<dmpvecarr3E, Receiver>(this, &Receiver::setField, M_TESTFIELD);
+        m_arePortsBuilt = built;
+    };
+    void execute(){};
+};
+
+/*
+ * Check if the data received are equal to the data sent.
+ */
+bool checkReceived(Sender * sender, Receiver * receiver){
+    bool check = (receiver->m_points == sender->m_points);
+    check = check && (receiver->m_field.size() == sender->m_field.size());
+    for(auto it = sender->m_field.begin(); it != sender->m_field.end() && check; ++it){
+        check = receiver->m_field.exists(it.getId()) && (receiver->m_field[it.getId()] == *it);
+    }
+    return check;
+}
+
+int test8() {
+
+    Sender * sender = new Sender();
+    Receiver * receiver1 = new Receiver(1);
+    Receiver * receiver2 = new Receiver(2);
+
+    long n = 10000;
+    sender->m_points.resize(n);
+    for(long i=0; i<n; ++i){
+        sender->m_points[i] = {{double(i), 0.5*double(i), -double(i)}};
+        sender->m_field.insert(2*i+1, {{std::sin(double(i)), std::cos(double(i)), 1.0}});
+    }
+
+    mimmo::pin::addPin(sender, receiver1, M_GLOBAL, M_GLOBAL);
+    mimmo::pin::addPin(sender, receiver1, M_TESTFIELD, M_TESTFIELD);
+    mimmo::pin::addPin(sender, receiver2, M_GLOBAL, M_GLOBAL);
+    mimmo::pin::addPin(sender, receiver2, M_TESTFIELD, M_TESTFIELD);
+
+    mimmo::Chain * c0 = new mimmo::Chain();
+    c0->addObject(sender);
+    c0->addObject(receiver1);
+    c0->addObject(receiver2);
+
+    //direct transfer (default).
+    std::vector<int> linkOrder = {1, 2};
+    receivedOrder.clear();
+    c0->exec(false);
+    bool direct = sender->getPortsOut()[M_GLOBAL]->isDirectTransfer() && sender->getPortsOut()[M_TESTFIELD]->isDirectTransfer();
+    bool check = direct && checkReceived(sender, receiver1) && checkReceived(sender, receiver2) && (receivedOrder == linkOrder);
+    if(!check){
+        std::cout<<"Direct transfer of port data failed"<<std::endl;
+    }else{
+        std::cout<<"Direct transfer of port data succeeded"<<std::endl;
+    }
+
+    //buffered transfer.
+    if(check){
+        receiver1->m_points.clear();
+        receiver1->m_field.clear();
+        receiver2->m_points.clear();
+        receiver2->m_field.clear();
+        sender->getPortsOut()[M_GLOBAL]->setDirectTransfer(false);
+        sender->getPortsOut()[M_TESTFIELD]->setDirectTransfer(false);
+        receivedOrder.clear();
+        c0->exec(false);
+        check = checkReceived(sender, receiver1) && checkReceived(sender, receiver2) && (receivedOrder == linkOrder);
+        if(!check){
+            std::cout<<"Buffered transfer of port data failed"<<std::endl;
+        }else{
+            std::cout<<"Buffered transfer of port data succeeded"<<std::endl;
+        }
+    }
+
+    delete c0;
+    delete sender;
+    delete receiver1;
+    delete receiver2;
+
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test8() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00008 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
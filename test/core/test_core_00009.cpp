@@ -0,0 +1,226 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+
+/*
+ * Test 00009
+ * Testing parallel execution of Chain: results of independent branches and of objects
+ * sharing the same geometry have to match the serial execution, and the geometry has to
+ * log again on its own logger after the execution.
+ */
+
+// =================================================================================== //
+
+/*
+ * Block sending a geometry and a list of values.
+ */
+class Source: public mimmo::BaseManipulation{
+public:
+    dvecarr3E m_values;
+
+    Source(){};
+    virtual ~Source(){};
+    dvecarr3E getValues(){ return m_values; };
+    void buildPorts(){
+        bool built = true;
+        built = built && createPortOut<mimmo::MimmoObject*, Source>(this, &mimmo::BaseManipulation::getGeometry, M_GEOM);
+        built = built && createPortOut<dvecarr3E, Source>(this, &Source::getValues, M_GLOBAL);
+        m_arePortsBuilt = built;
+    };
+    void execute(){};
+};
+
+/*
+ * Block reducing the received values with a weight of its own.
+ */
+class Work: public mimmo::BaseManipulation{
+public:
+    dvecarr3E m_values;
+    double    m_weight;
+    double    m_result;
+
+    Work(double weight):m_weight(weight), m_result(0.0){};
+    virtual ~Work(){};
+    void setValues(dvecarr3E values){ m_values = values; };
+    void buildPorts(){
+        m_arePortsBuilt = createPortIn<dvecarr3E, Work>(this, &Work::setValues, M_GLOBAL);
+    };
+    void execute(){
+        m_result = 0.0;
+        for(const darray3E & val : m_values){
+            m_result += std::sin(m_weight*val[0]) + std::cos(m_weight*val[1]) + val[2];
+        }
+    };
+};
+
+/*
+ * Block modifying the vertices of the received geometry, with a translation along x if
+ * translate is true, or with a scaling of factor 2 otherwise. Translation and scaling do not
+ * commute, so the result depends on the execution order of blocks sharing the geometry.
+ */
+class Modify: public mimmo::BaseManipulation{
+public:
+    bool m_translate;
+
+    Modify(bool translate):m_translate(translate){};
+    virtual ~Modify(){};
+    void buildPorts(){
+        m_arePortsBuilt = createPortIn<mimmo::MimmoObject*, Modify>(this, &mimmo::BaseManipulation::setGeometry, M_GEOM);
+    };
+    void execute(){
+        dvecarr3E coords;
+        livector1D ids;
+        for(const bitpit::Vertex & vertex : getGeometry()->getVertices()){
+            darray3E val = vertex.getCoords();
+            if(m_translate) val[0] += 1.0;
+            else            val *= 2.0;
+            coords.push_back(val);
+            ids.push_back(vertex.getId());
+        }
+        getGeometry()->modifyVertices(coords, ids);
+    };
+};
+
+/*
+ * Run a chain made of a source, some independent work blocks and two blocks modifying
+ * the same geometry. Return the results of the work blocks, the final coordinates and
+ * if the logger of the geometry is the same after the execution.
+ */
+void runChain(bool parallel, dvector1D & results, dvecarr3E & coords, bool & sameLogger){
+
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    for(long i=0; i<100; ++i){
+        mesh->addVertex(darray3E({{0.01*i, 0.02*i, 0.03*i}}), i);
+    }
+
+    Source * source = new Source();
+    source->setGeometry(mesh);
+    long n = 100000;
+    source->m_values.resize(n);
+    for(long i=0; i<n; ++i){
+        source->m_values[i] = {{1.0e-4*double(i), 2.0e-4*double(i), 1.0e-5*double(i)}};
+    }
+
+    mimmo::Chain * c0 = new mimmo::Chain();
+    c0->setParallelExecution(parallel);
+    c0->addObject(source);
+
+    int nwork = 8;
+    std::vector<Work *> works;
+    Modify * translate = new Modify(true);
+    Modify * scale = new Modify(false);
+    for(int k=0; k<nwork; ++k){
+        works.push_back(new Work(double(k+1)));
+        mimmo::pin::addPin(source, works.back(), M_GLOBAL, M_GLOBAL);
+        c0->addObject(works.back());
+        if(k == nwork/2){
+            c0->addObject(translate);
+            c0->addObject(scale);
+        }
+    }
+    mimmo::pin::addPin(source, translate, M_GEOM, M_GEOM);
+    mimmo::pin::addPin(source, scale, M_GEOM, M_GEOM);
+
+    bitpit::Logger * geoLog = &(mesh->getLog());
+    c0->exec(false);
+    sameLogger = (&(mesh->getLog()) == geoLog);
+
+    results.clear();
+    for(Work * work : works){
+        results.push_back(work->m_result);
+        delete work;
+    }
+    coords.clear();
+    for(const bitpit::Vertex & vertex : mesh->getVertices()){
+        coords.push_back(vertex.getCoords());
+    }
+
+    delete c0;
+    delete source;
+    delete translate;
+    delete scale;
+    delete mesh;
+}
+
+int test9() {
+
+    dvector1D serialResults, parallelResults;
+    dvecarr3E serialCoords, parallelCoords;
+    bool serialLogger, parallelLogger;
+    runChain(false, serialResults, serialCoords, serialLogger);
+    runChain(true, parallelResults, parallelCoords, parallelLogger);
+
+    bool check = serialLogger && parallelLogger;
+    if(!check){
+        std::cout<<"Geometry logger not restored after chain execution"<<std::endl;
+        return 1;
+    }
+    check = (serialResults == parallelResults);
+    if(!check){
+        std::cout<<"Parallel execution of independent chain objects differs from serial one"<<std::endl;
+        return 1;
+    }
+    check = (serialCoords == parallelCoords);
+    for(std::size_t i=0; i<serialCoords.size() && check; ++i){
+        //serial chain order: translation first, then scaling.
+        check = (serialCoords[i][0] == 2.0*(0.01*double(i) + 1.0));
+    }
+    if(!check){
+        std::cout<<"Parallel execution of chain objects sharing a geometry does not follow the chain order"<<std::endl;
+        return 1;
+    }
+    std::cout<<"Parallel execution of chain matches serial one"<<std::endl;
+
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test9() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00009 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
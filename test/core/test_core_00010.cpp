@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+#include <random>
+
+/*
+ * Test 00010
+ * Testing batched skd-tree queries (distance, signedDistance, projectPoint on a set of points)
+ * against the single point versions.
+ */
+
+// =================================================================================== //
+
+std::unique_ptr<mimmo::MimmoObject> createSphere(int n){
+
+    std::unique_ptr<mimmo::MimmoObject> sphere(new mimmo::MimmoObject(1));
+    double pi = 4.0*std::atan(1.0);
+    darray3E coords;
+    //poles and n-1 parallels of 2n points each.
+    sphere->addVertex(darray3E({{0.0, 0.0, 1.0}}), 0);
+    for(int j=1; j<n; ++j){
+        double theta = pi*double(j)/double(n);
+        for(int i=0; i<2*n; ++i){
+            double phi = pi*double(i)/double(n);
+            coords = {{std::sin(theta)*std::cos(phi), std::sin(theta)*std::sin(phi), std::cos(theta)}};
+            sphere->addVertex(coords, 1 + (j-1)*2*n + i);
+        }
+    }
+    long south = 1 + (n-1)*2*n;
+    sphere->addVertex(darray3E({{0.0, 0.0, -1.0}}), south);
+
+    std::vector<long> conn(3,0);
+    for(int i=0; i<2*n; ++i){
+        conn = {0, 1 + i, 1 + (i+1)%(2*n)};
+        sphere->addConnectedCell(conn, bitpit::ElementType::TRIANGLE);
+        conn = {south, 1 + (n-2)*2*n + (i+1)%(2*n), 1 + (n-2)*2*n + i};
+        sphere->addConnectedCell(conn, bitpit::ElementType::TRIANGLE);
+    }
+    for(int j=1; j<n-1; ++j){
+        for(int i=0; i<2*n; ++i){
+            long v0 = 1 + (j-1)*2*n + i;
+            long v1 = 1 + (j-1)*2*n + (i+1)%(2*n);
+            long v2 = 1 + j*2*n + (i+1)%(2*n);
+            long v3 = 1 + j*2*n + i;
+            conn = {v0, v3, v2};
+            sphere->addConnectedCell(conn, bitpit::ElementType::TRIANGLE);
+            conn = {v0, v2, v1};
+            sphere->addConnectedCell(conn, bitpit::ElementType::TRIANGLE);
+        }
+    }
+    sphere->buildAdjacencies();
+    return sphere;
+}
+
+int test10() {
+
+    std::unique_ptr<mimmo::MimmoObject> sphere = createSphere(24);
+    sphere->buildSkdTree();
+    bitpit::PatchSkdTree * tree = sphere->getSkdTree();
+
+    int nP = 4000;
+    std::vector<std::array<double,3>> points(nP);
+    std::mt19937 rgen(23);
+    std::uniform_real_distribution<double> distr(-1.5, 1.5);
+    for(std::array<double,3> & point : points){
+        point = {{distr(rgen), distr(rgen), distr(rgen)}};
+    }
+
+    double r = 10.0;
+    std::vector<long> ids(nP);
+    std::vector<double> distances(nP), signedDistances(nP);
+    std::vector<std::array<double,3>> normals(nP), projections(nP);
+    mimmo::skdTreeUtils::distance(nP, points.data(), tree, ids.data(), distances.data(), r);
+    mimmo::skdTreeUtils::signedDistance(nP, points.data(), tree, ids.data(), normals.data(), signedDistances.data(), r);
+    mimmo::skdTreeUtils::projectPoint(nP, points.data(), tree, projections.data());
+
+    //closest cells may differ on ties, distances and projections may not.
+    double maxerr = 0.0, maxerrSigned = 0.0, maxerrProj = 0.0;
+    for(int i=0; i<nP; ++i){
+        long id;
+        std::array<double,3> normal;
+        double radius = r;
+        double dist = mimmo::skdTreeUtils::distance(&points[i], tree, id, radius);
+        maxerr = std::max(maxerr, std::abs(dist - distances[i]));
+        radius = r;
+        dist = mimmo::skdTreeUtils::signedDistance(&points[i], tree, id, normal, radius);
+        maxerrSigned = std::max(maxerrSigned, std::abs(dist - signedDistances[i]));
+        std::array<double,3> proj = mimmo::skdTreeUtils::projectPoint(&points[i], tree);
+        maxerrProj = std::max(maxerrProj, norm2(proj - projections[i]));
+    }
+
+    bool check = (maxerr < 1.0e-12) && (maxerrSigned < 1.0e-12) && (maxerrProj < 1.0e-10);
+    if(!check){
+        std::cout<<"Batched skd-tree queries differ from single point ones. Max errors: distance "<<maxerr
+                 <<", signed distance "<<maxerrSigned<<", projection "<<maxerrProj<<std::endl;
+        return 1;
+    }
+    std::cout<<"Batched skd-tree queries match single point ones on "<<nP<<" points"<<std::endl;
+
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test10() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00010 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,118 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_core.hpp"
+
+/*
+ * Test 00011
+ * Testing the CSR point-point connectivity of a structured quad surface against the
+ * grid neighbourhood of its vertices, before and after a rebuild.
+ */
+
+// =================================================================================== //
+
+/*
+ * Check the point connectivity of each vertex of the grid: 1-ring neighbours are the
+ * vertices at distance one along each grid direction, listed once and sorted.
+ */
+bool checkConnectivity(mimmo::MimmoObject * mesh, int n){
+
+    bool check = mesh->isPointConnectivitySync();
+    for(int j=0; j<=n && check; ++j){
+        for(int i=0; i<=n && check; ++i){
+            std::vector<long> expected;
+            if(j > 0) expected.push_back((n+1)*(j-1) + i);
+            if(i > 0) expected.push_back((n+1)*j + i-1);
+            if(i < n) expected.push_back((n+1)*j + i+1);
+            if(j < n) expected.push_back((n+1)*(j+1) + i);
+
+            bitpit::ConstProxyVector<long> neighs = mesh->getPointConnectivity((n+1)*j + i);
+            std::vector<long> found(neighs.begin(), neighs.end());
+            check = (found == expected);
+        }
+    }
+    return check;
+}
+
+int test11() {
+
+    //unit square surface of n x n quads.
+    int n = 20;
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(1);
+    for(int j=0; j<=n; ++j){
+        for(int i=0; i<=n; ++i){
+            mesh->addVertex(darray3E({{i/double(n), j/double(n), 0.0}}), (n+1)*j + i);
+        }
+    }
+    for(int j=0; j<n; ++j){
+        for(int i=0; i<n; ++i){
+            livector1D conn = {(n+1)*j + i, (n+1)*j + i+1, (n+1)*(j+1) + i+1, (n+1)*(j+1) + i};
+            mesh->addConnectedCell(conn, bitpit::ElementType::QUAD);
+        }
+    }
+    mesh->buildAdjacencies();
+
+    mesh->buildPointConnectivity();
+    bool check = checkConnectivity(mesh, n);
+    std::cout<<"Point connectivity matches the grid neighbourhood: "<<check<<std::endl;
+
+    //a rebuild after cleaning has to give the same structure.
+    mesh->cleanPointConnectivity();
+    check = check && !mesh->isPointConnectivitySync();
+    mesh->buildPointConnectivity();
+    check = check && checkConnectivity(mesh, n);
+    std::cout<<"Point connectivity correctly rebuilt: "<<check<<std::endl;
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test11() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_core_00011 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
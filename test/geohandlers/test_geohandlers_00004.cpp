@@ -0,0 +1,156 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+#include "mimmo_geohandlers.hpp"
+
+// =================================================================================== //
+/*!
+ * Testing SelectionByMapping with several mapping geometries, mapped concurrently:
+ * the selection has to be the union of the selections obtained with each single geometry.
+ * A missing mapping file has to abort the selection.
+ */
+int test4() {
+
+    //plane quad mesh of n x n cells on z=0.
+    int n = 32;
+    double h = 1.0/double(n);
+    std::unique_ptr<mimmo::MimmoObject> target(new mimmo::MimmoObject(1));
+    for(int j=0; j<=n; ++j){
+        for(int i=0; i<=n; ++i){
+            target->addVertex(darray3E({{i*h, j*h, 0.0}}), (n+1)*j + i);
+        }
+    }
+    livector1D conn(4,0);
+    for(int j=0; j<n; ++j){
+        for(int i=0; i<n; ++i){
+            conn[0] = (n+1)*j + i;
+            conn[1] = conn[0] + 1;
+            conn[2] = conn[0] + n + 2;
+            conn[3] = conn[0] + n + 1;
+            target->addConnectedCell(conn, bitpit::ElementType::QUAD);
+        }
+    }
+    target->buildAdjacencies();
+
+    //mapping geometries are portions of the target extracted by boxes.
+    std::vector<darray3E> origins = {{{0.1, 0.15, 0.0}}, {{0.6, 0.4, 0.0}}, {{0.45, 0.8, 0.0}}, {{0.75, 0.55, 0.0}}};
+    darray3E span = {{0.2, 0.25, 0.1}};
+    std::vector<mimmo::SelectionByBox*> boxes;
+    for(darray3E & origin : origins){
+        mimmo::SelectionByBox * box = new mimmo::SelectionByBox(origin, span, target.get());
+        box->exec();
+        boxes.push_back(box);
+    }
+
+    double tol = 1.0e-6;
+    bool check = true;
+    for(bool dual : {false, true}){
+
+        //reference: union of the selections obtained with each geometry.
+        std::set<long> reference;
+        for(mimmo::SelectionByBox * box : boxes){
+            mimmo::SelectionByMapping * single = new mimmo::SelectionByMapping(1);
+            single->setGeometry(target.get());
+            single->setTolerance(tol);
+            single->addMappingGeometry(box->getPatch());
+            single->exec();
+            livector1D ids = single->getPatch()->getCellsIds();
+            reference.insert(ids.begin(), ids.end());
+            delete single;
+        }
+        if(dual){
+            std::set<long> complement;
+            for(long id : target->getCellsIds()){
+                if(!reference.count(id))    complement.insert(id);
+            }
+            reference.swap(complement);
+        }
+
+        mimmo::SelectionByMapping * all = new mimmo::SelectionByMapping(1);
+        all->setGeometry(target.get());
+        all->setTolerance(tol);
+        all->setDual(dual);
+        for(mimmo::SelectionByBox * box : boxes){
+            all->addMappingGeometry(box->getPatch());
+        }
+        all->exec();
+        livector1D ids = all->getPatch()->getCellsIds();
+        std::sort(ids.begin(), ids.end());
+        delete all;
+
+        check = check && !reference.empty() && (ids == livector1D(reference.begin(), reference.end()));
+        std::cout<<"selected cells (dual "<<dual<<"): "<<ids.size()<<", union of single selections: "<<reference.size()<<std::endl;
+    }
+
+    //a missing file aborts the selection.
+    mimmo::SelectionByMapping * missing = new mimmo::SelectionByMapping(1);
+    missing->setGeometry(target.get());
+    missing->addMappingGeometry(boxes[0]->getPatch());
+    missing->addFile(std::make_pair(std::string("./missingMappingFile.stl"), int(mimmo::FileType::STL)));
+    bool aborted = false;
+    try{
+        missing->exec();
+    }catch(std::exception & e){
+        aborted = true;
+    }
+    delete missing;
+    check = check && aborted;
+
+    for(mimmo::SelectionByBox * box : boxes){
+        delete box;
+    }
+
+    if(!check){
+        std::cout<<"Failed selection by mapping several geometries"<<std::endl;
+        return 1;
+    }
+    std::cout<<"test passed "<<std::endl;
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+	/**<Calling mimmo Test routines*/
+	int val = 1;
+	try{
+		val = test4() ;
+	}
+	catch(std::exception & e){
+		std::cout<<"test_geohandlers_00004 exited with an error of type : "<<e.what()<<std::endl;
+		return 1;
+	}
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_manipulators.hpp"
+#if MIMMO_ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+// =================================================================================== //
+/*!
+ * Testing MRBF threaded evaluation against the serial one, with a compactly supported
+ * kernel (evaluation on the RBF nodes grid) and with a global kernel (full evaluation).
+ */
+
+int test4() {
+
+    //point cloud of 30x30x4 vertices and 6x6x2 RBF nodes with direct weights.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    long counter = 0;
+    for(int k=0; k<4; ++k){
+        for(int j=0; j<30; ++j){
+            for(int i=0; i<30; ++i){
+                mesh->addVertex(darray3E({{i/29.0, j/29.0, 0.1*k}}), counter);
+                ++counter;
+            }
+        }
+    }
+    dvecarr3E nodes, displs;
+    for(int k=0; k<2; ++k){
+        for(int j=0; j<6; ++j){
+            for(int i=0; i<6; ++i){
+                nodes.push_back({{0.2*i, 0.2*j, 0.3*k}});
+                displs.push_back({{0.01*i, -0.02*j, 0.05*std::sin(1.0 + i + 2*j + 3*k)}});
+            }
+        }
+    }
+
+    int maxThreads = 1;
+#if MIMMO_ENABLE_OPENMP
+    maxThreads = omp_get_max_threads();
+#endif
+
+    bool check = true;
+    for(int kernel=0; kernel<2; ++kernel){
+        mimmo::MRBF * mrbf = new mimmo::MRBF();
+        mrbf->setGeometry(mesh);
+        mrbf->setMode(mimmo::MRBFSol::NONE);
+        if(kernel == 0) mrbf->setFunction(bitpit::RBFBasisFunction::WENDLANDC2);
+        else            mrbf->setFunction(mimmo::MRBFBasisFunction::HEAVISIDE10);
+        mrbf->setSupportRadiusValue(0.5);
+        mrbf->setNode(nodes);
+        mrbf->setDisplacements(displs);
+
+#if MIMMO_ENABLE_OPENMP
+        omp_set_num_threads(1);
+#endif
+        mrbf->exec();
+        dmpvecarr3E serial = *(mrbf->getDisplacements());
+#if MIMMO_ENABLE_OPENMP
+        omp_set_num_threads(maxThreads);
+#endif
+        mrbf->exec();
+        dmpvecarr3E * threaded = mrbf->getDisplacements();
+
+        check = check && (serial.size() == threaded->size()) && (serial.size() == std::size_t(counter));
+        for(auto it = serial.begin(); it != serial.end() && check; ++it){
+            check = threaded->exists(it.getId()) && ((*threaded)[it.getId()] == *it);
+        }
+        delete mrbf;
+        std::cout<<"MRBF threaded evaluation with "<<(kernel == 0 ? "compact" : "global")<<" kernel matches serial one: "<<check<<std::endl;
+    }
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test4() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00004 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,118 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+
+#include "mimmo_manipulators.hpp"
+#include <random>
+
+// =================================================================================== //
+/*!
+ * Testing MRBF evaluation on the RBF nodes grid, used for compactly supported kernels,
+ * against the full bitpit::RBF evaluation on every RBF node.
+ */
+
+int test5() {
+
+    //point cloud of 40x40x3 vertices, overhanging the region of the RBF nodes.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    long counter = 0;
+    for(int k=0; k<3; ++k){
+        for(int j=0; j<40; ++j){
+            for(int i=0; i<40; ++i){
+                mesh->addVertex(darray3E({{-0.5 + 2.0*i/39.0, -0.5 + 2.0*j/39.0, 0.15*k}}), counter);
+                ++counter;
+            }
+        }
+    }
+
+    //randomly placed RBF nodes in the unit cube, with random displacements.
+    std::mt19937 rgen(5);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    dvecarr3E nodes(300), displs(300);
+    for(std::size_t i=0; i<nodes.size(); ++i){
+        nodes[i] = {{unif(rgen), unif(rgen), 0.3*unif(rgen)}};
+        displs[i] = {{0.1*unif(rgen) - 0.05, 0.1*unif(rgen) - 0.05, 0.1*unif(rgen) - 0.05}};
+    }
+
+    bool check = true;
+    for(int kernel=0; kernel<2; ++kernel){
+        mimmo::MRBF * mrbf = new mimmo::MRBF();
+        mrbf->setGeometry(mesh);
+        mrbf->setMode(mimmo::MRBFSol::NONE);
+        if(kernel == 0) mrbf->setFunction(bitpit::RBFBasisFunction::WENDLANDC2);
+        else            mrbf->setFunction(bitpit::RBFBasisFunction::C1C1);
+        mrbf->setSupportRadiusValue(0.2);
+        mrbf->setNode(nodes);
+        mrbf->setDisplacements(displs);
+        mrbf->exec();
+
+        dmpvecarr3E * local = mrbf->getDisplacements();
+        check = check && (local->size() == std::size_t(counter));
+        double maxdiff = 0.0;
+        for(bitpit::Vertex & vertex : mesh->getVertices()){
+            if(!local->exists(vertex.getId())){
+                check = false;
+                break;
+            }
+            dvector1D full = mrbf->evalRBF(vertex.getCoords());
+            const darray3E & value = (*local)[vertex.getId()];
+            for(int j=0; j<3; ++j){
+                maxdiff = std::max(maxdiff, std::abs(value[j] - full[j]));
+            }
+        }
+        check = check && (maxdiff <= 1.0e-14);
+        delete mrbf;
+        std::cout<<"MRBF grid evaluation with kernel "<<kernel<<" differs from the full one by "<<maxdiff<<std::endl;
+    }
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test5() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00005 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,115 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+
+#include "mimmo_manipulators.hpp"
+#include <random>
+
+// =================================================================================== //
+/*!
+ * Testing MRBF interpolation (Mode WHOLE) with a compactly supported kernel, solved with the
+ * sparse iterative solver against the dense direct one. Without the bitpit LA module the
+ * sparse request falls back to the dense solver.
+ */
+
+int test6() {
+
+    //point cloud of 25x25x5 vertices.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    long counter = 0;
+    for(int k=0; k<5; ++k){
+        for(int j=0; j<25; ++j){
+            for(int i=0; i<25; ++i){
+                mesh->addVertex(darray3E({{i/24.0, j/24.0, 0.1*k}}), counter);
+                ++counter;
+            }
+        }
+    }
+
+    //randomly placed RBF nodes with random displacements.
+    std::mt19937 rgen(6);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    dvecarr3E nodes(400), displs(400);
+    for(std::size_t i=0; i<nodes.size(); ++i){
+        nodes[i] = {{unif(rgen), unif(rgen), 0.4*unif(rgen)}};
+        displs[i] = {{0.1*unif(rgen) - 0.05, 0.1*unif(rgen) - 0.05, 0.1*unif(rgen) - 0.05}};
+    }
+
+    dmpvecarr3E results[2];
+    for(int sparse=0; sparse<2; ++sparse){
+        mimmo::MRBF * mrbf = new mimmo::MRBF();
+        mrbf->setGeometry(mesh);
+        mrbf->setMode(mimmo::MRBFSol::WHOLE);
+        mrbf->setFunction(bitpit::RBFBasisFunction::WENDLANDC2);
+        mrbf->setSupportRadiusValue(0.25);
+        mrbf->setSparseSolver(sparse == 1);
+        mrbf->setSparseSolverTolerance(1.0e-12);
+        mrbf->setSparseSolverRestart(100);
+        mrbf->setNode(nodes);
+        mrbf->setDisplacements(displs);
+        mrbf->exec();
+        results[sparse] = *(mrbf->getDisplacements());
+        delete mrbf;
+    }
+
+    bool check = (results[0].size() == std::size_t(counter)) && (results[1].size() == std::size_t(counter));
+    double maxdiff = 0.0;
+    for(auto it = results[0].begin(); it != results[0].end() && check; ++it){
+        check = results[1].exists(it.getId());
+        if(!check)  break;
+        maxdiff = std::max(maxdiff, norm2(results[1][it.getId()] - *it));
+    }
+    check = check && (maxdiff <= 1.0e-6);
+    std::cout<<"MRBF sparse solver differs from the dense one by "<<maxdiff<<std::endl;
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test6() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00006 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,119 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+
+#include "mimmo_manipulators.hpp"
+#include <random>
+
+// =================================================================================== //
+/*!
+ * Testing MRBF far-field approximated evaluation with a decaying global kernel against
+ * the exact evaluation: the error on each field must be within tolerance * sum(|w_i|).
+ */
+
+int test7() {
+
+    //point cloud of 30x30x3 vertices.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    long counter = 0;
+    for(int k=0; k<3; ++k){
+        for(int j=0; j<30; ++j){
+            for(int i=0; i<30; ++i){
+                mesh->addVertex(darray3E({{-1.0 + 3.0*i/29.0, -1.0 + 3.0*j/29.0, 0.2*k}}), counter);
+                ++counter;
+            }
+        }
+    }
+
+    //randomly placed RBF nodes with random direct weights.
+    std::mt19937 rgen(7);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    dvecarr3E nodes(500), displs(500);
+    darray3E sumWeights = {{0.0, 0.0, 0.0}};
+    for(std::size_t i=0; i<nodes.size(); ++i){
+        nodes[i] = {{unif(rgen), unif(rgen), 0.3*unif(rgen)}};
+        displs[i] = {{0.02*unif(rgen) - 0.01, 0.02*unif(rgen) - 0.01, 0.02*unif(rgen) - 0.01}};
+        for(int j=0; j<3; ++j) sumWeights[j] += std::abs(displs[i][j]);
+    }
+
+    double tol = 1.0e-3;
+    dmpvecarr3E results[2];
+    for(int approx=0; approx<2; ++approx){
+        mimmo::MRBF * mrbf = new mimmo::MRBF();
+        mrbf->setGeometry(mesh);
+        mrbf->setMode(mimmo::MRBFSol::NONE);
+        mrbf->setFunction(mimmo::MRBFBasisFunction::HEAVISIDE10);
+        mrbf->setSupportRadiusValue(0.2);
+        mrbf->setFarFieldTolerance(approx == 1 ? tol : 0.0);
+        mrbf->setNode(nodes);
+        mrbf->setDisplacements(displs);
+        mrbf->exec();
+        results[approx] = *(mrbf->getDisplacements());
+        delete mrbf;
+    }
+
+    bool check = (results[0].size() == std::size_t(counter)) && (results[1].size() == std::size_t(counter));
+    darray3E maxdiff = {{0.0, 0.0, 0.0}};
+    for(auto it = results[0].begin(); it != results[0].end() && check; ++it){
+        check = results[1].exists(it.getId());
+        if(!check)  break;
+        for(int j=0; j<3; ++j){
+            maxdiff[j] = std::max(maxdiff[j], std::abs(results[1][it.getId()][j] - (*it)[j]));
+        }
+    }
+    for(int j=0; j<3; ++j){
+        check = check && (maxdiff[j] <= tol*sumWeights[j]);
+    }
+    std::cout<<"MRBF far-field error "<<maxdiff<<" within bound "<<tol*sumWeights<<" : "<<check<<std::endl;
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test7() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00007 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
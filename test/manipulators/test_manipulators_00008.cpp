@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+
+#include "mimmo_manipulators.hpp"
+
+// =================================================================================== //
+/*!
+ * Testing MRBF greedy interpolation, incremental (Mode GREEDYINCR) and standard (Mode GREEDY):
+ * RBF nodes lie on the geometry vertices, so the resulting displacements must fit the
+ * nodes displacements within the greedy tolerance.
+ */
+
+int test8() {
+
+    //point cloud of 20x20x2 vertices, each one being also an RBF node.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    dvecarr3E nodes, displs;
+    long counter = 0;
+    for(int k=0; k<2; ++k){
+        for(int j=0; j<20; ++j){
+            for(int i=0; i<20; ++i){
+                darray3E coords = {{i/19.0, j/19.0, 0.2*k}};
+                mesh->addVertex(coords, counter);
+                nodes.push_back(coords);
+                displs.push_back({{0.05*std::sin(3.0*coords[0]), 0.05*std::cos(2.0*coords[1]), 0.02*coords[0]*coords[1]}});
+                ++counter;
+            }
+        }
+    }
+
+    double tol = 1.0e-4;
+    bool check = true;
+    for(int mode=0; mode<2; ++mode){
+        mimmo::MRBF * mrbf = new mimmo::MRBF();
+        mrbf->setGeometry(mesh);
+        mrbf->setMode(mode == 0 ? mimmo::MRBFSol::GREEDYINCR : mimmo::MRBFSol::GREEDY);
+        mrbf->setFunction(bitpit::RBFBasisFunction::WENDLANDC2);
+        mrbf->setSupportRadiusValue(0.4);
+        mrbf->setTol(tol);
+        mrbf->setNode(nodes);
+        mrbf->setDisplacements(displs);
+        mrbf->exec();
+
+        dmpvecarr3E * result = mrbf->getDisplacements();
+        double maxdiff = 0.0;
+        for(long id=0; id<counter; ++id){
+            if(!result->exists(id)){
+                check = false;
+                break;
+            }
+            maxdiff = std::max(maxdiff, norm2((*result)[id] - displs[id]));
+        }
+        check = check && (maxdiff <= 10.0*tol);
+        if(mode == 0){
+            check = check && !mrbf->getGreedyIterationTimes().empty();
+        }
+        std::cout<<"MRBF "<<(mode == 0 ? "incremental " : "")<<"greedy: "<<mrbf->getActiveCount()
+                 <<" active nodes, max error on nodes "<<maxdiff<<std::endl;
+        delete mrbf;
+    }
+
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test8() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00008 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
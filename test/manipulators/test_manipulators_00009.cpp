@@ -0,0 +1,135 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+
+#include "mimmo_manipulators.hpp"
+
+// =================================================================================== //
+/*!
+ * Testing FFDLattice cached evaluation: results of cached and standard evaluation
+ * have to match, and the cache has to be rebuilt when the geometry is modified.
+ */
+
+int test9() {
+
+    //point cloud of 11x11x11 vertices on the unit cube.
+    mimmo::MimmoObject * mesh = new mimmo::MimmoObject(3);
+    long counter = 0;
+    for(int k=0; k<=10; ++k){
+        for(int j=0; j<=10; ++j){
+            for(int i=0; i<=10; ++i){
+                mesh->addVertex(darray3E({{0.1*i, 0.1*j, 0.1*k}}), counter);
+                ++counter;
+            }
+        }
+    }
+
+    //twin lattices wrapping the cube, with the same smooth displacement of their nodes.
+    mimmo::FFDLattice * latt[2];
+    for(int c=0; c<2; ++c){
+        latt[c] = new mimmo::FFDLattice();
+        latt[c]->setGeometry(mesh);
+        latt[c]->setShape(mimmo::ShapeType::CUBE);
+        latt[c]->setOrigin({{0.5, 0.5, 0.5}});
+        latt[c]->setSpan({{1.2, 1.2, 1.2}});
+        latt[c]->setDimension(iarray3E({{5, 5, 5}}));
+        latt[c]->setDegrees(iarray3E({{2, 2, 2}}));
+        latt[c]->setCachedEvaluation(c == 1);
+        latt[c]->build();
+
+        int nNodes = latt[c]->getNNodes();
+        dvecarr3E displ(nNodes);
+        for(int i=0; i<nNodes; ++i){
+            displ[i] = {{0.05*std::sin(double(i)), 0.05*std::cos(1.3*i), 0.05*std::sin(0.7*i)}};
+        }
+        latt[c]->setDisplacements(displ);
+    }
+
+    //first cached execution builds the cache, the second one reuses it.
+    latt[0]->exec();
+    dmpvecarr3E reference = *(latt[0]->getDeformation());
+    latt[1]->exec();
+    dmpvecarr3E first = *(latt[1]->getDeformation());
+    latt[1]->exec();
+    dmpvecarr3E second = *(latt[1]->getDeformation());
+
+    bool check = (reference.size() == std::size_t(counter)) && (first.size() == reference.size()) && (second.size() == reference.size());
+    double diff = 0.0;
+    for(auto it = reference.begin(); it != reference.end() && check; ++it){
+        check = first.exists(it.getId()) && second.exists(it.getId()) && (first[it.getId()] == second[it.getId()]);
+        if(check)   diff = std::max(diff, norm2(first[it.getId()] - *it));
+    }
+    check = check && (diff < 1.0e-12);
+    std::cout<<"FFDLattice cached evaluation differs from standard one by "<<diff<<std::endl;
+
+    //displace the geometry: the cache has to be rebuilt on the displaced vertices.
+    mesh->displaceVertices(reference, 0.5);
+    latt[0]->exec();
+    reference = *(latt[0]->getDeformation());
+    latt[1]->exec();
+    dmpvecarr3E third = *(latt[1]->getDeformation());
+
+    diff = 0.0;
+    double change = 0.0;
+    for(auto it = reference.begin(); it != reference.end() && check; ++it){
+        check = third.exists(it.getId());
+        if(!check)  break;
+        diff = std::max(diff, norm2(third[it.getId()] - *it));
+        change = std::max(change, norm2(third[it.getId()] - first[it.getId()]));
+    }
+    check = check && (diff < 1.0e-12) && (change > 1.0e-8);
+    std::cout<<"FFDLattice cached evaluation after geometry displacement differs from standard one by "<<diff<<std::endl;
+
+    delete latt[0];
+    delete latt[1];
+    delete mesh;
+    return int(!check);
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test9() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_manipulators_00009 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,227 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_propagators.hpp"
+
+// =================================================================================== //
+/*!
+	\example test_propagators_00004.cpp
+
+	\brief Example of scalar field propagation with non-default Krylov solvers and preconditioners.
+
+	Using: PropagateScalarField
+
+	<b>To run</b>: ./test_propagators_00004 \n
+
+	<b> visit</b>: <a href="http://optimad.github.io/mimmo/">mimmo website</a> \n
+
+ */
+
+
+// =================================================================================== //
+
+std::unique_ptr<mimmo::MimmoObject> createTestVolumeMesh(std::vector<long> &bcdir1_vertlist, std::vector<long> &bcdir2_vertlist){
+
+    double radiusin(2.0), radiusout(5.0);
+    double azimuthin(0.0), azimuthout(0.5*BITPIT_PI);
+    double heightbottom(-1.0), heighttop(1.0);
+    int nr(6), nt(10), nh(6);
+
+    double deltar = (radiusout - radiusin)/ double(nr);
+    double deltat = (azimuthout - azimuthin)/ double(nt);
+    double deltah = (heighttop - heightbottom)/ double(nh);
+
+    std::unique_ptr<mimmo::MimmoObject> mesh = std::unique_ptr<mimmo::MimmoObject>(new mimmo::MimmoObject(2));
+    mesh->getPatch()->reserveVertices((nr+1)*(nt+1)*(nh+1));
+
+    std::array<double,3> vertex;
+    for(int k=0; k<=nh; ++k){
+        for(int j=0; j<=nt; ++j){
+            for(int i=0; i<=nr; ++i){
+                vertex[0] =(radiusin + i*deltar)*std::cos(azimuthin + j*deltat);
+                vertex[1] =(radiusin + i*deltar)*std::sin(azimuthin + j*deltat);
+                vertex[2] =(heightbottom + k*deltah);
+                mesh->addVertex(vertex);
+            }
+        }
+    }
+    mesh->getPatch()->reserveCells(nr*nt*nh);
+
+    std::vector<long> conn(8,0);
+    for(int k=0; k<nh; ++k){
+        for(int j=0; j<nt; ++j){
+            for(int i=0; i<nr; ++i){
+                conn[0] = (nr+1)*(nt+1)*k + (nr+1)*j + i;
+                conn[1] = (nr+1)*(nt+1)*k + (nr+1)*j + i+1;
+                conn[2] = (nr+1)*(nt+1)*k + (nr+1)*(j+1) + i+1;
+                conn[3] = (nr+1)*(nt+1)*k + (nr+1)*(j+1) + i;
+                conn[4] = (nr+1)*(nt+1)*(k+1) + (nr+1)*j + i;
+                conn[5] = (nr+1)*(nt+1)*(k+1) + (nr+1)*j + i+1;
+                conn[6] = (nr+1)*(nt+1)*(k+1) + (nr+1)*(j+1) + i+1;
+                conn[7] = (nr+1)*(nt+1)*(k+1) + (nr+1)*(j+1) + i;
+                mesh->addConnectedCell(conn, bitpit::ElementType::HEXAHEDRON);
+            }
+        }
+    }
+
+    mesh->buildAdjacencies();
+    mesh->buildInterfaces();
+
+    bcdir1_vertlist.clear();
+    bcdir2_vertlist.clear();
+    for(int k=0; k<=nh; ++k){
+        for(int i=0; i<=nr; ++i){
+            bcdir1_vertlist.push_back((nr+1)*(nt+1)*k + i);
+            bcdir2_vertlist.push_back((nr+1)*(nt+1)*k + (nr+1)*nt + i);
+        }
+    }
+    return mesh;
+}
+
+// =================================================================================== //
+
+/*
+    Solve the scalar propagation with a given Krylov solver and preconditioner.
+*/
+dmpvector1D propagate(mimmo::MimmoObject * mesh, mimmo::MimmoObject * bdirMesh, dmpvector1D * bc,
+                             mimmo::PropagatorKrylov krylov, mimmo::PropagatorPreconditioner preconditioner, long & iterations){
+
+    mimmo::PropagateScalarField * prop = new mimmo::PropagateScalarField();
+    prop->setGeometry(mesh);
+    prop->setDirichletBoundarySurface(bdirMesh);
+    prop->setDirichletConditions(bc);
+    prop->setDumping(false);
+    prop->setTolerance(1.0E-10);
+    prop->setSolverType(krylov);
+    prop->setPreconditioner(preconditioner);
+
+    prop->exec();
+
+    dmpvector1D result = *(prop->getPropagatedField());
+    iterations = 0;
+    for(long its : prop->getSolverIterations()){
+        iterations += its;
+    }
+    delete prop;
+    return result;
+}
+
+/*
+    Testing non-default Krylov solvers and preconditioners against the default GMRES-ASM setup.
+*/
+int test4() {
+
+    std::vector<long> bc1list, bc2list;
+    std::unique_ptr<mimmo::MimmoObject> mesh = createTestVolumeMesh(bc1list, bc2list);
+
+    livector1D cellInterfaceList1 = mesh->getInterfaceFromVertexList(bc1list, true, true);
+    livector1D cellInterfaceList2 = mesh->getInterfaceFromVertexList(bc2list, true, true);
+
+    std::unique_ptr<mimmo::MimmoObject> bdirMesh = std::unique_ptr<mimmo::MimmoObject>(new mimmo::MimmoObject(1));
+    for(auto & val : bc1list){
+        bdirMesh->addVertex(mesh->getVertexCoords(val), val);
+    }
+    for(auto & val : bc2list){
+        bdirMesh->addVertex(mesh->getVertexCoords(val), val);
+    }
+    for(auto & list : {cellInterfaceList1, cellInterfaceList2}){
+        for(auto & val : list){
+            int sizeconn =mesh->getInterfaces().at(val).getConnectSize();
+            long * conn = mesh->getInterfaces().at(val).getConnect();
+            bdirMesh->addConnectedCell(std::vector<long>(&conn[0], &conn[sizeconn]),
+                                       bitpit::ElementType::QUAD, val);
+        }
+    }
+    bdirMesh->buildAdjacencies();
+
+    dmpvector1D bc_surf_field;
+    bc_surf_field.setGeometry(bdirMesh.get());
+    bc_surf_field.setDataLocation(mimmo::MPVLocation::POINT);
+    for(auto & val : bc1list){
+        bc_surf_field.insert(val, 10.0);
+    }
+    for(auto & val : bc2list){
+        bc_surf_field.insert(val, 0.0);
+    }
+
+    long itsDefault, itsBicg, itsFgmres, itsAfter;
+    dmpvector1D reference = propagate(mesh.get(), bdirMesh.get(), &bc_surf_field,
+            mimmo::PropagatorKrylov::GMRES, mimmo::PropagatorPreconditioner::ASM, itsDefault);
+    dmpvector1D bicg = propagate(mesh.get(), bdirMesh.get(), &bc_surf_field,
+            mimmo::PropagatorKrylov::BICGSTAB, mimmo::PropagatorPreconditioner::JACOBI, itsBicg);
+    dmpvector1D fgmres = propagate(mesh.get(), bdirMesh.get(), &bc_surf_field,
+            mimmo::PropagatorKrylov::FGMRES, mimmo::PropagatorPreconditioner::ILU, itsFgmres);
+    //the settings of the previous solvers must not leak into a new default one.
+    dmpvector1D after = propagate(mesh.get(), bdirMesh.get(), &bc_surf_field,
+            mimmo::PropagatorKrylov::GMRES, mimmo::PropagatorPreconditioner::ASM, itsAfter);
+
+    bool check = true;
+    long targetNode =  (10 +1)*(6+1)*3 + (6+1)*5 + 3;
+    check = check && (std::abs(reference.at(targetNode) - 5.0) < 1.0E-6);
+    for(auto it = reference.begin(); it != reference.end(); ++it){
+        long id = it.getId();
+        check = check && (std::abs(bicg.at(id) - *it) < 1.0E-6);
+        check = check && (std::abs(fgmres.at(id) - *it) < 1.0E-6);
+        check = check && (std::abs(after.at(id) - *it) < 1.0E-12);
+    }
+    check = check && (itsAfter == itsDefault);
+
+    std::cout<<"GMRES-ASM iterations: "<<itsDefault<<std::endl;
+    std::cout<<"BiCGStab-Jacobi iterations: "<<itsBicg<<std::endl;
+    std::cout<<"FGMRES-ILU iterations: "<<itsFgmres<<std::endl;
+
+    if(!check){
+        std::cout<<"Failed propagation with non-default solver settings"<<std::endl;
+        return 1;
+    }
+    std::cout<<"test passed "<<std::endl;
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+		/**<Calling mimmo Test routines*/
+        int val = 1;
+        try{
+            val = test4() ;
+        }
+        catch(std::exception & e){
+            std::cout<<"test_propagators_00004 exited with an error of type : "<<e.what()<<std::endl;
+            return 1;
+        }
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}
@@ -0,0 +1,181 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  mimmo
+ *
+ *  Copyright (C) 2015-2017 OPTIMAD engineering Srl
+ *
+ *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of mimmo.
+ *
+ *  mimmo is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  mimmo is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with mimmo. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \ *---------------------------------------------------------------------------*/
+
+
+#include "mimmo_utils.hpp"
+#include <algorithm>
+
+// =================================================================================== //
+/*
+ * Test 00004
+ * Testing MeshChecker incremental mode through repeated Chain executions.
+ */
+
+/*
+ * Block deforming a geometry with a given displacement field, and providing
+ * the geometry and the applied field on its output ports.
+ */
+class DeformSource: public mimmo::BaseManipulation{
+public:
+    dmpvecarr3E m_field;
+
+    DeformSource(){};
+    virtual ~DeformSource(){};
+    dmpvecarr3E * getDeformation(){ return &m_field; };
+    void buildPorts(){
+        bool built = true;
+        built = built && createPortOut<mimmo::MimmoObject*, DeformSource>(this, &mimmo::BaseManipulation::getGeometry, M_GEOM);
+        built = built && createPortOut<dmpvecarr3E*, DeformSource>(this, &DeformSource::getDeformation, M_GDISPLS);
+        m_arePortsBuilt = built;
+    };
+    void execute(){
+        if(!m_field.empty()) getGeometry()->displaceVertices(m_field);
+    };
+};
+
+/*
+ * MeshChecker exposing its quality indicators and the cells evaluated in the last check.
+ */
+class TestMeshChecker: public mimmo::MeshChecker{
+public:
+    long countEvaluatedCells(){
+        return long(std::count(m_cellEval.begin(), m_cellEval.end(), char(1)));
+    };
+    std::array<double,4> getIndicators(){
+        return std::array<double,4>({{m_minVolume, m_maxSkewness, m_minFaceValidity, m_minVolumeChange}});
+    };
+};
+
+int test4() {
+
+    //structured hexahedral mesh of the unit cube, n cells per side.
+    int n = 8;
+    std::unique_ptr<mimmo::MimmoObject> mesh(new mimmo::MimmoObject(2));
+    double h = 1.0/double(n);
+    for(int k=0; k<=n; ++k){
+        for(int j=0; j<=n; ++j){
+            for(int i=0; i<=n; ++i){
+                mesh->addVertex(darray3E({{i*h, j*h, k*h}}), (n+1)*(n+1)*k + (n+1)*j + i);
+            }
+        }
+    }
+    std::vector<long> conn(8,0);
+    for(int k=0; k<n; ++k){
+        for(int j=0; j<n; ++j){
+            for(int i=0; i<n; ++i){
+                conn[0] = (n+1)*(n+1)*k + (n+1)*j + i;
+                conn[1] = conn[0] + 1;
+                conn[2] = conn[0] + n + 2;
+                conn[3] = conn[0] + n + 1;
+                for(int v=0; v<4; ++v)  conn[v+4] = conn[v] + (n+1)*(n+1);
+                mesh->addConnectedCell(conn, bitpit::ElementType::HEXAHEDRON);
+            }
+        }
+    }
+    mesh->buildAdjacencies();
+    mesh->buildInterfaces();
+    long ncells = mesh->getNCells();
+
+    DeformSource * source = new DeformSource();
+    source->setGeometry(mesh.get());
+
+    TestMeshChecker * checker = new TestMeshChecker();
+    checker->setIncremental(true);
+
+    mimmo::pin::addPin(source, checker, M_GEOM, M_GEOM);
+    mimmo::pin::addPin(source, checker, M_GDISPLS, M_GDISPLS);
+
+    mimmo::Chain * c0 = new mimmo::Chain();
+    c0->addObject(source);
+    c0->addObject(checker);
+
+    //first execution: full check on the undeformed mesh.
+    c0->exec(false);
+    bool check = (checker->countEvaluatedCells() == ncells);
+
+    //second execution: displace one interior vertex, only the cells around it are checked again.
+    long target = (n+1)*(n+1)*(n/2) + (n+1)*(n/2) + n/2;
+    source->m_field.clear();
+    source->m_field.setGeometry(mesh.get());
+    source->m_field.setDataLocation(mimmo::MPVLocation::POINT);
+    source->m_field.insert(target, {{0.3/double(n), -0.2/double(n), 0.1/double(n)}});
+    c0->exec(false);
+
+    long nevaluated = checker->countEvaluatedCells();
+    check = check && (nevaluated > 0) && (nevaluated < ncells);
+
+    //reference full check on the deformed mesh.
+    TestMeshChecker * reference = new TestMeshChecker();
+    reference->setGeometry(mesh.get());
+    reference->exec();
+
+    std::array<double,4> incr = checker->getIndicators();
+    std::array<double,4> full = reference->getIndicators();
+    for(int i=0; i<4; ++i){
+        check = check && (std::abs(incr[i] - full[i]) <= 1.0E-12*std::max(1.0, std::abs(full[i])));
+    }
+    check = check && (checker->getQualityStatus() == reference->getQualityStatus());
+
+    std::cout<<"cells checked again in incremental mode: "<<nevaluated<<" of "<<ncells<<std::endl;
+
+    delete c0;
+    delete source;
+    delete checker;
+    delete reference;
+
+    if(!check){
+        std::cout<<"Failed incremental mesh check"<<std::endl;
+        return 1;
+    }
+    std::cout<<"test passed "<<std::endl;
+    return 0;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+	BITPIT_UNUSED(argc);
+	BITPIT_UNUSED(argv);
+
+#if MIMMO_ENABLE_MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+	int val = 1;
+    /**<Calling mimmo Test routines*/
+    try{
+        val = test4() ;
+    }
+    catch(std::exception & e){
+        std::cout<<"test_utils_00004 exited with an error of type : "<<e.what()<<std::endl;
+        return 1;
+    }
+
+#if MIMMO_ENABLE_MPI
+	MPI_Finalize();
+#endif
+
+	return val;
+}